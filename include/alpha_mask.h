@@ -0,0 +1,50 @@
+#ifndef ALPHA_MASK_H
+#define ALPHA_MASK_H
+
+#include <SDL2/SDL.h>
+#include <cstdint>
+#include <vector>
+
+// Pixels at or above this alpha count as part of the sprite
+const int ALPHA_MASK_THRESHOLD = 128;
+
+// Larger sprites are sampled down so their longest side fits; a tap only
+// needs a few pixels of precision
+const int ALPHA_MASK_MAX_SIZE = 128;
+const int ALPHA_MASK_MAX_BYTES = ALPHA_MASK_MAX_SIZE / 8 * ALPHA_MASK_MAX_SIZE;
+
+// 1 bit per pixel opacity mask for hit-testing sprites. Bits are packed
+// eight to a byte with the leftmost pixel in the high bit, and each row
+// starts on a byte boundary. A 32x32 sprite costs 128 bytes.
+struct AlphaMask {
+    int width = 0;
+    int height = 0;
+    std::vector<uint8_t> bits;
+
+    bool empty() const { return bits.empty(); }
+
+    int stride() const { return (width + 7) / 8; }
+
+    bool test(int x, int y) const {
+        if (x < 0 || y < 0 || x >= width || y >= height) return false;
+        return (bits[static_cast<size_t>(y) * stride() + x / 8] >> (7 - x % 8)) & 1;
+    }
+};
+
+// Build a mask from ARGB8888 pixels (pitch in bytes), nearest-sampled
+// down to ALPHA_MASK_MAX_SIZE
+AlphaMask buildAlphaMask(const uint32_t* argb, int width, int height, int pitch);
+
+// Build a mask from an ARGB8888 surface; empty if the format differs
+AlphaMask buildAlphaMask(SDL_Surface* surface);
+
+// Same, into an existing mask so storage reserved up front (at most
+// ALPHA_MASK_MAX_BYTES) is reused. Returns false if the format differs.
+bool buildAlphaMask(SDL_Surface* surface, AlphaMask& mask);
+
+// Is (x, y) on an opaque pixel of the sprite when it is drawn stretched
+// into dst? Uses the same nearest-texel mapping as the renderer. Sprites
+// without a mask fall back to the whole rect.
+bool alphaMaskHit(const AlphaMask& mask, const SDL_Rect& dst, int x, int y);
+
+#endif // ALPHA_MASK_H
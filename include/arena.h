@@ -0,0 +1,85 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <string>
+#include <vector>
+
+// Size of the per-frame scratch arena (per thread); a full growth slice
+// with its save records takes about 24 KB
+const size_t FRAME_ARENA_SIZE = 64 * 1024;
+
+// Bump allocator over a fixed block of memory. Individual frees are no-ops;
+// everything is released at once with reset().
+class FixedArena {
+public:
+    FixedArena(void* storage, size_t capacity)
+        : base(static_cast<unsigned char*>(storage)), capacity(capacity), offset(0), highWater(0) {}
+
+    void* allocate(size_t size, size_t alignment = alignof(std::max_align_t)) {
+        uintptr_t current = reinterpret_cast<uintptr_t>(base) + offset;
+        size_t padding = (alignment - (current % alignment)) % alignment;
+        if (offset + padding + size > capacity) {
+            return nullptr;
+        }
+        void* ptr = base + offset + padding;
+        offset += padding + size;
+        if (offset > highWater) highWater = offset;
+        return ptr;
+    }
+
+    void reset() { offset = 0; }
+
+    size_t used() const { return offset; }
+    size_t peak() const { return highWater; }
+    size_t size() const { return capacity; }
+
+private:
+    unsigned char* base;
+    size_t capacity;
+    size_t offset;
+    size_t highWater;
+};
+
+// Arena reset at the start of every frame. Anything allocated from it must
+// not outlive the frame. Each thread gets its own.
+FixedArena& frameArena();
+
+// Called when an arena runs out of space; reports and throws std::bad_alloc
+void arenaExhausted(const FixedArena& arena, size_t requested);
+
+// STL allocator drawing from a FixedArena
+template <typename T>
+class ArenaAllocator {
+public:
+    using value_type = T;
+
+    ArenaAllocator() : arena(&frameArena()) {}
+    explicit ArenaAllocator(FixedArena& arena) : arena(&arena) {}
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) : arena(other.arena) {}
+
+    T* allocate(size_t count) {
+        void* ptr = arena->allocate(count * sizeof(T), alignof(T));
+        if (!ptr) arenaExhausted(*arena, count * sizeof(T));
+        return static_cast<T*>(ptr);
+    }
+
+    void deallocate(T*, size_t) {}
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U>& other) const { return arena == other.arena; }
+    template <typename U>
+    bool operator!=(const ArenaAllocator<U>& other) const { return arena != other.arena; }
+
+    FixedArena* arena;
+};
+
+// Containers living in the frame arena
+using FrameString = std::basic_string<char, std::char_traits<char>, ArenaAllocator<char>>;
+template <typename T>
+using FrameVector = std::vector<T, ArenaAllocator<T>>;
+
+#endif // ARENA_H
@@ -0,0 +1,82 @@
+#ifndef ASSETS_H
+#define ASSETS_H
+
+#include <SDL2/SDL.h>
+#include <SDL_ttf.h>
+#include <cstdint>
+#include <string>
+#include "game.h"
+
+// Where images and the font come from
+enum class AssetSource {
+    PNG,       // Files under assets/ decoded with SDL_image / SDL_ttf
+    EMBEDDED   // Arrays linked into the binary by the asset packer
+};
+
+// Load timing and size counters for one source
+struct AssetLoadStats {
+    int loads = 0;
+    int failures = 0;
+    double decodeMicros = 0;   // Time spent decoding and uploading
+    uint64_t sourceBytes = 0;  // PNG file sizes or packed bytes read
+    uint64_t pixelBytes = 0;   // Decoded ARGB8888 size
+};
+
+// Select the source; defaults to EMBEDDED when the build packed assets
+void setAssetSource(AssetSource source);
+AssetSource getAssetSource();
+
+// Parse --assets=embedded|png; returns false on an unknown value
+bool parseAssetSourceArg(const std::string& value);
+
+// Load an image by its asset path (e.g. "assets/map.png"). With the
+// embedded source, images that weren't packed fall back to the PNG file.
+// Takes a C string so binding a sprite mid-game builds no std::string.
+SDL_Texture* loadAssetTexture(SDL_Renderer* renderer, const char* path);
+
+// Load an image into an ARGB8888 surface for CPU-side processing; free it
+// with SDL_FreeSurface. Falls back to the PNG file like loadAssetTexture.
+SDL_Surface* loadAssetSurface(const char* path);
+
+// Read a text asset (e.g. the plant catalog) whole; empty if it is missing
+std::string loadAssetText(const std::string& path);
+
+// Open a font by its asset path at the given point size
+TTF_Font* openAssetFont(const std::string& path, int pointSize);
+
+// GameBoy mode: images are kept as 2bpp shade indices (see indexed_sprite.h)
+// and expanded into their textures through a shade LUT. Must be selected
+// before any image is loaded.
+void setGameboyMode(bool enabled);
+bool isGameboyMode();
+
+// Make room for count more indexed textures, so images bound after init
+// don't grow the recolor list
+void reserveIndexedTextures(size_t count);
+
+// True if loading path in GameBoy mode would dither the PNG because no
+// packed 2bpp copy exists. That allocates the shades, so such images have
+// to be loaded before the heap is locked.
+bool isQuantizedAtLoad(const char* path);
+
+// Rebuild the shade LUTs for the weather and time of day and recolor all
+// indexed textures. Cheap when nothing changed, so it can run every frame.
+// Returns true if textures were recolored.
+bool updateShadePalette(const ColorPalette& palette, WeatherType weather, DayNightType dayNight);
+
+// Indexed image counters for GameBoy mode
+struct IndexedAssetStats {
+    int textures = 0;
+    size_t indexedBytes = 0;   // 2bpp pixel data held for recoloring
+    size_t rgbaBytes = 0;      // Same images as 32-bit RGBA
+    int recolors = 0;          // LUT swaps applied
+    double recolorMicros = 0;
+};
+
+AssetLoadStats getAssetLoadStats(AssetSource source);
+IndexedAssetStats getIndexedAssetStats();
+
+// Print decode cost and size for both sources
+void logAssetStats();
+
+#endif // ASSETS_H
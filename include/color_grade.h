@@ -0,0 +1,68 @@
+#ifndef COLOR_GRADE_H
+#define COLOR_GRADE_H
+
+#include <SDL2/SDL.h>
+#include <cstdint>
+#include <vector>
+#include "game.h"
+
+// Weather and time of day are a colour grade applied to one base background
+// instead of a separate image per variant. Dusk and dawn blend day into
+// night over this many steps, each cached as its own grade.
+const int GRADE_TRANSITION_STEPS = 16;
+
+// Dusk runs 17:00-19:00 and dawn 05:00-07:00, centered on the day/night switch
+const int DUSK_START_MINUTE = 17 * 60;
+const int DAWN_START_MINUTE = 5 * 60;
+const int TRANSITION_MINUTES = 2 * 60;
+
+// Per-channel lookup tables for one grade
+struct GradeLut {
+    uint8_t r[256];
+    uint8_t g[256];
+    uint8_t b[256];
+};
+
+// Identifies a grade; step 0 is full day and GRADE_TRANSITION_STEPS full night
+struct GradeKey {
+    WeatherType weather = WeatherType::SUNNY;
+    int step = 0;
+
+    int index() const {
+        return static_cast<int>(weather) * (GRADE_TRANSITION_STEPS + 1) + step;
+    }
+    bool operator==(const GradeKey& other) const {
+        return weather == other.weather && step == other.step;
+    }
+    bool operator!=(const GradeKey& other) const { return !(*this == other); }
+};
+
+// How far into night a local time is, from 0 (day) to 1 (night)
+float nightAmount(int hour, int minute);
+
+GradeKey makeGradeKey(WeatherType weather, float nightAmount);
+
+// Cached LUT for a grade, built the first time it is asked for
+const GradeLut& gradeLut(const GradeKey& key);
+
+SDL_Color gradeColor(const GradeLut& lut, const SDL_Color& color);
+
+// Grade ARGB8888 pixels (pitches in bytes); alpha is kept
+void gradePixels(const GradeLut& lut, const uint32_t* src, int srcPitch,
+                 uint32_t* dst, int dstPitch, int width, int height);
+
+// Re-grade each background's texture from its base surface if its grade
+// differs from key. Returns the number of backgrounds updated.
+int gradeBackgrounds(std::vector<Background>& backgrounds, const GradeKey& key);
+
+// LUTs built and backgrounds re-graded so far, with the time spent
+struct GradeStats {
+    int lutsBuilt = 0;
+    int regrades = 0;
+    double regradeMicros = 0;
+};
+
+GradeStats getGradeStats();
+void logGradeStats();
+
+#endif // COLOR_GRADE_H
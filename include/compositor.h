@@ -0,0 +1,56 @@
+#ifndef COMPOSITOR_H
+#define COMPOSITOR_H
+
+#include <SDL2/SDL.h>
+#include <cstdint>
+
+// Static parts of a screen are drawn once into full-screen render targets
+// and reused until something they show changes. A frame is then a few
+// texture copies plus whatever actually moves.
+enum class LayerId {
+    PLANT_BACKGROUND,   // Sky fill and graded background (opaque)
+    PLANT_FOREGROUND,   // Coins, buttons and toolbar (transparent)
+    PLANT_CARD,         // Plant and its name (transparent); slides during a swipe
+    PREV_PLANT_CARD,    // Neighbours' cards, drawn ahead of a swipe
+    NEXT_PLANT_CARD,
+    COUNT
+};
+
+// Create the layer targets; call once after the renderer exists
+bool initCompositor(SDL_Renderer* renderer);
+void cleanupCompositor();
+
+// Fold a value into a layer key. Keys describe everything a layer shows,
+// so any change to them forces a redraw.
+inline uint64_t layerKey(uint64_t key, uint64_t value) {
+    // FNV-1a style mix
+    key ^= value + 0x9E3779B97F4A7C15ull + (key << 6) + (key >> 2);
+    return key * 0x100000001B3ull;
+}
+
+// Returns true when the layer is stale (or has no target) and must be redrawn.
+// In that case the renderer now draws into the cleared layer until endLayer.
+bool beginLayer(SDL_Renderer* renderer, LayerId layer, uint64_t key);
+void endLayer(SDL_Renderer* renderer);
+
+// Copy a layer to the current target, shifted offsetX pixels. Layers
+// without a target (creation failed) are drawn directly by the caller each
+// frame instead.
+bool drawLayer(SDL_Renderer* renderer, LayerId layer, int offsetX = 0);
+
+// False when the layer has no target and beginLayer draws to the screen
+bool layerHasTarget(LayerId layer);
+
+// Force every layer to be redrawn, e.g. after SDL_RENDER_TARGETS_RESET
+void invalidateLayers();
+
+// Layer redraws vs. frames served from the cache
+struct CompositorStats {
+    int redraws = 0;
+    int hits = 0;
+};
+
+CompositorStats getCompositorStats();
+void logCompositorStats();
+
+#endif // COMPOSITOR_H
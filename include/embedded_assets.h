@@ -0,0 +1,68 @@
+#ifndef EMBEDDED_ASSETS_H
+#define EMBEDDED_ASSETS_H
+
+#include <cstddef>
+#include <cstdint>
+#include "indexed_sprite.h"
+
+// Run-length control byte: below the flag is a repeat, at or above it a literal span
+const int RLE_LITERAL_FLAG = 128;
+const int RLE_MAX_RUN = 128;
+
+// Image packed into the binary by tools/asset_packer.
+//
+// Pixels are palette indices, run-length encoded one row at a time. Each
+// run starts with a control byte c:
+//   c < 128   the next index repeats c + 1 times
+//   c >= 128  c - 127 literal indices follow
+// rowOffsets holds height + 1 entries, so row y occupies
+// data[rowOffsets[y]] up to data[rowOffsets[y + 1]] and any row can be
+// decoded on its own.
+struct EmbeddedImage {
+    const char* name;          // Asset path the image was packed from, e.g. "assets/map.png"
+    int width;
+    int height;
+    const uint32_t* palette;   // ARGB8888, fully transparent pixels use 0x00000000
+    int paletteSize;
+    const uint32_t* rowOffsets;
+    const uint8_t* data;
+};
+
+// Arbitrary file (e.g. the font) packed into the binary as raw bytes
+struct EmbeddedFile {
+    const char* name;
+    const uint8_t* data;
+    size_t size;
+};
+
+// 2bpp shade image for GameBoy mode, stored unpacked so it can be
+// expanded through a LUT straight from flash
+struct EmbeddedIndexedImage {
+    const char* name;
+    IndexedImage image;
+};
+
+// Tables produced by the asset packer. Empty unless the build was
+// configured with PIXELPETS_EMBEDDED_ASSETS.
+extern const EmbeddedImage* const EMBEDDED_IMAGES;
+extern const int EMBEDDED_IMAGE_COUNT;
+extern const EmbeddedFile* const EMBEDDED_FILES;
+extern const int EMBEDDED_FILE_COUNT;
+extern const EmbeddedIndexedImage* const EMBEDDED_INDEXED_IMAGES;
+extern const int EMBEDDED_INDEXED_IMAGE_COUNT;
+
+// Look up a packed asset by its path; nullptr if it isn't embedded
+const EmbeddedImage* findEmbeddedImage(const char* name);
+const EmbeddedFile* findEmbeddedFile(const char* name);
+const EmbeddedIndexedImage* findEmbeddedIndexedImage(const char* name);
+
+// Compressed size of an image (palette, row table and runs)
+size_t embeddedImageBytes(const EmbeddedImage& image);
+
+// Expand rows [firstRow, firstRow + rowCount) as ARGB8888 into dst, where
+// pitch is the distance between rows in bytes. Returns false if the run
+// data is corrupt.
+bool decodeEmbeddedRows(const EmbeddedImage& image, int firstRow, int rowCount,
+                        uint32_t* dst, int pitch);
+
+#endif // EMBEDDED_ASSETS_H
@@ -9,17 +9,24 @@
 #include <set>
 #include <algorithm>
 #include <random>
+#include "memory_tracker.h"
+#include "alpha_mask.h"
 
 // Constants for the LILYGO T3 AMOLED screen
 // Updated to match the physical dimensions shown in the screenshot
 const int SCREEN_WIDTH = 135;  // Width in pixels
 const int SCREEN_HEIGHT = 240; // Height in pixels
-const int PIXEL_SIZE = 2;      // Reduced pixel size for better detail on smaller screen
+const int PIXEL_SIZE = 2;      // Default window pixels per screen pixel on the desktop
 
 // Weather and time constants
 const int WEATHER_CHANGE_INTERVAL = 30000;  // 30 seconds in milliseconds
 const int TOOLBAR_HEIGHT = 40;  // Height of the toolbar at bottom
 
+// Plants grow one step per tick, two in their preferred weather
+const int GROWTH_TICK_INTERVAL = 60000;  // 1 minute in milliseconds
+const int PLANT_MAX_GROWTH = 100;
+const int GROWTH_TICK_SLICE = 2048;        // Plants grown per frame once a tick is due
+
 // Menu constants
 const int MENU_BUTTON_SIZE = 24;
 const int BG_BUTTON_SIZE = 24;
@@ -29,10 +36,8 @@ const int MENU_GRID_COLS = 3;  // Updated to show more plants
 const int MENU_GRID_ROWS = 4;  // Updated to show more plants
 const int MENU_ITEM_PADDING = 5; // Reduced padding to fit more plants
 
-// Celebration animation constants
+// Celebration animation constants (particle tuning lives in particles.h)
 const int CELEBRATION_DURATION = 2000; // Duration of celebration animation in milliseconds
-const int MAX_PARTICLES = 50;          // Maximum number of celebration particles
-const int PARTICLE_SIZE = 3;           // Size of celebration particles
 
 // Game states
 enum class GameState {
@@ -50,6 +55,26 @@ enum class GameState {
     STORE                 // Plant store to buy new plants
 };
 
+const int GAME_STATE_COUNT = static_cast<int>(GameState::STORE) + 1;
+
+// What a tap on an interactive region asks for
+enum class UiAction {
+    NONE,                 // Tap missed every region
+    PREV_PLANT,
+    NEXT_PLANT,
+    OPEN_MAP,
+    OPEN_STORE,
+    BACK,
+    INVENTORY_CELL,       // Index is the cell on the page
+    PREV_PAGE,
+    NEXT_PAGE,
+    SORT_ORDER,           // Cycle the inventory sort order
+    WEATHER_FILTER,       // Cycle the inventory weather filter
+    LOCATION,             // Index is the map location
+    STORE_YES,
+    STORE_NO
+};
+
 // Background types
 enum class WeatherType {
     SUNNY,
@@ -71,58 +96,16 @@ const std::string WeatherTypeNames[] = {
     "Windy"
 };
 
-// Plant data structure
+// Plant data structure. Sprites belong to the render thread and hit-test
+// masks to the catalog, both looked up by catalogId; a plant only keeps
+// what the simulation needs.
 struct Plant {
+    int catalogId = 0;    // Stable id used by the save file
     std::string name;
     std::string filename;
-    SDL_Texture* texture;
-    int width;
-    int height;
-    WeatherType preferredWeather;
-    bool isOwned;
-    
-    // Default constructor
-    Plant() : texture(nullptr), width(0), height(0), preferredWeather(WeatherType::SUNNY), isOwned(false) {}
-    
-    ~Plant() {
-        if (texture) {
-            SDL_DestroyTexture(texture);
-            texture = nullptr;
-        }
-    }
-    
-    // Prevent copying to avoid double-free
-    Plant(const Plant&) = delete;
-    Plant& operator=(const Plant&) = delete;
-    
-    // Allow moving
-    Plant(Plant&& other) noexcept
-        : name(std::move(other.name))
-        , filename(std::move(other.filename))
-        , texture(other.texture)
-        , width(other.width)
-        , height(other.height)
-        , preferredWeather(other.preferredWeather)
-        , isOwned(other.isOwned) {
-        other.texture = nullptr;
-    }
-    
-    Plant& operator=(Plant&& other) noexcept {
-        if (this != &other) {
-            if (texture) {
-                SDL_DestroyTexture(texture);
-            }
-            name = std::move(other.name);
-            filename = std::move(other.filename);
-            texture = other.texture;
-            width = other.width;
-            height = other.height;
-            preferredWeather = other.preferredWeather;
-            isOwned = other.isOwned;
-            other.texture = nullptr;
-        }
-        return *this;
-    }
+    WeatherType preferredWeather = WeatherType::SUNNY;
+    bool isOwned = false;
+    int growth = 0;       // 0 to PLANT_MAX_GROWTH
 };
 
 // Button structure
@@ -159,18 +142,24 @@ struct ColorPalette {
 struct Background {
     std::string name;
     std::string filename;
-    SDL_Texture* texture;
+    SDL_Texture* texture;   // Graded copy of base (streaming)
+    SDL_Surface* base;      // Ungraded ARGB8888 pixels
     int width;
     int height;
+    int gradeIndex;         // GradeKey::index() of the texture contents, -1 if none
     
     // Default constructor
-    Background() : texture(nullptr), width(0), height(0) {}
+    Background() : texture(nullptr), base(nullptr), width(0), height(0), gradeIndex(-1) {}
     
     ~Background() {
         if (texture) {
-            SDL_DestroyTexture(texture);
+            destroyTrackedTexture(texture);
             texture = nullptr;
         }
+        if (base) {
+            SDL_FreeSurface(base);
+            base = nullptr;
+        }
     }
     
     // Prevent copying to avoid double-free
@@ -182,35 +171,36 @@ struct Background {
         : name(std::move(other.name))
         , filename(std::move(other.filename))
         , texture(other.texture)
+        , base(other.base)
         , width(other.width)
-        , height(other.height) {
+        , height(other.height)
+        , gradeIndex(other.gradeIndex) {
         other.texture = nullptr;
+        other.base = nullptr;
     }
     
     Background& operator=(Background&& other) noexcept {
         if (this != &other) {
             if (texture) {
-                SDL_DestroyTexture(texture);
+                destroyTrackedTexture(texture);
+            }
+            if (base) {
+                SDL_FreeSurface(base);
             }
             name = std::move(other.name);
             filename = std::move(other.filename);
             texture = other.texture;
+            base = other.base;
             width = other.width;
             height = other.height;
+            gradeIndex = other.gradeIndex;
             other.texture = nullptr;
+            other.base = nullptr;
         }
         return *this;
     }
 };
 
-// Structure to represent a raindrop
-struct Raindrop {
-    float x;
-    float y;
-    float speed;
-    int length;
-};
-
 // Player data structure
 struct Player {
     int selectedPlantIndex = -1;  // Index of chosen starter plant
@@ -218,18 +208,6 @@ struct Player {
     int coins = 0;  // Player's currency
 };
 
-// Celebration particle structure
-struct Particle {
-    float x;
-    float y;
-    float velocityX;
-    float velocityY;
-    SDL_Color color;
-    int size;
-    int lifespan;
-    int age;
-};
-
 // Add new button definitions for plant navigation
 struct PlantNavigationButtons {
     Button prevPlantButton;
@@ -246,6 +224,12 @@ struct Location {
     GameState viewState;  // Which game state to switch to when clicked
 };
 
+// Longest shopkeeper line, including the plant name
+const int SHOPKEEPER_TEXT_CAPACITY = 256;
+
+// How long the shopkeeper's answer to a deal stays up
+const Uint32 STORE_REPLY_MS = 2000;
+
 // Store state
 struct StoreState {
     bool isAskingToSell = false;
@@ -253,9 +237,8 @@ struct StoreState {
     int selectedPlantIndex = -1;
     int offerAmount = 0;
     std::string shopkeeperText = "Welcome to my shop! Would you like to sell any plants?";
-    Button yesButton = {{SCREEN_WIDTH/2 - 30, SCREEN_HEIGHT - TOOLBAR_HEIGHT - 40, 40, 20}, false};
-    Button noButton = {{SCREEN_WIDTH/2 + 10, SCREEN_HEIGHT - TOOLBAR_HEIGHT - 40, 40, 20}, false};
-    Button backButton = {{10, 10, 40, 20}, false};
+    Uint32 replyUntil = 0;         // SDL ticks when the answer is done, 0 if none is showing
+    bool leaveAfterReply = false;  // Back to the map once it is done (after a sale)
 };
 
 // Game state data structure
@@ -266,17 +249,17 @@ struct GameStateData {
     StoreState storeState;
 };
 
-// Function to draw a pixel at (x, y) with the given color
+// Function to draw a pixel at (x, y) with the given color. Drawing happens
+// at screen resolution; the display upscales the finished frame.
 inline void drawPixel(SDL_Renderer* renderer, int x, int y, SDL_Color color) {
     SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a);
-    SDL_Rect rect = {x * PIXEL_SIZE, y * PIXEL_SIZE, PIXEL_SIZE, PIXEL_SIZE};
-    SDL_RenderFillRect(renderer, &rect);
+    SDL_RenderDrawPoint(renderer, x, y);
 }
 
 // Function to load a texture from a file
-inline SDL_Texture* loadTexture(SDL_Renderer* renderer, const std::string& path) {
+inline SDL_Texture* loadTexture(SDL_Renderer* renderer, const char* path) {
     // Load image at specified path
-    SDL_Surface* loadedSurface = IMG_Load(path.c_str());
+    SDL_Surface* loadedSurface = IMG_Load(path);
     if (loadedSurface == nullptr) {
         std::cerr << "Unable to load image " << path << "! SDL_image Error: " << IMG_GetError() << std::endl;
         return nullptr;
@@ -563,52 +546,6 @@ inline std::vector<int> getRandomIndices(int min, int max, int count) {
     return indices;
 }
 
-// Function to draw a celebration particle
-inline void drawParticle(SDL_Renderer* renderer, const Particle& particle) {
-    SDL_SetRenderDrawColor(renderer, particle.color.r, particle.color.g, particle.color.b, 
-                           particle.color.a * (1.0f - static_cast<float>(particle.age) / particle.lifespan));
-    
-    SDL_Rect particleRect = {
-        static_cast<int>(particle.x), 
-        static_cast<int>(particle.y), 
-        particle.size, 
-        particle.size
-    };
-    
-    SDL_RenderFillRect(renderer, &particleRect);
-}
-
-// Function to initialize a random celebration particle
-inline Particle createRandomParticle(int screenWidth, int screenHeight) {
-    Particle particle;
-    // Start from the center of the screen
-    particle.x = screenWidth / 2.0f;
-    particle.y = screenHeight / 2.0f;
-    
-    // Random velocity (radial burst pattern)
-    float angle = (std::rand() % 360) * 3.14159f / 180.0f;
-    float speed = 0.5f + (std::rand() % 20) / 10.0f;
-    particle.velocityX = cos(angle) * speed;
-    particle.velocityY = sin(angle) * speed;
-    
-    // Random color (festive colors)
-    int colorChoice = std::rand() % 5;
-    switch (colorChoice) {
-        case 0: particle.color = {255, 0, 0, 255};   break; // Red
-        case 1: particle.color = {255, 255, 0, 255}; break; // Yellow
-        case 2: particle.color = {0, 255, 0, 255};   break; // Green
-        case 3: particle.color = {0, 0, 255, 255};   break; // Blue
-        case 4: particle.color = {255, 0, 255, 255}; break; // Purple
-    }
-    
-    // Random size and lifespan
-    particle.size = 2 + std::rand() % 3;
-    particle.lifespan = 30 + std::rand() % 60; // frames
-    particle.age = 0;
-    
-    return particle;
-}
-
 // Function to draw a water droplet icon
 inline void drawWaterIcon(SDL_Renderer* renderer, int x, int y, int size, const ColorPalette& palette) {
     // Draw water droplet shape
@@ -705,7 +642,18 @@ inline void drawProgressBar(SDL_Renderer* renderer, int x, int y, int width, int
 
 // Add store-related functions
 void generateOffer(GameStateData& state);
-void handleStoreInteraction(GameStateData& state, int x, int y);
+void handleStoreInteraction(GameStateData& state, UiAction action);
 void resetStoreState(GameStateData& state);
 
+// Finish the shopkeeper's answer once it has been up for STORE_REPLY_MS;
+// called every simulation step
+void updateStore(GameStateData& state, Uint32 currentTime);
+
+// Apply a sale or purchase to the player and plant list (no UI, no saving)
+void sellPlant(GameStateData& state, int plantIndex, int price);
+void buyPlant(GameStateData& state, int plantIndex, int price);
+
+// Next (step 1) or previous (step -1) plant in inventory order, wrapping
+int neighbourPlant(const GameStateData& state, int plantIndex, int step);
+
 #endif // GAME_H 
\ No newline at end of file
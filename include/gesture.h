@@ -0,0 +1,97 @@
+#ifndef GESTURE_H
+#define GESTURE_H
+
+#include <SDL2/SDL.h>
+#include <cstdint>
+#include "input_queue.h"
+
+// Turns the raw press, motion and release events from the input queue into
+// touch gestures. A press that stays within GESTURE_TOUCH_SLOP and lifts
+// quickly is a tap; held for GESTURE_LONG_PRESS_MS it is a long press;
+// moved further it becomes a drag, which ends as a fling when the pointer
+// is still moving faster than GESTURE_FLING_VELOCITY as it lifts. Velocity
+// comes from the last few samples in a fixed ring, so nothing allocates.
+const int GESTURE_TOUCH_SLOP = 6;                // Pixels a press may wander and stay a tap
+const Uint32 GESTURE_LONG_PRESS_MS = 500;
+const float GESTURE_FLING_VELOCITY = 0.4f;       // Pixels per ms
+const Uint32 GESTURE_VELOCITY_WINDOW_MS = 80;    // Samples older than this are ignored
+const int GESTURE_HISTORY = 8;                   // Motion samples kept for the velocity
+
+enum class GestureType : uint8_t {
+    NONE,
+    TAP,
+    LONG_PRESS,
+    DRAG_START,     // Pointer left the touch slop
+    DRAG,           // Each move after that
+    DRAG_END,       // Lifted slowly
+    FLING           // Lifted while moving
+};
+
+struct Gesture {
+    GestureType type = GestureType::NONE;
+    int16_t x = 0;              // Pointer now, screen coordinates
+    int16_t y = 0;
+    int16_t startX = 0;         // Where the press landed
+    int16_t startY = 0;
+    float velocityX = 0;        // Pixels per ms, for DRAG_END and FLING
+    float velocityY = 0;
+};
+
+class GestureRecognizer {
+public:
+    // Feed one input event; returns the gesture it starts, moves or ends
+    Gesture onEvent(const InputEvent& event);
+
+    // Gestures that complete by waiting (long press); call once per step
+    Gesture poll(Uint32 now);
+
+    // Forget the current press, e.g. when the screen under it changes
+    void cancel();
+
+    bool pressed() const { return phase != Phase::IDLE; }
+    bool dragging() const { return phase == Phase::DRAGGING; }
+
+private:
+    enum class Phase : uint8_t {
+        IDLE,
+        PRESSED,        // Down, within the slop
+        DRAGGING,
+        HELD            // Long press reported; the rest of the press is ignored
+    };
+
+    struct Sample {
+        int16_t x;
+        int16_t y;
+        Uint32 time;
+    };
+
+    Gesture make(GestureType type) const;
+    void addSample(int16_t x, int16_t y, Uint32 time);
+    void velocity(float& vx, float& vy) const;
+
+    Phase phase = Phase::IDLE;
+    int16_t startX = 0;
+    int16_t startY = 0;
+    int16_t lastX = 0;
+    int16_t lastY = 0;
+    Uint32 pressTime = 0;
+    Sample history[GESTURE_HISTORY] = {};
+    int historyCount = 0;
+    int historyNext = 0;
+};
+
+// Recognizer cost and what it recognized
+struct GestureStats {
+    long long events = 0;
+    double eventMicros = 0;
+    double maxEventMicros = 0;
+    int taps = 0;
+    int longPresses = 0;
+    int drags = 0;
+    int flings = 0;
+};
+
+GestureStats getGestureStats();
+void logGestureStats();
+
+#endif // GESTURE_H
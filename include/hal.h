@@ -0,0 +1,217 @@
+#ifndef HAL_H
+#define HAL_H
+
+#include <SDL2/SDL.h>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Display backend the game renders through. Every backend hands out an
+// SDL_Renderer whose drawing lands on a SCREEN_WIDTH x SCREEN_HEIGHT canvas.
+class Display {
+public:
+    virtual ~Display() = default;
+
+    virtual bool init(const std::string& title) = 0;
+    virtual void shutdown() = 0;
+
+    // Renderer used for all game drawing
+    virtual SDL_Renderer* getRenderer() const = 0;
+
+    // Render target holding the canvas, or nullptr if the backend draws
+    // straight to its output. It keeps the last frame after present().
+    virtual SDL_Texture* getCanvas() const { return nullptr; }
+
+    // Called before any drawing of a frame
+    virtual void beginFrame() {}
+
+    // Send the finished frame to the screen
+    virtual void present() = 0;
+
+    // Map window coordinates (mouse/touch) onto canvas pixels
+    virtual void windowToCanvas(int& x, int& y) const {}
+
+    // Print backend specific statistics
+    virtual void logStats() const {}
+};
+
+// Where a canvas lands in the window: the largest whole-number multiple
+// that fits the renderer's output, centered. Outputs smaller than the
+// canvas fall back to the largest aspect-correct fit.
+SDL_Rect canvasViewport(SDL_Renderer* renderer, int canvasWidth, int canvasHeight);
+
+// Map a window point (in window units, which differ from output pixels on
+// high-DPI screens) onto the canvas shown in canvasViewport
+void windowPointToCanvas(SDL_Window* window, SDL_Renderer* renderer, int canvasWidth, int canvasHeight,
+                         int& x, int& y);
+
+// Input backend delivering touch/mouse and system events
+class Input {
+public:
+    virtual ~Input() = default;
+    virtual bool pollEvent(SDL_Event& event) = 0;
+};
+
+// Desktop window rendered with SDL. The game draws into a fixed
+// SCREEN_WIDTH x SCREEN_HEIGHT canvas, so draw cost doesn't depend on the
+// window size; present() shows it with a single nearest-neighbour upscale
+// into a resizable window.
+class SdlDisplay : public Display {
+public:
+    explicit SdlDisplay(int windowScale) : windowScale(windowScale) {}
+
+    bool init(const std::string& title) override;
+    void shutdown() override;
+    SDL_Renderer* getRenderer() const override { return renderer; }
+    SDL_Texture* getCanvas() const override { return canvas; }
+    void beginFrame() override;
+    void present() override;
+    void windowToCanvas(int& x, int& y) const override;
+
+private:
+    int windowScale;                  // Initial window size in canvas pixels
+    SDL_Window* window = nullptr;
+    SDL_Renderer* renderer = nullptr;
+    SDL_Texture* canvas = nullptr;    // Render target the game draws into
+};
+
+// SDL event queue, with pointer coordinates mapped onto the display's canvas
+class SdlInput : public Input {
+public:
+    explicit SdlInput(const Display& display) : display(display) {}
+    bool pollEvent(SDL_Event& event) override;
+
+private:
+    const Display& display;
+};
+
+// How the simulated panel is updated each frame
+enum class SpiFlushMode {
+    FULL_FRAME,   // Push the whole panel every frame
+    DIRTY_RECT    // Push only the bounding box of changed pixels
+};
+
+// Simulated SPI panel parameters (defaults match the T3 AMOLED's RM67162)
+struct SpiPanelConfig {
+    int width = 0;
+    int height = 0;
+    uint32_t busClockHz = 40000000;  // SPI clock
+    int columnAlignment = 2;         // Controller requires even column windows
+    SpiFlushMode flushMode = SpiFlushMode::FULL_FRAME;
+    bool throttle = true;            // Sleep for the simulated transfer time
+    int windowScale = 2;             // Initial size of the preview window
+    int bufferCount = 2;             // 1 = blocking flush, 2-3 = flush thread overlaps rendering
+};
+
+// Bus traffic counters
+struct SpiBusStats {
+    uint64_t frames = 0;
+    uint64_t windows = 0;        // CASET/RASET/RAMWR sequences issued
+    uint64_t commandBytes = 0;   // Command and parameter bytes
+    uint64_t pixelBytes = 0;     // RAMWR payload
+    double transferMicros = 0;   // Simulated time on the bus
+
+    // Present latency: from present() to the frame being fully on the panel
+    double latencyMicrosTotal = 0;
+    double latencyMicrosMax = 0;
+    // Time present() spent waiting for a free buffer
+    double stallMicrosTotal = 0;
+};
+
+// One frame handed from the render thread to the flush thread
+struct PanelBuffer {
+    std::vector<uint16_t> pixels;   // Whole frame in RGB565
+    int x0 = 0, y0 = 0, x1 = -1, y1 = -1;  // Window to push (x1 < 0 = nothing changed)
+    Uint64 submitTime = 0;          // Performance counter at present()
+};
+
+// Fixed-capacity FIFO of buffer indices, so queueing a frame never allocates
+struct BufferQueue {
+    static const int CAPACITY = 4;
+    int items[CAPACITY] = {};
+    int head = 0;
+    int count = 0;
+
+    bool empty() const { return count == 0; }
+    void clear() { head = 0; count = 0; }
+    void push(int index) { items[(head + count++) % CAPACITY] = index; }
+    int pop() {
+        int index = items[head];
+        head = (head + 1) % CAPACITY;
+        count--;
+        return index;
+    }
+};
+
+// Panel on an SPI bus, simulated on the desktop. The game draws into an
+// off-screen canvas; present() reads it back as RGB565, pushes windows of
+// pixels into the panel's GRAM as CASET/RASET/RAMWR sequences at the
+// configured bus clock, and shows the GRAM in a preview window.
+//
+// With more than one buffer, present() only converts the frame into a free
+// buffer and queues it. A flush thread, standing in for the SPI DMA engine,
+// transfers it while the game renders the next frame. present() blocks only
+// when every buffer is still in flight.
+class SimulatedSpiDisplay : public Display {
+public:
+    explicit SimulatedSpiDisplay(const SpiPanelConfig& config);
+
+    bool init(const std::string& title) override;
+    void shutdown() override;
+    SDL_Renderer* getRenderer() const override { return renderer; }
+    SDL_Texture* getCanvas() const override { return canvas; }
+    void beginFrame() override;
+    void present() override;
+    void windowToCanvas(int& x, int& y) const override;
+    void logStats() const override;
+
+    // Write a window of RGB565 pixels into GRAM (inclusive coordinates).
+    // Returns the simulated transfer time in microseconds.
+    double pushWindow(int x0, int y0, int x1, int y1, const uint16_t* pixels, int stride);
+
+    SpiBusStats getStats() const;
+
+private:
+    double transferMicros(uint64_t bytes) const;
+    void computeFlushWindow(PanelBuffer& buffer, const std::vector<uint16_t>& previous);
+    void transferBuffer(PanelBuffer& buffer);
+    void flushThreadMain();
+    void showGram();
+
+    SpiPanelConfig config;
+    SpiBusStats stats;
+
+    SDL_Window* window = nullptr;
+    SDL_Renderer* renderer = nullptr;
+    SDL_Texture* canvas = nullptr;    // Render target the game draws into
+    SDL_Texture* preview = nullptr;   // Streaming texture showing GRAM
+
+    std::vector<uint32_t> readback;   // Canvas pixels as ARGB8888
+    std::vector<PanelBuffer> buffers; // Frames owned by the renderer or in flight
+    int lastSubmitted = -1;           // Buffer holding the previous frame
+    std::vector<uint16_t> gram;       // Panel graphics RAM
+    uint64_t gramVersion = 0;         // Bumped whenever GRAM changes
+    uint64_t shownGramVersion = 0;    // GRAM version in the preview texture
+
+    // Buffer hand-off between present() and the flush thread. flushMutex
+    // also guards gram and stats.
+    mutable std::mutex flushMutex;
+    std::condition_variable flushCv;
+    BufferQueue freeBuffers;          // Fence: buffers the renderer may fill
+    BufferQueue queuedBuffers;        // Submitted, waiting for the bus
+    bool stopFlushThread = false;
+    std::thread flushThread;
+
+    Uint32 lastStatsLog = 0;
+};
+
+// Pick a display backend from the command line (--display=sdl|spi,
+// --window-scale=<N> and --spi-clock=<MHz>, --spi-flush=full|dirty,
+// --spi-buffers=1|2|3, --spi-no-throttle)
+std::unique_ptr<Display> createDisplay(int argc, char* args[]);
+
+#endif // HAL_H
@@ -0,0 +1,45 @@
+#ifndef INDEXED_SPRITE_H
+#define INDEXED_SPRITE_H
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+// GameBoy style images: 2 bits per pixel indexing a 4 entry shade LUT
+const int SHADE_COUNT = 4;
+
+// ARGB8888 color for each index
+using ShadeLut = std::array<uint32_t, SHADE_COUNT>;
+
+// 2bpp image. Pixels are packed four to a byte with the leftmost pixel in
+// the high bits, and each row starts on a byte boundary. Like GameBoy
+// sprites, images with transparency use index 0 as transparent and 1-3
+// for shades; opaque images use all four indices, darkest first.
+struct IndexedImage {
+    int width;
+    int height;
+    bool transparent;
+    const uint8_t* pixels;
+};
+
+inline int indexedStride(int width) {
+    return (width + 3) / 4;
+}
+
+inline size_t indexedBytes(int width, int height) {
+    return static_cast<size_t>(indexedStride(width)) * height;
+}
+
+// True if any pixel is less than half opaque
+bool hasTransparency(const uint32_t* argb, int width, int height, int pitch);
+
+// Quantize ARGB8888 pixels (pitch in bytes) to shades by luminance using
+// 4x4 Bayer ordered dithering. out is resized to indexedBytes(width, height).
+void quantizeToShades(const uint32_t* argb, int width, int height, int pitch,
+                      bool transparent, std::vector<uint8_t>& out);
+
+// Expand rows [firstRow, firstRow + rowCount) through the LUT into ARGB8888
+void expandIndexedRows(const IndexedImage& image, const ShadeLut& lut, int firstRow, int rowCount,
+                       uint32_t* dst, int pitch);
+
+#endif // INDEXED_SPRITE_H
@@ -0,0 +1,138 @@
+#ifndef INPUT_QUEUE_H
+#define INPUT_QUEUE_H
+
+#include <SDL2/SDL.h>
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+class Display;
+
+// Pointer input on its way from SDL to the simulation thread. An SDL event
+// watch sees each event as the main thread's event pump queues it. The
+// render loop pumps when it polls and again (pumpInputEvents) between
+// drawing a frame and presenting it, so input doesn't wait out a whole
+// frame. The watch converts the event to screen coordinates, stamps it and
+// pushes it onto a single-producer, single-consumer ring, then wakes the
+// simulation so the tap is handled right away rather than after the rest
+// of a 16 ms step. Neither side takes a lock and nothing allocates.
+//
+// Presses and releases must never be lost: a missing release turns a tap
+// into a long press. When the ring is nearly full, moves are held back on
+// the producer side instead, and a newer move replaces a held one. Once
+// anything is held back, later events queue up behind it in order, and
+// they all go into the ring as soon as the simulation makes room.
+const int INPUT_QUEUE_CAPACITY = 64;   // Power of two
+const int INPUT_QUEUE_MOTION_RESERVE = 8;   // Slots kept free for presses and releases
+const int INPUT_BACKLOG_CAPACITY = 32;      // Held back on the producer side
+
+enum class InputEventType : uint8_t {
+    PRESS,
+    RELEASE,
+    MOTION      // Only while pressed
+};
+
+struct InputEvent {
+    InputEventType type = InputEventType::PRESS;
+    int16_t x = 0;          // Screen coordinates
+    int16_t y = 0;
+    Uint32 timestamp = 0;   // SDL event time, ms since SDL_Init
+    Uint64 queuedAt = 0;    // Performance counter when pushed
+    uint32_t id = 0;        // Assigned when pushed, from 1 up
+};
+
+// Fixed-size ring for one producer thread and one consumer thread
+class InputRing {
+public:
+    bool push(const InputEvent& event) {
+        uint32_t head = writeIndex.load(std::memory_order_relaxed);
+        if (head - readIndex.load(std::memory_order_acquire) >= static_cast<uint32_t>(INPUT_QUEUE_CAPACITY)) {
+            return false;
+        }
+        events[head % INPUT_QUEUE_CAPACITY] = event;
+        writeIndex.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(InputEvent& event) {
+        uint32_t tail = readIndex.load(std::memory_order_relaxed);
+        if (tail == writeIndex.load(std::memory_order_acquire)) {
+            return false;
+        }
+        event = events[tail % INPUT_QUEUE_CAPACITY];
+        readIndex.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    int size() const {
+        return static_cast<int>(writeIndex.load(std::memory_order_acquire) -
+                                readIndex.load(std::memory_order_acquire));
+    }
+
+private:
+    static_assert((INPUT_QUEUE_CAPACITY & (INPUT_QUEUE_CAPACITY - 1)) == 0, "capacity must be a power of two");
+
+    InputEvent events[INPUT_QUEUE_CAPACITY];
+    std::atomic<uint32_t> writeIndex{0};
+    std::atomic<uint32_t> readIndex{0};
+};
+
+// Install the event watch; call on the main thread once the display exists
+bool initInputQueue(const Display& display);
+void shutdownInputQueue();
+
+// Producer side, called by the event watch and the replay on the thread
+// that pumps SDL events. Returns false only if the event was dropped,
+// which takes INPUT_BACKLOG_CAPACITY presses and releases held back.
+bool pushInputEvent(const InputEvent& event);
+
+// Move held-back events into the ring as it empties; call once per loop on
+// the thread that pumps SDL events
+void flushInputEvents();
+
+// Consumer side (simulation thread): next event, false when empty
+bool popInputEvent(InputEvent& event);
+
+// Record that a popped event has reached its handler
+void inputEventHandled(const InputEvent& event);
+
+// Sleep until an event is pushed or timeoutMs passes
+void waitForInput(Uint32 timeoutMs);
+
+// Let SDL queue pending OS input now, which runs the event watch; call on
+// the thread that pumps SDL events
+void pumpInputEvents();
+
+// Scripted input (--replay=path). One event per line,
+// "<ms> <tap|press|release|move> <x> <y>" in screen coordinates, with ms
+// counted from the first pumpInputReplay call; a tap is a press and a
+// release. Lines starting with # are ignored.
+const Uint32 INPUT_REPLAY_SETTLE_MS = 1000;   // Run time after the last event
+
+bool loadInputReplay(const std::string& path);
+
+// Push the replay events that are due; call once per loop on the thread
+// that pumps SDL events
+void pumpInputReplay();
+
+// True once every event is pushed and INPUT_REPLAY_SETTLE_MS have passed
+bool inputReplayFinished();
+
+// Queue counters and latency
+struct InputQueueStats {
+    long long events = 0;
+    long long dropped = 0;          // Ring and backlog were full
+    long long coalesced = 0;        // Moves replaced by a newer one while held back
+    int maxBacklog = 0;
+    int maxDepth = 0;
+    long long handled = 0;
+    double queueMicros = 0;         // Push to handler, summed
+    double maxQueueMicros = 0;
+    double eventAgeMs = 0;          // Pumped (SDL timestamp) to handler, summed
+    Uint32 maxEventAgeMs = 0;
+};
+
+InputQueueStats getInputQueueStats();
+void logInputQueueStats();
+
+#endif // INPUT_QUEUE_H
@@ -0,0 +1,74 @@
+#ifndef INPUT_ROUTER_H
+#define INPUT_ROUTER_H
+
+#include <SDL2/SDL.h>
+#include <cstdint>
+#include "game.h"
+
+class ParticleSystem;
+
+// Screens register their interactive regions once at startup. Each screen
+// keeps a coarse grid over the display where every cell holds a bitmask of
+// the regions overlapping it, so a tap checks only the few regions in its
+// cell. Taps are then passed to the current screen's handler from a table
+// indexed by GameState.
+const int HIT_GRID_CELL = 16;   // Cell size in screen pixels
+const int HIT_GRID_COLS = (SCREEN_WIDTH + HIT_GRID_CELL - 1) / HIT_GRID_CELL;
+const int HIT_GRID_ROWS = (SCREEN_HEIGHT + HIT_GRID_CELL - 1) / HIT_GRID_CELL;
+const int MAX_HIT_REGIONS = 32; // Per screen; one bit each in a cell mask
+
+struct HitTarget {
+    UiAction action = UiAction::NONE;
+    int index = 0;
+    int x = 0;   // Tap position, for handlers that refine the hit
+    int y = 0;
+};
+
+class HitGrid {
+public:
+    void clear();
+
+    // Regions added later win where they overlap earlier ones.
+    // Returns false when the grid is full.
+    bool add(const SDL_Rect& rect, const HitTarget& target);
+
+    // Region under (x, y), or a NONE target
+    HitTarget hitTest(int x, int y) const;
+
+    int size() const { return count; }
+
+private:
+    SDL_Rect rects[MAX_HIT_REGIONS];
+    HitTarget targets[MAX_HIT_REGIONS];
+    int count = 0;
+    uint32_t cells[HIT_GRID_ROWS * HIT_GRID_COLS] = {};
+};
+
+// Everything a tap handler may change
+struct InputContext {
+    GameStateData& state;
+    int& currentPage;
+    ParticleSystem& effects;
+};
+
+// Called for every tap on its screen, including misses
+using TapHandler = void (*)(InputContext& context, const HitTarget& target);
+
+void setTapHandler(GameState state, TapHandler handler);
+bool addHitRegion(GameState state, const SDL_Rect& rect, UiAction action, int index = 0);
+
+// Hit-test (x, y) on the current screen and run its handler; returns
+// the region hit (NONE for a miss or a screen without a handler)
+HitTarget dispatchTap(InputContext& context, int x, int y);
+
+// Taps and how many regions they had to check
+struct InputStats {
+    int taps = 0;
+    int hits = 0;
+    int regionsChecked = 0;
+};
+
+InputStats getInputStats();
+void logInputStats();
+
+#endif // INPUT_ROUTER_H
@@ -0,0 +1,78 @@
+#ifndef INVENTORY_INDEX_H
+#define INVENTORY_INDEX_H
+
+#include <cstdint>
+#include <vector>
+#include "game.h"
+
+// Sorted views of the greenhouse inventory, kept up to date as plants are
+// sold, bought or grow instead of re-sorting state.plants every frame.
+//
+// Every sort order has one list of plant indices covering all plants and
+// one per weather, so each (sort, filter) view is a ready-made array and a
+// page is a slice of it. Each plant caches a 64-bit key per order: the
+// sort value in the high half and a serial number assigned when it was
+// added in the low half, so ties keep a stable order and any plant's entry
+// can be found again by binary search. One change is an erase and an
+// insert per list; a batch (a growth tick) is sorted on its own and merged
+// in with one pass per list.
+enum class InventorySort : uint8_t {
+    CATALOG,   // Catalog number
+    NAME,
+    WEATHER,   // Preferred weather
+    GROWTH,
+    VALUE,     // Middle of the species' price band plus growth
+    COUNT
+};
+
+const int INVENTORY_SORT_COUNT = static_cast<int>(InventorySort::COUNT);
+const char* const InventorySortLabels[INVENTORY_SORT_COUNT] = {"No.", "Name", "Wthr", "Grow", "Value"};
+
+// Weather filter value that shows every plant
+const int INVENTORY_FILTER_ALL = -1;
+
+struct InventoryView {
+    InventorySort sort = InventorySort::CATALOG;
+    bool descending = false;
+    int weatherFilter = INVENTORY_FILTER_ALL;
+};
+
+// Index every plant from scratch (startup, after loading a save)
+void rebuildInventoryIndex(const std::vector<Plant>& plants);
+
+// The plant at plantIndex was removed by moving the last plant (which was
+// at lastIndex) into its slot; see sellPlant
+void inventoryPlantRemoved(int plantIndex, int lastIndex);
+
+// Growth or ownership of one plant changed
+void inventoryPlantChanged(const std::vector<Plant>& plants, int plantIndex);
+
+// Many plants changed at once; cheaper than one call each
+void inventoryPlantsChanged(const std::vector<Plant>& plants, const int* plantIndices, int count);
+
+void setInventoryView(const InventoryView& view);
+InventoryView getInventoryView();
+
+// Plants in the current view
+int inventoryCount();
+
+// Plant index at a position in the current view, or -1 past the end
+int inventoryPlantAt(int position);
+
+// Position of a plant in the current view, or -1 if it is filtered out
+int inventoryPositionOf(int plantIndex);
+
+// Update counts and cost
+struct InventoryIndexStats {
+    int rebuilds = 0;
+    int updates = 0;          // Single plant changes, adds and removals
+    int batches = 0;
+    int batchedPlants = 0;
+    double updateMicros = 0;
+    double maxUpdateMicros = 0;
+};
+
+InventoryIndexStats getInventoryIndexStats();
+void logInventoryIndexStats();
+
+#endif // INVENTORY_INDEX_H
@@ -0,0 +1,83 @@
+#ifndef JOB_SYSTEM_H
+#define JOB_SYSTEM_H
+
+#include <atomic>
+
+// Small work-stealing job system shared by everything that wants to run in
+// parallel (image decoding, colour grading, recolouring, ...).
+//
+// Each worker thread, the main thread and up to MAX_JOB_SUBMITTERS other
+// threads that queue jobs own a fixed-size deque. Jobs
+// are pushed to the submitting thread's deque and popped newest first by
+// the owner; idle workers steal the oldest job from other deques. A thread
+// that waits on a counter runs jobs itself instead of blocking, so waiting
+// on the main thread never leaves a core idle. Nothing allocates after
+// initJobSystem.
+//
+// SDL rendering calls must stay on the main thread. Jobs that need them
+// are queued with submitMainThreadJob and run by runMainThreadJobs once a
+// frame, or while the main thread waits on a counter.
+const int MAX_JOB_WORKERS = 8;
+const int MAX_JOB_SUBMITTERS = 4;          // Non-worker threads besides the main thread
+const int JOB_QUEUE_CAPACITY = 256;        // Per deque; a full deque runs the job inline
+const int MAIN_THREAD_JOB_CAPACITY = 64;
+
+// Runs items [begin, end) of whatever data points at
+typedef void (*JobFunction)(void* data, int begin, int end);
+
+// Fence for a group of jobs: counts the ones still to run
+struct JobCounter {
+    std::atomic<int> pending{0};
+
+    bool done() const { return pending.load(std::memory_order_acquire) == 0; }
+};
+
+struct Job {
+    JobFunction function = nullptr;
+    void* data = nullptr;
+    int begin = 0;
+    int end = 0;
+    JobCounter* counter = nullptr;   // Decremented when the job has run; may be null
+};
+
+// Start the workers; -1 picks one per core minus the main thread, 0 runs
+// every job inline on the submitting thread
+void initJobSystem(int workerCount = -1);
+
+// Finish queued jobs and join the workers
+void shutdownJobSystem();
+
+int jobWorkerCount();
+
+// Queue one job (counter->pending is incremented here)
+void submitJob(const Job& job);
+
+// Split [0, count) into jobs of up to grain items and queue them
+void parallelFor(JobFunction function, void* data, int count, int grain, JobCounter& counter);
+
+// Run jobs until the counter reaches zero
+void waitForCounter(JobCounter& counter);
+
+// Queue a job for the main thread. Returns false if the queue is full.
+bool submitMainThreadJob(const Job& job);
+
+// Run the queued main thread jobs; call from the main thread only
+int runMainThreadJobs();
+
+// Scheduler counters
+struct JobStats {
+    int workers = 0;
+    long long jobs = 0;             // Run on any thread
+    long long mainThreadRuns = 0;   // Of those, run by the main thread while waiting
+    long long submitterRuns = 0;    // Run by other non-worker threads while waiting
+    long long steals = 0;
+    long long inlineRuns = 0;       // Deque full or no workers
+    long long mainThreadJobs = 0;   // Queued with submitMainThreadJob
+    long long waits = 0;
+    double waitMicros = 0;          // Main thread time spent in waitForCounter
+};
+
+JobStats getJobStats();
+void logJobStats();
+
+#endif // JOB_SYSTEM_H
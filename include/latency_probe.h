@@ -0,0 +1,41 @@
+#ifndef LATENCY_PROBE_H
+#define LATENCY_PROBE_H
+
+#include <SDL2/SDL.h>
+#include <cstdint>
+
+// Input-to-photon latency (--latency, implied by --replay). Every queued
+// input event gets an id; the simulation stamps each snapshot with the id
+// of the newest event it has applied, and once the render loop presents
+// that snapshot every event up to the id has reached the screen. The time
+// from queueing to present goes into a histogram with 1 ms buckets.
+// Queueing and presenting both happen on the main thread, so nothing here
+// needs to be atomic.
+const int LATENCY_HISTOGRAM_BUCKETS = 100;   // The last one holds everything slower
+const int LATENCY_TRACKED_EVENTS = 256;      // Events in flight at once; older ones are dropped
+
+void setLatencyProbeEnabled(bool enabled);
+bool latencyProbeEnabled();
+
+// An input event with this id was queued at the given performance counter
+void latencyInputQueued(uint32_t id, Uint64 queuedAt);
+
+// A frame reflecting every input event up to lastInputId was just presented
+void latencyFramePresented(uint32_t lastInputId);
+
+struct LatencyStats {
+    long long samples = 0;
+    long long lost = 0;              // Overwritten before their frame was presented
+    double totalMicros = 0;
+    double maxMicros = 0;
+    long long histogram[LATENCY_HISTOGRAM_BUCKETS] = {};
+};
+
+LatencyStats getLatencyStats();
+
+// Upper edge, in ms, of the bucket holding the given fraction (0-1) of samples
+int latencyPercentileMs(const LatencyStats& stats, double fraction);
+
+void logLatencyStats();
+
+#endif // LATENCY_PROBE_H
@@ -0,0 +1,145 @@
+#ifndef LAYOUT_H
+#define LAYOUT_H
+
+#include <array>
+#include "game.h"
+
+// Widget rectangles for every screen, computed at compile time from the
+// screen constants. Drawing and hit-testing both read these tables, so no
+// rect is rebuilt or mutated while the game runs.
+
+constexpr SDL_Rect makeRect(int x, int y, int w, int h) {
+    return SDL_Rect{x, y, w, h};
+}
+
+constexpr Button makeButton(int x, int y, int w, int h) {
+    return Button{makeRect(x, y, w, h), false};
+}
+
+constexpr bool rectOnScreen(const SDL_Rect& rect) {
+    return rect.x >= 0 && rect.y >= 0 &&
+           rect.x + rect.w <= SCREEN_WIDTH && rect.y + rect.h <= SCREEN_HEIGHT;
+}
+
+constexpr bool rectsOverlap(const SDL_Rect& a, const SDL_Rect& b) {
+    return a.x < b.x + b.w && b.x < a.x + a.w &&
+           a.y < b.y + b.h && b.y < a.y + a.h;
+}
+
+// Toolbar along the bottom of the screen
+constexpr SDL_Rect TOOLBAR_RECT = makeRect(0, SCREEN_HEIGHT - TOOLBAR_HEIGHT, SCREEN_WIDTH, TOOLBAR_HEIGHT);
+
+// Back button at the left of the toolbar (map, location and store screens)
+constexpr Button BACK_BUTTON = makeButton(5, SCREEN_HEIGHT - TOOLBAR_HEIGHT + 5, MENU_BUTTON_SIZE, MENU_BUTTON_SIZE);
+
+// Plant view: a centered row of four buttons just above the toolbar
+const int NAV_BUTTON_COUNT = 4;
+const int NAV_BUTTON_SPACING = 10;
+const int NAV_BUTTON_Y = SCREEN_HEIGHT - TOOLBAR_HEIGHT - 40;
+const int NAV_ROW_WIDTH = (MENU_BUTTON_SIZE + NAV_BUTTON_SPACING) * NAV_BUTTON_COUNT - NAV_BUTTON_SPACING;
+const int NAV_ROW_X = (SCREEN_WIDTH - NAV_ROW_WIDTH) / 2;
+
+constexpr Button navButton(int slot) {
+    return makeButton(NAV_ROW_X + slot * (MENU_BUTTON_SIZE + NAV_BUTTON_SPACING), NAV_BUTTON_Y,
+                      MENU_BUTTON_SIZE, MENU_BUTTON_SIZE);
+}
+
+constexpr PlantNavigationButtons PLANT_VIEW_NAV = {
+    navButton(0),  // Previous plant
+    navButton(1),  // Next plant
+    navButton(2),  // Map
+    navButton(3)   // Store
+};
+
+// Middle of the play area, where the plant is drawn (sparkles on plant change)
+constexpr SDL_Rect PLANT_SPARKLE_AREA = makeRect(SCREEN_WIDTH / 4, (SCREEN_HEIGHT - TOOLBAR_HEIGHT) / 4,
+                                                 SCREEN_WIDTH / 2, (SCREEN_HEIGHT - TOOLBAR_HEIGHT) / 2);
+
+// Map: one button per location, one in each corner
+const int LOCATION_BUTTON_SIZE = 40;
+const int LOCATION_PADDING = 10;
+const int LOCATION_COUNT = 4;
+
+constexpr std::array<Button, LOCATION_COUNT> MAP_LOCATION_BUTTONS = {{
+    makeButton(LOCATION_PADDING, LOCATION_PADDING,
+               LOCATION_BUTTON_SIZE, LOCATION_BUTTON_SIZE),                       // House
+    makeButton(SCREEN_WIDTH - LOCATION_BUTTON_SIZE - LOCATION_PADDING, LOCATION_PADDING,
+               LOCATION_BUTTON_SIZE, LOCATION_BUTTON_SIZE),                       // Greenhouse
+    makeButton(LOCATION_PADDING, SCREEN_HEIGHT - LOCATION_BUTTON_SIZE - LOCATION_PADDING,
+               LOCATION_BUTTON_SIZE, LOCATION_BUTTON_SIZE),                       // Pasture
+    makeButton(SCREEN_WIDTH - LOCATION_BUTTON_SIZE - LOCATION_PADDING,
+               SCREEN_HEIGHT - LOCATION_BUTTON_SIZE - LOCATION_PADDING,
+               LOCATION_BUTTON_SIZE, LOCATION_BUTTON_SIZE)                        // Store
+}};
+
+// Inventory: one page of plant cells, plus page buttons in the toolbar
+const int INVENTORY_SIDE_MARGIN = 30;
+const int INVENTORY_TOP_MARGIN = 60;
+const int INVENTORY_ROW_SPACING = 120;
+const int INVENTORY_CELL_SPACING = 20;
+const int INVENTORY_CELL_SIZE = (SCREEN_WIDTH - 2 * INVENTORY_SIDE_MARGIN -
+                                 INVENTORY_CELL_SPACING * (MENU_GRID_COLS - 1)) / MENU_GRID_COLS;
+const int PLANTS_PER_PAGE = MENU_GRID_ROWS * MENU_GRID_COLS;
+
+constexpr std::array<Button, PLANTS_PER_PAGE> makeInventoryGrid() {
+    std::array<Button, PLANTS_PER_PAGE> cells = {};
+    for (int i = 0; i < PLANTS_PER_PAGE; i++) {
+        int row = i / MENU_GRID_COLS;
+        int col = i % MENU_GRID_COLS;
+        cells[i] = makeButton(INVENTORY_SIDE_MARGIN + col * (INVENTORY_CELL_SIZE + INVENTORY_CELL_SPACING),
+                              INVENTORY_TOP_MARGIN + row * INVENTORY_ROW_SPACING,
+                              INVENTORY_CELL_SIZE, INVENTORY_CELL_SIZE);
+    }
+    return cells;
+}
+
+constexpr std::array<Button, PLANTS_PER_PAGE> INVENTORY_GRID = makeInventoryGrid();
+
+constexpr Button INVENTORY_PREV_PAGE = makeButton(5, SCREEN_HEIGHT - TOOLBAR_HEIGHT + 5,
+                                                  MENU_BUTTON_SIZE, MENU_BUTTON_SIZE);
+constexpr Button INVENTORY_NEXT_PAGE = makeButton(SCREEN_WIDTH - MENU_BUTTON_SIZE - 5, SCREEN_HEIGHT - TOOLBAR_HEIGHT + 5,
+                                                  MENU_BUTTON_SIZE, MENU_BUTTON_SIZE);
+
+// Sort order and weather filter, between the page buttons
+const int INVENTORY_VIEW_BUTTON_WIDTH = 34;
+constexpr Button INVENTORY_SORT_BUTTON = makeButton(INVENTORY_PREV_PAGE.rect.x + MENU_BUTTON_SIZE + 3,
+                                                    SCREEN_HEIGHT - TOOLBAR_HEIGHT + 5,
+                                                    INVENTORY_VIEW_BUTTON_WIDTH, MENU_BUTTON_SIZE);
+constexpr Button INVENTORY_FILTER_BUTTON = makeButton(INVENTORY_SORT_BUTTON.rect.x + INVENTORY_VIEW_BUTTON_WIDTH + 2,
+                                                      SCREEN_HEIGHT - TOOLBAR_HEIGHT + 5,
+                                                      INVENTORY_VIEW_BUTTON_WIDTH, MENU_BUTTON_SIZE);
+
+// Store: shopkeeper dialog with Yes/No buttons underneath
+const int STORE_DIALOG_HEIGHT = 100;
+const int STORE_DIALOG_Y = SCREEN_HEIGHT - TOOLBAR_HEIGHT - 130;
+const int STORE_CHOICE_WIDTH = 40;
+const int STORE_CHOICE_HEIGHT = 20;
+const int STORE_CHOICE_SPACING = 20;
+const int STORE_CHOICE_X = (SCREEN_WIDTH - (STORE_CHOICE_WIDTH * 2 + STORE_CHOICE_SPACING)) / 2;
+const int STORE_CHOICE_Y = STORE_DIALOG_Y + STORE_DIALOG_HEIGHT + 10;
+
+constexpr SDL_Rect STORE_DIALOG_RECT = makeRect(10, STORE_DIALOG_Y, SCREEN_WIDTH - 20, STORE_DIALOG_HEIGHT);
+constexpr Button STORE_YES_BUTTON = makeButton(STORE_CHOICE_X, STORE_CHOICE_Y,
+                                               STORE_CHOICE_WIDTH, STORE_CHOICE_HEIGHT);
+constexpr Button STORE_NO_BUTTON = makeButton(STORE_CHOICE_X + STORE_CHOICE_WIDTH + STORE_CHOICE_SPACING, STORE_CHOICE_Y,
+                                              STORE_CHOICE_WIDTH, STORE_CHOICE_HEIGHT);
+
+// Catch layout mistakes when the screen constants change
+static_assert(rectOnScreen(BACK_BUTTON.rect), "back button must be on screen");
+static_assert(rectOnScreen(PLANT_VIEW_NAV.prevPlantButton.rect) &&
+              rectOnScreen(PLANT_VIEW_NAV.storeButton.rect), "plant view buttons must be on screen");
+static_assert(NAV_BUTTON_Y + MENU_BUTTON_SIZE <= SCREEN_HEIGHT - TOOLBAR_HEIGHT,
+              "plant view buttons must sit above the toolbar");
+static_assert(rectOnScreen(MAP_LOCATION_BUTTONS[3].rect), "location buttons must be on screen");
+static_assert(INVENTORY_CELL_SIZE > 0, "inventory cells must fit across the screen");
+static_assert(rectOnScreen(STORE_YES_BUTTON.rect) && rectOnScreen(STORE_NO_BUTTON.rect),
+              "store buttons must be on screen");
+static_assert(!rectsOverlap(STORE_YES_BUTTON.rect, BACK_BUTTON.rect) &&
+              !rectsOverlap(STORE_NO_BUTTON.rect, BACK_BUTTON.rect),
+              "store buttons must not overlap the back button");
+static_assert(!rectsOverlap(INVENTORY_PREV_PAGE.rect, INVENTORY_NEXT_PAGE.rect),
+              "page buttons must not overlap");
+static_assert(!rectsOverlap(INVENTORY_FILTER_BUTTON.rect, INVENTORY_NEXT_PAGE.rect),
+              "inventory view buttons must fit between the page buttons");
+
+#endif // LAYOUT_H
@@ -0,0 +1,97 @@
+#ifndef MEMORY_TRACKER_H
+#define MEMORY_TRACKER_H
+
+#include <SDL2/SDL.h>
+#include <cstddef>
+#include <functional>
+#include <string>
+
+// Categories used to account texture memory
+enum class MemoryCategory {
+    PLANT_SPRITE,   // Plant textures
+    BACKGROUND,     // Screen backgrounds (weather, map, store, garden)
+    TEXT,           // Rendered text textures
+    UI,             // Buttons, toolbars and other interface textures
+    PLACEHOLDER,    // Generated placeholder textures
+    SCALED_SPRITE,  // Pre-scaled sprite copies (see sprite_cache.h)
+    COUNT
+};
+
+// What to do when a category goes over its budget
+enum class BudgetAction {
+    LOG,    // Report the overrun and keep going
+    EVICT   // Ask the category's eviction handler to free memory
+};
+
+// Per-category accounting
+struct MemoryCategoryStats {
+    size_t bytes = 0;        // Bytes currently allocated
+    size_t peakBytes = 0;    // Highest value of bytes seen
+    int textures = 0;        // Live textures in this category
+    size_t budget = 0;       // Budget in bytes (0 = unlimited)
+    BudgetAction action = BudgetAction::LOG;
+    int overBudgetEvents = 0;
+};
+
+// Heap accounting from the allocator hooks
+struct HeapStats {
+    size_t bytes = 0;
+    size_t peakBytes = 0;
+    size_t allocations = 0;  // Total number of allocations made
+};
+
+// Eviction handler: asked to free at least bytesToFree from its category.
+// The texture that triggered the overrun is passed as keep and must not be freed.
+// Returns the number of bytes actually freed.
+using EvictionHandler = std::function<size_t(size_t bytesToFree, SDL_Texture* keep)>;
+
+// Called with each texture just before destroyTrackedTexture destroys it,
+// so caches holding the pointer can drop it
+using TextureReleaseHandler = std::function<void(SDL_Texture* texture)>;
+
+// Estimated GPU/CPU bytes held by a texture (width * height * bytes per pixel)
+size_t textureBytes(SDL_Texture* texture);
+
+// Register a texture under a category and enforce its budget. Returns the texture.
+SDL_Texture* trackTexture(SDL_Texture* texture, MemoryCategory category);
+
+// Remove a texture from accounting and destroy it
+void destroyTrackedTexture(SDL_Texture* texture);
+
+// Category a texture is tracked under, or COUNT if it is not tracked
+MemoryCategory trackedCategory(SDL_Texture* texture);
+
+// Budget configuration
+void setMemoryBudget(MemoryCategory category, size_t bytes, BudgetAction action);
+void setEvictionHandler(MemoryCategory category, EvictionHandler handler);
+// Up to MAX_TEXTURE_RELEASE_HANDLERS can be registered; returns false when full
+const int MAX_TEXTURE_RELEASE_HANDLERS = 4;
+bool addTextureReleaseHandler(TextureReleaseHandler handler);
+
+// Parse a command line budget of the form "<category>:<kilobytes>[:evict]",
+// e.g. "plants:16384:evict". Returns false if the argument is malformed.
+bool parseMemoryBudgetArg(const std::string& arg);
+
+// Statistics
+const char* memoryCategoryName(MemoryCategory category);
+const MemoryCategoryStats& getMemoryStats(MemoryCategory category);
+size_t getTotalTextureBytes();
+HeapStats getCppHeapStats();
+HeapStats getSdlHeapStats();
+
+// Route SDL's internal allocations through counting hooks.
+// Must be called before SDL_Init so no SDL allocation predates the hook.
+void installSdlMemoryHooks();
+
+// Mark the end of initialization. Later C++ heap allocations trip an
+// assertion in PIXELPETS_NO_HEAP_AFTER_INIT builds; in every build they
+// (and SDL's own allocations) are counted and shown in the report.
+void lockHeap();
+void unlockHeap();
+size_t getCppAllocationsAfterLock();
+size_t getSdlAllocationsAfterLock();
+
+// Print a table of all categories and heap usage
+void logMemoryReport();
+
+#endif // MEMORY_TRACKER_H
@@ -0,0 +1,84 @@
+#ifndef PARTICLES_H
+#define PARTICLES_H
+
+#include <SDL2/SDL.h>
+#include <cstdint>
+#include <memory>
+
+class Display;
+
+// Pool size for the game; the benchmark makes its own larger pool
+const int EFFECT_PARTICLE_CAPACITY = 512;
+
+// Emitter tuning
+const int CONFETTI_BURST_COUNT = 50;
+const int SPARKLE_BURST_COUNT = 12;
+
+// Particle engine with structure-of-arrays storage in a fixed-capacity
+// pool. Each attribute lives in its own array so the integration loops
+// run over contiguous floats and vectorize; dead particles are swapped
+// with the last live one so the live range stays packed. Everything is
+// drawn with one SDL_RenderGeometry call (SDL 2.0.18+), or batched
+// SDL_RenderFillRects on older SDL.
+class ParticleSystem {
+public:
+    // Allocate storage for capacity particles; call during init
+    bool init(int capacity);
+    void clear();
+
+    int count() const { return liveCount; }
+    int capacity() const { return maxCount; }
+
+    // Advance by dt seconds and drop expired particles
+    void update(float dt);
+
+    // Draw all live particles
+    void render(SDL_Renderer* renderer) const;
+
+    // Copy what render needs (position, age, colour, size) of other's live
+    // particles, up to this pool's capacity. Frame snapshots use this to
+    // hand the simulation's particles to the render thread.
+    void copyFrom(const ParticleSystem& other);
+
+    // Continuous emitters; call once per frame with the frame time.
+    // Rain falls as streaks leaning with the wind (pixels/second).
+    void emitRain(float dt, float perSecond, float wind);
+    void emitWind(float dt, float perSecond, float speed);
+
+    // One-shot emitters
+    void burstConfetti(float x, float y, int count);
+    void burstSparkles(const SDL_Rect& area, int count);
+
+private:
+    // Returns the new particle's slot, or -1 when the pool is full
+    int spawn(float x, float y, float vx, float vy, float ax, float ay,
+              float life, uint32_t color, uint8_t width, uint8_t height);
+    float random01();
+    float randomRange(float low, float high) { return low + (high - low) * random01(); }
+
+    int maxCount = 0;
+    int liveCount = 0;
+
+    // One array per attribute
+    std::unique_ptr<float[]> x, y;
+    std::unique_ptr<float[]> vx, vy;
+    std::unique_ptr<float[]> ax, ay;
+    std::unique_ptr<float[]> age, life;
+    std::unique_ptr<uint32_t[]> color;   // RGBA, alpha fades with age
+    std::unique_ptr<uint8_t[]> width, height;
+
+    // Submission buffers, sized once in init
+    mutable std::unique_ptr<SDL_Vertex[]> vertices;
+    std::unique_ptr<int[]> indices;
+    mutable std::unique_ptr<SDL_Rect[]> rects;
+
+    float rainCarry = 0.0f;   // Fractional particles owed by the emitters
+    float windCarry = 0.0f;
+    uint32_t rngState = 0x9E3779B9u;
+};
+
+// Update and draw `count` particles for a few hundred frames and print the
+// time per frame (--bench-particles[=count])
+void runParticleBenchmark(Display& display, int count);
+
+#endif // PARTICLES_H
@@ -0,0 +1,92 @@
+#ifndef PLANT_CATALOG_H
+#define PLANT_CATALOG_H
+
+#include <cstdint>
+#include <string>
+#include "game.h"
+
+// Every plant species the game knows, loaded once from assets/catalog.csv:
+//
+//   id,name,rarity,weather,growth_per_tick,price_min,price_max,sprite
+//
+// Species are kept sorted by id in one compact table, with names and sprite
+// paths in a shared string pool. A dense id -> slot table gives O(1)
+// lookup, and slots are also grouped by weather and by rarity so those
+// queries are a range walk. Sprites aren't loaded here: plants load theirs
+// the first time they are drawn, so catalog size doesn't cost startup time
+// or texture memory. Only the hit-test masks of species the player has are
+// built at startup (buildSpeciesMasks).
+const char* const PLANT_CATALOG_PATH = "assets/catalog.csv";
+const int WEATHER_COUNT = 4;
+const int STARTER_PLANT_COUNT = 8;   // Species 1..8 start in the greenhouse
+
+enum class Rarity : uint8_t {
+    COMMON,
+    UNCOMMON,
+    RARE,
+    LEGENDARY,
+    COUNT
+};
+
+const int RARITY_COUNT = static_cast<int>(Rarity::COUNT);
+const char* const RarityNames[RARITY_COUNT] = {"Common", "Uncommon", "Rare", "Legendary"};
+
+struct PlantSpecies {
+    uint16_t id;
+    Rarity rarity;
+    WeatherType weather;     // Grows twice as fast in this weather
+    uint8_t growthPerTick;
+    uint16_t priceMin;       // Shopkeeper offers fall in this band
+    uint16_t priceMax;
+    uint32_t nameOffset;     // Into the string pool
+    uint32_t spriteOffset;
+    uint16_t nameRank;       // Position in alphabetical order, for sorting by name
+};
+
+// Slots of the species in one weather or rarity group, in id order
+struct SpeciesRange {
+    const uint16_t* first;
+    const uint16_t* last;
+
+    const uint16_t* begin() const { return first; }
+    const uint16_t* end() const { return last; }
+    int size() const { return static_cast<int>(last - first); }
+};
+
+// Load the catalog (embedded or from assets/). Bad lines are reported and
+// skipped. Returns false if no species were loaded.
+bool loadPlantCatalog(const std::string& path = PLANT_CATALOG_PATH);
+
+int speciesCount();
+const PlantSpecies& speciesAt(int slot);
+
+// Species with this id, or nullptr
+const PlantSpecies* findSpecies(int id);
+
+const char* speciesName(const PlantSpecies& species);
+const char* speciesSprite(const PlantSpecies& species);
+
+SpeciesRange speciesByWeather(WeatherType weather);
+SpeciesRange speciesByRarity(Rarity rarity);
+
+// Opaque pixels of a species' sprite, for hit-testing taps
+struct SpeciesHitMask {
+    int spriteWidth = 0;    // Size of the sprite the mask was sampled from
+    int spriteHeight = 0;
+    AlphaMask mask;
+};
+
+// Decode the sprites of these species, in parallel on the job system, and
+// keep a mask of each, so a tap never decodes an image. Call once the
+// plants are known, before the simulation starts. A sprite that fails to
+// load is drawn as a 32x32 placeholder, which the whole rect hits.
+void buildSpeciesMasks(const int* catalogIds, int count);
+
+// Mask for a species, or nullptr if none was built
+const SpeciesHitMask* speciesHitMask(int catalogId);
+
+// Table sizes for the memory report
+size_t plantCatalogBytes();
+void logPlantCatalogStats();
+
+#endif // PLANT_CATALOG_H
@@ -4,15 +4,47 @@
 #include <SDL2/SDL.h>
 #include <vector>
 #include "game.h"
+#include "arena.h"
+#include "layout.h"
+#include "color_grade.h"
+#include "weather_overlay.h"
+#include "render_snapshot.h"
+
+// A species' sprite, bound the first time it is drawn. The render thread
+// keeps one per catalog id; plants themselves hold no textures.
+struct PlantSprite {
+    SDL_Texture* texture = nullptr;
+    int width = 0;
+    int height = 0;
+    bool pinned = false;   // Bound at init because loading it allocates; never evicted
+    uint32_t lastUsedFrame = 0;   // Render frame that last drew it; recent ones aren't evicted
+};
 
 // Font initialization and cleanup
 bool initFont();
 void cleanupFont();
 
+// Glyph atlas used for all text once created (call after initFont)
+bool initTextAtlas(SDL_Renderer* renderer);
+void cleanupTextAtlas();
+
+// Screen backgrounds (map, store, garden) loaded once at startup
+void loadScreenTextures(SDL_Renderer* renderer);
+void cleanupScreenTextures();
+
 // Text rendering helper functions
-SDL_Rect getTextDimensions(const std::string& text);
-int centerTextX(const std::string& text, int containerWidth);
-void renderText(SDL_Renderer* renderer, const std::string& text, int x, int y, SDL_Color color);
+SDL_Rect getTextDimensions(const char* text);
+int centerTextX(const char* text, int containerWidth);
+void renderText(SDL_Renderer* renderer, const char* text, int x, int y, SDL_Color color);
+
+inline SDL_Rect getTextDimensions(const std::string& text) { return getTextDimensions(text.c_str()); }
+inline int centerTextX(const std::string& text, int containerWidth) { return centerTextX(text.c_str(), containerWidth); }
+inline void renderText(SDL_Renderer* renderer, const std::string& text, int x, int y, SDL_Color color) {
+    renderText(renderer, text.c_str(), x, y, color);
+}
+
+// Wrap text to a width; the lines are allocated from the frame arena
+FrameVector<FrameString> wrapText(const char* text, int maxWidth);
 
 // Function declarations for rendering
 SDL_Texture* createPlaceholderBackground(SDL_Renderer* renderer, const SDL_Color& bgColor, const std::string& label, int width, int height);
@@ -20,19 +52,23 @@ std::vector<Background> loadBackgrounds(SDL_Renderer* renderer);
 
 void renderIntroScreen(SDL_Renderer* renderer, const ColorPalette& palette);
 
-void renderPlantViewScreen(SDL_Renderer* renderer, const ColorPalette& palette, const Plant& plant,
-                         const Player& player, PlantNavigationButtons& navButtons, 
-                         WeatherType weather, DayNightType dayNight, 
+// The screens below draw from a frame snapshot; sprites are indexed by
+// catalog id
+void renderPlantViewScreen(SDL_Renderer* renderer, const ColorPalette& palette, const RenderSnapshot& snapshot,
+                         const std::vector<PlantSprite>& sprites,
                          const std::vector<Background>& backgrounds,
-                         const std::vector<Raindrop>& raindrops);
+                         const WeatherOverlay& weatherOverlay);
+
+// Where a sprite of the given size is drawn inside an inventory cell
+SDL_Rect inventoryPlantRect(const SDL_Rect& cell, int width, int height);
 
-void renderMenuViewScreen(SDL_Renderer* renderer, const ColorPalette& palette,
-                        const std::vector<Plant>& plants, const Player& player,
-                        const std::vector<Button>& menuGridButtons,
-                        const Button& prevPageButton, const Button& nextPageButton,
-                        int currentPage, int plantsPerPage);
+void renderMenuViewScreen(SDL_Renderer* renderer, const ColorPalette& palette, const RenderSnapshot& snapshot,
+                        const std::vector<PlantSprite>& sprites);
 
-void drawPixelText(SDL_Renderer* renderer, const std::string& text, int x, int y, SDL_Color color);
+void drawPixelText(SDL_Renderer* renderer, const char* text, int x, int y, SDL_Color color);
+inline void drawPixelText(SDL_Renderer* renderer, const std::string& text, int x, int y, SDL_Color color) {
+    drawPixelText(renderer, text.c_str(), x, y, color);
+}
 
 // Helper functions
 void renderTexture(SDL_Renderer* renderer, SDL_Texture* texture, int x, int y, SDL_Rect* clip, double scale);
@@ -41,10 +77,7 @@ void drawBgButton(SDL_Renderer* renderer, const Button& button, const ColorPalet
 void drawPlantSelectionButton(SDL_Renderer* renderer, const Button& button, SDL_Texture* plantTexture, int plantWidth, int plantHeight, bool isSelected, const ColorPalette& palette);
 void drawFertilizerIcon(SDL_Renderer* renderer, int x, int y, int size, const ColorPalette& palette);
 
-void renderStoreScreen(SDL_Renderer* renderer, const ColorPalette& palette, 
-                      const std::vector<Plant>& plants, const Player& player,
-                      const Button& backButton, const std::string& shopkeeperText,
-                      const Button& yesButton, const Button& noButton,
-                      int selectedPlantIndex, int offerAmount);
+void renderStoreScreen(SDL_Renderer* renderer, const ColorPalette& palette, const RenderSnapshot& snapshot,
+                      const std::vector<PlantSprite>& sprites);
 
 #endif // RENDER_H 
\ No newline at end of file
@@ -0,0 +1,92 @@
+#ifndef RENDER_SNAPSHOT_H
+#define RENDER_SNAPSHOT_H
+
+#include <SDL2/SDL.h>
+#include <cstdint>
+#include "game.h"
+#include "layout.h"
+#include "color_grade.h"
+#include "inventory_index.h"
+#include "particles.h"
+#include "weather_overlay.h"
+
+// Everything one frame draws, copied out of the game state by the
+// simulation thread so the render thread never reads live state.
+//
+// Three snapshots are handed back and forth lock-free: the simulation
+// fills the back one while the renderer draws the front one, and the
+// middle one is the newest complete frame. Publishing swaps back and
+// middle, acquiring swaps middle and front, each with one atomic exchange
+// of a slot index, so neither side ever waits for the other. A snapshot
+// the renderer didn't get to before the next publish is simply replaced.
+// Snapshots are fixed size, so publishing never allocates.
+
+// A plant as drawn. The name points into the plant catalog's string pool,
+// which doesn't change once loaded.
+struct PlantSnapshot {
+    int catalogId = 0;
+    const char* name = "";
+    int growth = 0;
+};
+
+struct RenderSnapshot {
+    uint32_t step = 0;            // Simulation step that produced it
+    Uint64 publishedAt = 0;       // Performance counter at publish
+    uint32_t inputId = 0;         // Newest input event it reflects
+    GameState currentState = GameState::INTRO;
+    WeatherType weather = WeatherType::SUNNY;
+    DayNightType dayNight = DayNightType::DAY;
+    GradeKey grade;
+    int coins = 0;
+
+    // Plant view
+    bool hasFocus = false;
+    PlantSnapshot focus;
+    int swipeOffset = 0;          // Plant card offset in pixels, right positive
+    bool hasNeighbours = false;   // A swipe may be under way
+    PlantSnapshot neighbours[2];  // Previous and next plant
+
+    // Current inventory page
+    InventoryView view;
+    int currentPage = 0;
+    int pagePlantCount = 0;
+    PlantSnapshot page[PLANTS_PER_PAGE];
+
+    // Store
+    char shopkeeperText[SHOPKEEPER_TEXT_CAPACITY] = {};
+    bool hasOffer = false;
+    PlantSnapshot offerPlant;
+    int offerAmount = 0;
+
+    WeatherOverlayState overlay;
+    ParticleSystem effects;       // Live effect particles, drawable fields only
+};
+
+// Size the snapshots' particle pools; call before the simulation starts
+bool initRenderSnapshots(int particleCapacity);
+
+// Simulation thread: the snapshot to fill. It still holds an older frame,
+// so every field must be written.
+RenderSnapshot& beginSnapshot();
+
+// Simulation thread: make the snapshot from beginSnapshot the newest
+void publishSnapshot();
+
+// Render thread: the newest published snapshot, or nullptr before the
+// first publish. It stays valid until the next call; fresh is set when it
+// wasn't returned before.
+const RenderSnapshot* acquireSnapshot(bool& fresh);
+
+// Hand-off counters
+struct RenderSnapshotStats {
+    long long published = 0;
+    long long acquired = 0;     // Newly published snapshots the renderer picked up
+    long long replaced = 0;     // Published but replaced before the renderer got to them
+    double latencyMicros = 0;   // Publish to acquire, summed over acquired snapshots
+    double maxLatencyMicros = 0;
+};
+
+RenderSnapshotStats getRenderSnapshotStats();
+void logRenderSnapshotStats();
+
+#endif // RENDER_SNAPSHOT_H
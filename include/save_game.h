@@ -0,0 +1,88 @@
+#ifndef SAVE_GAME_H
+#define SAVE_GAME_H
+
+#include <cstdint>
+#include <string>
+#include "game.h"
+
+// Progress is kept in two files:
+//
+//   <path>       snapshot: fixed 32 byte header followed by one 8 byte
+//                record per plant the player still has (up to
+//                MAX_SAVED_PLANTS, the most the header can count)
+//   <path>.log   journal: 16 byte records appended for every change since
+//                the snapshot (sale, purchase, growth tick)
+//
+// All fields are little-endian and every header and record carries a
+// CRC-32, so a torn write is detected and ignored. Once the journal holds
+// SAVE_COMPACT_RECORDS records, it is folded into a new snapshot that is
+// written to <path>.tmp and renamed over the old one. The snapshot stores
+// the last journal sequence it includes, so a crash between the rename and
+// truncating the journal cannot apply a change twice.
+//
+// The main thread never touches the disk. A change copies the save data
+// (8 bytes a plant) into a published image under a mutex and queues its
+// journal records; a writer thread picks both up, appends and fsyncs the
+// records, and compacts from the image. The image always includes every
+// queued record, so whatever the writer last synced is a consistent state.
+// Images are sized for the collection when the save is opened, so saving
+// never allocates.
+const char* const DEFAULT_SAVE_PATH = "pixelpets.sav";
+const uint16_t SAVE_VERSION = 2;   // 2: selected plant saved by catalog id
+const int SAVE_HEADER_SIZE = 32;
+const int SAVE_PLANT_RECORD_SIZE = 8;
+const int SAVE_JOURNAL_RECORD_SIZE = 16;
+const int SAVE_COMPACT_RECORDS = 64;
+const int MAX_SAVED_PLANTS = 65535;
+const int SAVE_PENDING_RECORDS = 256;   // Queued for the writer; overflow forces a snapshot
+
+enum class JournalOp : uint8_t {
+    SALE = 1,       // Plant sold, value = coins received
+    PURCHASE = 2,   // Plant bought, value = coins paid
+    GROWTH = 3      // Growth tick, value = new growth
+};
+
+// Load the snapshot and replay the journal onto state, whose plants come
+// from loadPlants. Opens the journal for appending. Returns true if a save
+// was found; otherwise the game starts fresh and is saved on the first
+// change.
+bool openSaveGame(GameStateData& state, const std::string& path = DEFAULT_SAVE_PATH);
+
+// Record a change that has already been applied to state and hand it to
+// the writer thread. Never blocks on I/O.
+void journalChange(const GameStateData& state, JournalOp op, int catalogId, int value);
+
+// One plant's part of a batch of changes
+struct PlantChange {
+    int catalogId;
+    int value;
+};
+
+// Record a batch of changes of one kind (e.g. a growth slice) with a single
+// hand-off. A batch bigger than the writer's queue is saved as a snapshot.
+void journalChanges(const GameStateData& state, JournalOp op, const PlantChange* changes, int count);
+
+// Ask the writer for a fresh snapshot of state and an empty journal
+void compactSaveGame(const GameStateData& state);
+
+// Flush everything queued, stop the writer and close the files
+void closeSaveGame(const GameStateData& state);
+
+// Write counts and cost
+struct SaveStats {
+    int publishes = 0;           // Main thread hand-offs
+    double publishMicros = 0;
+    double maxPublishMicros = 0;
+    int journalWrites = 0;       // Records appended by the writer
+    int journalSyncs = 0;
+    double journalMicros = 0;
+    int compactions = 0;
+    double compactMicros = 0;
+    int replayedRecords = 0;
+    int rejectedRecords = 0;     // Bad CRC or out of sequence when loading
+};
+
+SaveStats getSaveStats();
+void logSaveStats();
+
+#endif // SAVE_GAME_H
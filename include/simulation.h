@@ -0,0 +1,74 @@
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+#include <SDL2/SDL.h>
+#include <cstddef>
+#include <cstdint>
+#include "game.h"
+#include "color_grade.h"
+#include "gesture.h"
+#include "particles.h"
+#include "weather_overlay.h"
+#include "render_snapshot.h"
+
+// The game runs on its own thread: taps, weather, growth, the store,
+// overlay scrolling and effect particles all advance there, one step every
+// SIMULATION_STEP_MS (sooner when input arrives), and each step ends by
+// publishing a RenderSnapshot.
+// The main thread keeps the window, pumps events and draws the newest
+// snapshot, so drawing frame N overlaps simulating step N+1. Nothing on
+// the main thread touches the Simulation while the thread runs.
+const int SIMULATION_STEP_MS = 16;
+
+// Swiping the plant view: the plant follows the finger, and letting go
+// past SWIPE_COMMIT_DISTANCE (or flinging) moves to the neighbour. The
+// card then eases back to rest with this time constant.
+const int SWIPE_COMMIT_DISTANCE = SCREEN_WIDTH / 3;
+const float SWIPE_SETTLE_MS = 60.0f;
+
+struct Simulation {
+    GameStateData state;
+    int currentPage = 0;                // Inventory page
+    ParticleSystem effects;             // Confetti and sparkles
+    WeatherOverlayState overlay;
+    WeatherType weather = WeatherType::SUNNY;
+    DayNightType dayNight = DayNightType::DAY;
+    GradeKey grade;
+
+    Uint32 lastWeatherChange = 0;
+    Uint32 lastGrowthTick = 0;
+    size_t growthCursor = 0;            // Next plant to grow; plants.size() when no tick is due
+    Uint32 lastStepTime = 0;
+    int lastCoins = 0;
+    uint32_t step = 0;
+    uint32_t lastInputId = 0;           // Newest input event applied
+
+    GestureRecognizer gestures;
+    bool swipeArmed = false;            // Press on the plant view missed every button
+    float swipeOffset = 0;              // Plant card offset in pixels; right shows the previous plant
+};
+
+// Set up timers and storage once state.plants is loaded
+bool initSimulation(Simulation& sim);
+
+// Advance one step: apply queued input, then timers, growth and effects
+void stepSimulation(Simulation& sim);
+
+// Copy what the next frame draws
+void fillSnapshot(const Simulation& sim, RenderSnapshot& snapshot);
+
+// Step and publish on a thread of its own until stopped
+bool startSimulationThread(Simulation& sim);
+void stopSimulationThread();
+
+// Step counters
+struct SimulationStats {
+    long long steps = 0;
+    double stepMicros = 0;
+    double maxStepMicros = 0;
+};
+
+SimulationStats getSimulationStats();
+void logSimulationStats();
+
+#endif // SIMULATION_H
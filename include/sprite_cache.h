@@ -0,0 +1,46 @@
+#ifndef SPRITE_CACHE_H
+#define SPRITE_CACHE_H
+
+#include <SDL2/SDL.h>
+#include <cmath>
+#include <cstddef>
+
+// Plant sprites are much larger than they are drawn and were scaled by a
+// fractional factor on every draw. The cache keeps nearest-neighbour copies
+// at the exact on-screen sizes, keyed by (sprite, width, height), so draws
+// are 1:1 copies. Copies are tracked as MemoryCategory::SCALED_SPRITE and
+// the least recently used ones are evicted when that budget is exceeded.
+const int SPRITE_CACHE_CAPACITY = 48;
+const size_t SPRITE_CACHE_DEFAULT_BUDGET = 1024 * 1024;
+
+// Register the eviction and release handlers and, unless --mem-budget=scaled
+// set one, the default budget
+void initSpriteCache();
+
+// Destroy every cached copy, e.g. when render targets were reset or the
+// sources were recolored
+void clearSpriteCache();
+
+// Cached copy of source at width x height, created on a miss. Returns
+// nullptr if the copy can't be made.
+SDL_Texture* scaledSprite(SDL_Renderer* renderer, SDL_Texture* source, int width, int height);
+
+// Draw source at width x height through the cache, or scaled on the fly
+// when no copy is available
+void drawScaledSprite(SDL_Renderer* renderer, SDL_Texture* source, int x, int y, int width, int height);
+
+// Upscales snap down to whole multiples so pixels stay square
+inline double snapSpriteScale(double scale) {
+    return scale >= 1.0 ? std::floor(scale) : scale;
+}
+
+struct SpriteCacheStats {
+    int hits = 0;
+    int misses = 0;
+    int evictions = 0;
+};
+
+SpriteCacheStats getSpriteCacheStats();
+void logSpriteCacheStats();
+
+#endif // SPRITE_CACHE_H
@@ -0,0 +1,69 @@
+#ifndef TRANSITION_H
+#define TRANSITION_H
+
+#include <SDL2/SDL.h>
+#include <cstdint>
+#include "game.h"
+
+// Animated changes between screens. When the game state changes, the frame
+// still in the display's canvas is copied out as the outgoing screen. The
+// incoming screen is then drawn once as usual, which is where its sprites
+// load and its layers are built, while the outgoing screen stays on the
+// panel. That frame is copied out too, and every frame of the animation
+// after it is two full-screen copies, so it runs at the simulation's rate
+// whatever the screens cost to draw.
+const Uint32 TRANSITION_MS = 180;
+
+enum class TransitionStyle : uint8_t {
+    CUT,            // No animation
+    SLIDE_LEFT,     // Incoming screen enters from the right (going deeper)
+    SLIDE_RIGHT,    // Incoming screen enters from the left (going back)
+    FADE            // Incoming screen fades in over the outgoing one
+};
+
+// Create the two capture targets; call once after the renderer exists
+bool initTransitions(SDL_Renderer* renderer);
+void cleanupTransitions();
+
+// How to animate from one screen to another
+TransitionStyle transitionStyle(GameState from, GameState to);
+
+// Start a transition from the last presented frame, still in canvas. The
+// next frame drawn is the incoming screen; hand it to captureIncoming.
+bool beginTransition(SDL_Renderer* renderer, SDL_Texture* canvas, TransitionStyle style);
+
+// Between beginTransition and captureIncoming
+bool transitionWaitingForIncoming();
+
+// Copy the incoming screen just drawn into canvas, start the animation and
+// draw its first frame (the outgoing screen) over it
+void captureIncoming(SDL_Renderer* renderer, SDL_Texture* canvas);
+
+// While the animation runs, frames come from drawTransition instead of
+// drawing the screen
+bool transitionRunning();
+void drawTransition(SDL_Renderer* renderer);
+
+// Does the frame just drawn show the current screen, in full or as the
+// first pixels of it sliding or fading in? False for the capture frame and
+// for animation frames that still show only the outgoing screen.
+bool transitionShowsIncoming();
+
+// Drop the transition, e.g. after the targets' contents are lost
+void cancelTransition();
+
+// Transition counts, time spent preparing the incoming screen (hidden
+// behind the outgoing one) and per-frame cost of the animation
+struct TransitionStats {
+    int transitions = 0;
+    double prepareMicros = 0;
+    double maxPrepareMicros = 0;
+    long long frames = 0;
+    double frameMicros = 0;
+    double maxFrameMicros = 0;
+};
+
+TransitionStats getTransitionStats();
+void logTransitionStats();
+
+#endif // TRANSITION_H
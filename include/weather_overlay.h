@@ -0,0 +1,70 @@
+#ifndef WEATHER_OVERLAY_H
+#define WEATHER_OVERLAY_H
+
+#include <SDL2/SDL.h>
+#include <vector>
+#include "game.h"
+
+// Rain and wind drawn from small tileable textures generated at startup.
+// Each layer is tiled across the screen and scrolled by an offset that
+// advances with time; near layers are larger, brighter and faster than far
+// ones for parallax. A layer is one SDL_RenderGeometry call, so a full
+// storm costs two or three draws however many streaks it shows.
+enum class OverlayKind {
+    RAIN,
+    WIND
+};
+
+struct OverlayLayer {
+    OverlayKind kind;
+    SDL_Texture* tile = nullptr;
+    int tileWidth = 0;
+    int tileHeight = 0;
+    float speedX = 0.0f;      // Scroll speed in pixels/second
+    float speedY = 0.0f;
+    Uint8 alpha = 255;        // Alpha at full intensity
+    float minIntensity = 0;   // Layer is hidden below this intensity
+};
+
+// Seconds for an overlay to fade fully in or out when the weather changes
+const float OVERLAY_FADE_SECONDS = 1.5f;
+
+const int OVERLAY_LAYER_COUNT = 5;
+
+// Everything that moves, kept apart from the tiles so the simulation thread
+// can advance it and hand a copy to the renderer in each frame snapshot
+struct WeatherOverlayState {
+    float rainIntensity = 0.0f;
+    float windIntensity = 0.0f;
+    float offsetX[OVERLAY_LAYER_COUNT] = {};   // Scroll offset, within one tile
+    float offsetY[OVERLAY_LAYER_COUNT] = {};
+};
+
+class WeatherOverlay {
+public:
+    // Generate the tiles; call once after the renderer exists
+    bool init(SDL_Renderer* renderer);
+    void cleanup();
+
+    // Scroll the layers and ease each kind's intensity towards the one the
+    // weather calls for; needs no renderer
+    static void update(WeatherOverlayState& state, float dt, WeatherType weather);
+
+    // Draw every visible layer as the state has it
+    void render(SDL_Renderer* renderer, const WeatherOverlayState& state) const;
+
+    // Intensity (0-1) each kind should have in the given weather
+    static float targetIntensity(OverlayKind kind, WeatherType weather);
+
+private:
+    void drawLayer(SDL_Renderer* renderer, const OverlayLayer& layer, float intensity,
+                   float offsetX, float offsetY) const;
+
+    std::vector<OverlayLayer> layers;   // In the same order as the state's offsets
+
+    // Quads for the largest layer, reused by every draw
+    mutable std::vector<SDL_Vertex> vertices;
+    std::vector<int> indices;
+};
+
+#endif // WEATHER_OVERLAY_H
@@ -0,0 +1,71 @@
+#include <algorithm>
+#include "../include/alpha_mask.h"
+
+namespace {
+
+void fillAlphaMask(const uint32_t* argb, int width, int height, int pitch, AlphaMask& mask) {
+    mask.width = 0;
+    mask.height = 0;
+    mask.bits.clear();
+    if (!argb || width <= 0 || height <= 0) return;
+
+    int longest = std::max(width, height);
+    mask.width = width;
+    mask.height = height;
+    if (longest > ALPHA_MASK_MAX_SIZE) {
+        mask.width = std::max(1, width * ALPHA_MASK_MAX_SIZE / longest);
+        mask.height = std::max(1, height * ALPHA_MASK_MAX_SIZE / longest);
+    }
+
+    // assign() keeps existing capacity
+    mask.bits.assign(static_cast<size_t>(mask.stride()) * mask.height, 0);
+    for (int y = 0; y < mask.height; y++) {
+        int sourceY = y * height / mask.height;
+        const uint32_t* row = reinterpret_cast<const uint32_t*>(reinterpret_cast<const uint8_t*>(argb) +
+                                                                static_cast<size_t>(sourceY) * pitch);
+        uint8_t* out = &mask.bits[static_cast<size_t>(y) * mask.stride()];
+        for (int x = 0; x < mask.width; x++) {
+            if ((row[x * width / mask.width] >> 24) >= ALPHA_MASK_THRESHOLD) {
+                out[x / 8] |= 0x80 >> (x % 8);
+            }
+        }
+    }
+}
+
+} // namespace
+
+AlphaMask buildAlphaMask(const uint32_t* argb, int width, int height, int pitch) {
+    AlphaMask mask;
+    fillAlphaMask(argb, width, height, pitch, mask);
+    return mask;
+}
+
+AlphaMask buildAlphaMask(SDL_Surface* surface) {
+    AlphaMask mask;
+    buildAlphaMask(surface, mask);
+    return mask;
+}
+
+bool buildAlphaMask(SDL_Surface* surface, AlphaMask& mask) {
+    if (!surface || surface->format->format != SDL_PIXELFORMAT_ARGB8888) {
+        fillAlphaMask(nullptr, 0, 0, 0, mask);
+        return false;
+    }
+    SDL_LockSurface(surface);
+    fillAlphaMask(static_cast<const uint32_t*>(surface->pixels), surface->w, surface->h, surface->pitch, mask);
+    SDL_UnlockSurface(surface);
+    return true;
+}
+
+bool alphaMaskHit(const AlphaMask& mask, const SDL_Rect& dst, int x, int y) {
+    if (x < dst.x || y < dst.y || x >= dst.x + dst.w || y >= dst.y + dst.h) {
+        return false;
+    }
+    if (mask.empty()) {
+        return true;
+    }
+    // Texel drawn at this screen pixel
+    int texelX = (x - dst.x) * mask.width / dst.w;
+    int texelY = (y - dst.y) * mask.height / dst.h;
+    return mask.test(texelX, texelY);
+}
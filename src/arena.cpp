@@ -0,0 +1,19 @@
+#include <cassert>
+#include <iostream>
+#include "../include/arena.h"
+
+// Static backing store so the frame arena itself never touches the heap.
+// The render and simulation threads each reset and fill their own.
+alignas(std::max_align_t) static thread_local unsigned char tFrameArenaStorage[FRAME_ARENA_SIZE];
+
+FixedArena& frameArena() {
+    static thread_local FixedArena arena(tFrameArenaStorage, sizeof(tFrameArenaStorage));
+    return arena;
+}
+
+void arenaExhausted(const FixedArena& arena, size_t requested) {
+    std::cerr << "Arena exhausted: requested " << requested << " bytes with "
+              << arena.used() << " / " << arena.size() << " in use" << std::endl;
+    assert(!"arena exhausted");
+    throw std::bad_alloc();
+}
@@ -0,0 +1,491 @@
+#include <SDL2/SDL.h>
+#include <SDL_image.h>
+#include <SDL_ttf.h>
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <mutex>
+#include <sys/stat.h>
+#include <vector>
+#include "../include/game.h"
+#include "../include/assets.h"
+#include "../include/embedded_assets.h"
+#include "../include/indexed_sprite.h"
+#include "../include/memory_tracker.h"
+#include "../include/arena.h"
+#include "../include/job_system.h"
+
+namespace {
+
+AssetSource gAssetSource = EMBEDDED_IMAGE_COUNT > 0 ? AssetSource::EMBEDDED : AssetSource::PNG;
+AssetLoadStats gPngStats;
+AssetLoadStats gEmbeddedStats;
+std::mutex gLoadStatsMutex;   // Sprites load on the render thread, hit masks on the job system
+
+// Texture expanded from 2bpp shades, kept so it can be recolored
+struct IndexedTexture {
+    SDL_Texture* texture = nullptr;
+    IndexedImage image = {0, 0, false, nullptr};
+    std::vector<uint8_t> storage;  // Owns the pixels unless they live in the binary
+};
+
+bool gGameboyMode = false;
+std::vector<IndexedTexture> gIndexedTextures;
+IndexedAssetStats gIndexedStats;
+
+// LUTs for opaque images (4 shades) and sprites (transparent + 3 shades)
+ShadeLut gOpaqueLut;
+ShadeLut gSpriteLut;
+bool gShadeLutValid = false;
+WeatherType gShadeWeather = WeatherType::SUNNY;
+DayNightType gShadeDayNight = DayNightType::DAY;
+
+double microsSince(Uint64 start) {
+    return (SDL_GetPerformanceCounter() - start) * 1000000.0 / SDL_GetPerformanceFrequency();
+}
+
+// Count one load; sizes are ignored for failed loads
+void recordLoad(AssetLoadStats& stats, Uint64 start, bool loaded, uint64_t sourceBytes, uint64_t pixelBytes) {
+    double micros = microsSince(start);
+    std::lock_guard<std::mutex> lock(gLoadStatsMutex);
+    stats.loads++;
+    stats.decodeMicros += micros;
+    if (!loaded) {
+        stats.failures++;
+        return;
+    }
+    stats.sourceBytes += sourceBytes;
+    stats.pixelBytes += pixelBytes;
+}
+
+uint64_t fileSize(const char* path) {
+    struct stat info;
+    return stat(path, &info) == 0 ? static_cast<uint64_t>(info.st_size) : 0;
+}
+
+// Rows are independent, so an image is decoded in bands on the job system
+const int DECODE_ROWS_PER_JOB = 32;
+
+struct DecodeRowsTask {
+    const EmbeddedImage* image;
+    uint8_t* pixels;
+    int pitch;
+    std::atomic<bool> failed{false};
+};
+
+void decodeRowsJob(void* data, int begin, int end) {
+    DecodeRowsTask* task = static_cast<DecodeRowsTask*>(data);
+    uint32_t* dst = reinterpret_cast<uint32_t*>(task->pixels + static_cast<size_t>(begin) * task->pitch);
+    if (!decodeEmbeddedRows(*task->image, begin, end - begin, dst, task->pitch)) {
+        task->failed.store(true, std::memory_order_relaxed);
+    }
+}
+
+bool decodeEmbeddedParallel(const EmbeddedImage& image, uint32_t* pixels, int pitch) {
+    DecodeRowsTask task;
+    task.image = &image;
+    task.pixels = reinterpret_cast<uint8_t*>(pixels);
+    task.pitch = pitch;
+    JobCounter counter;
+    parallelFor(decodeRowsJob, &task, image.height, DECODE_ROWS_PER_JOB, counter);
+    waitForCounter(counter);
+    return !task.failed.load(std::memory_order_relaxed);
+}
+
+// Decode straight into a locked streaming texture, in bands of rows, so
+// no full-size intermediate image is ever allocated
+SDL_Texture* decodeEmbeddedTexture(SDL_Renderer* renderer, const EmbeddedImage& image) {
+    SDL_Texture* texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888,
+                                             SDL_TEXTUREACCESS_STREAMING, image.width, image.height);
+    if (!texture) {
+        std::cerr << "Unable to create texture for " << image.name << "! SDL Error: " << SDL_GetError() << std::endl;
+        return nullptr;
+    }
+
+    void* pixels = nullptr;
+    int pitch = 0;
+    if (SDL_LockTexture(texture, nullptr, &pixels, &pitch) != 0) {
+        std::cerr << "Unable to lock texture for " << image.name << "! SDL Error: " << SDL_GetError() << std::endl;
+        SDL_DestroyTexture(texture);
+        return nullptr;
+    }
+    bool decoded = decodeEmbeddedParallel(image, static_cast<uint32_t*>(pixels), pitch);
+    SDL_UnlockTexture(texture);
+
+    if (!decoded) {
+        std::cerr << "Corrupt embedded image: " << image.name << std::endl;
+        SDL_DestroyTexture(texture);
+        return nullptr;
+    }
+    return texture;
+}
+
+// Tint a palette shade for the weather and time of day
+uint32_t shadeColor(const SDL_Color& color, WeatherType weather, DayNightType dayNight) {
+    float r = color.r, g = color.g, b = color.b;
+
+    // Overcast weather washes the shades towards grey
+    float grey = weather == WeatherType::RAINY ? 0.35f : weather == WeatherType::CLOUDY ? 0.2f : 0.0f;
+    float luma = 0.299f * r + 0.587f * g + 0.114f * b;
+    r += (luma - r) * grey;
+    g += (luma - g) * grey;
+    b += (luma - b) * grey;
+
+    // Night darkens and shifts towards blue
+    if (dayNight == DayNightType::NIGHT) {
+        r *= 0.45f;
+        g *= 0.5f;
+        b = b * 0.6f + 30.0f;
+    }
+
+    auto channel = [](float value) {
+        return static_cast<uint32_t>(std::min(255.0f, std::max(0.0f, value)));
+    };
+    return 0xFF000000u | channel(r) << 16 | channel(g) << 8 | channel(b);
+}
+
+void buildShadeLuts(const ColorPalette& palette, WeatherType weather, DayNightType dayNight) {
+    // The GameBoy ramp, darkest first
+    const SDL_Color ramp[SHADE_COUNT] = {palette.background, palette.darkest, palette.medium, palette.lightest};
+    for (int i = 0; i < SHADE_COUNT; i++) {
+        gOpaqueLut[i] = shadeColor(ramp[i], weather, dayNight);
+    }
+    // Sprites give up one shade for transparency, like GameBoy OBJ palettes
+    gSpriteLut = {0x00000000u, gOpaqueLut[0], gOpaqueLut[1], gOpaqueLut[3]};
+
+    gShadeWeather = weather;
+    gShadeDayNight = dayNight;
+    gShadeLutValid = true;
+}
+
+bool expandIndexedTexture(const IndexedTexture& entry) {
+    void* pixels = nullptr;
+    int pitch = 0;
+    if (SDL_LockTexture(entry.texture, nullptr, &pixels, &pitch) != 0) {
+        std::cerr << "Unable to lock indexed texture! SDL Error: " << SDL_GetError() << std::endl;
+        return false;
+    }
+    const ShadeLut& lut = entry.image.transparent ? gSpriteLut : gOpaqueLut;
+    expandIndexedRows(entry.image, lut, 0, entry.image.height, static_cast<uint32_t*>(pixels), pitch);
+    SDL_UnlockTexture(entry.texture);
+    return true;
+}
+
+// A locked indexed texture waiting to be recolored by a job
+struct RecolorTarget {
+    const IndexedTexture* entry;
+    uint32_t* pixels;
+    int pitch;
+};
+
+void recolorJob(void* data, int begin, int end) {
+    const RecolorTarget* targets = static_cast<const RecolorTarget*>(data);
+    for (int i = begin; i < end; i++) {
+        const IndexedImage& image = targets[i].entry->image;
+        const ShadeLut& lut = image.transparent ? gSpriteLut : gOpaqueLut;
+        expandIndexedRows(image, lut, 0, image.height, targets[i].pixels, targets[i].pitch);
+    }
+}
+
+// Quantize a PNG at load time when no packed 2bpp version is available
+bool quantizePng(const char* path, IndexedTexture& entry) {
+    SDL_Surface* loaded = IMG_Load(path);
+    if (!loaded) {
+        std::cerr << "Unable to load image " << path << "! SDL_image Error: " << IMG_GetError() << std::endl;
+        return false;
+    }
+    SDL_Surface* surface = SDL_ConvertSurfaceFormat(loaded, SDL_PIXELFORMAT_ARGB8888, 0);
+    SDL_FreeSurface(loaded);
+    if (!surface) {
+        std::cerr << "Unable to convert image " << path << "! SDL Error: " << SDL_GetError() << std::endl;
+        return false;
+    }
+
+    SDL_LockSurface(surface);
+    const uint32_t* argb = static_cast<const uint32_t*>(surface->pixels);
+    bool transparent = hasTransparency(argb, surface->w, surface->h, surface->pitch);
+    quantizeToShades(argb, surface->w, surface->h, surface->pitch, transparent, entry.storage);
+    entry.image = {surface->w, surface->h, transparent, entry.storage.data()};
+    SDL_UnlockSurface(surface);
+    SDL_FreeSurface(surface);
+    return true;
+}
+
+SDL_Texture* loadIndexedTexture(SDL_Renderer* renderer, const char* path) {
+    if (!gShadeLutValid) {
+        buildShadeLuts(ColorPalette(), gShadeWeather, gShadeDayNight);
+    }
+
+    IndexedTexture entry;
+    const EmbeddedIndexedImage* embedded = nullptr;
+    if (gAssetSource == AssetSource::EMBEDDED) {
+        embedded = findEmbeddedIndexedImage(path);
+    }
+    if (embedded) {
+        entry.image = embedded->image;
+    } else if (!quantizePng(path, entry)) {
+        return nullptr;
+    }
+
+    entry.texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING,
+                                      entry.image.width, entry.image.height);
+    if (!entry.texture) {
+        std::cerr << "Unable to create texture for " << path << "! SDL Error: " << SDL_GetError() << std::endl;
+        return nullptr;
+    }
+    if (!expandIndexedTexture(entry)) {
+        SDL_DestroyTexture(entry.texture);
+        return nullptr;
+    }
+
+    gIndexedStats.textures++;
+    gIndexedStats.indexedBytes += indexedBytes(entry.image.width, entry.image.height);
+    gIndexedStats.rgbaBytes += static_cast<size_t>(entry.image.width) * entry.image.height * 4;
+
+    SDL_Texture* texture = entry.texture;
+    gIndexedTextures.push_back(std::move(entry));
+    return texture;
+}
+
+// Drop a destroyed texture from the recolor list
+void releaseIndexedTexture(SDL_Texture* texture) {
+    for (auto it = gIndexedTextures.begin(); it != gIndexedTextures.end(); ++it) {
+        if (it->texture == texture) {
+            gIndexedStats.textures--;
+            gIndexedStats.indexedBytes -= indexedBytes(it->image.width, it->image.height);
+            gIndexedStats.rgbaBytes -= static_cast<size_t>(it->image.width) * it->image.height * 4;
+            gIndexedTextures.erase(it);
+            return;
+        }
+    }
+}
+
+void logSourceStats(const char* label, const AssetLoadStats& stats) {
+    std::cout << "  " << label << ": " << stats.loads << " loads";
+    if (stats.failures > 0) {
+        std::cout << " (" << stats.failures << " failed)";
+    }
+    if (stats.loads > 0) {
+        std::cout << ", " << stats.decodeMicros / 1000.0 << " ms decode ("
+                  << stats.decodeMicros / stats.loads << " us avg), "
+                  << stats.sourceBytes / 1024 << " KB source -> "
+                  << stats.pixelBytes / 1024 << " KB pixels";
+    }
+    std::cout << std::endl;
+}
+
+} // namespace
+
+void setAssetSource(AssetSource source) {
+    if (source == AssetSource::EMBEDDED && EMBEDDED_IMAGE_COUNT == 0) {
+        std::cerr << "No embedded assets in this build (configure with PIXELPETS_EMBEDDED_ASSETS), using PNG files" << std::endl;
+        source = AssetSource::PNG;
+    }
+    gAssetSource = source;
+}
+
+AssetSource getAssetSource() {
+    return gAssetSource;
+}
+
+bool parseAssetSourceArg(const std::string& value) {
+    if (value == "embedded") {
+        setAssetSource(AssetSource::EMBEDDED);
+    } else if (value == "png") {
+        setAssetSource(AssetSource::PNG);
+    } else {
+        std::cerr << "Unknown asset source '" << value << "' (expected embedded or png)" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+SDL_Texture* loadAssetTexture(SDL_Renderer* renderer, const char* path) {
+    Uint64 start = SDL_GetPerformanceCounter();
+
+    if (gGameboyMode) {
+        SDL_Texture* texture = loadIndexedTexture(renderer, path);
+        AssetLoadStats& stats = gAssetSource == AssetSource::EMBEDDED ? gEmbeddedStats : gPngStats;
+        int width = 0, height = 0;
+        if (texture) {
+            SDL_QueryTexture(texture, nullptr, nullptr, &width, &height);
+        }
+        recordLoad(stats, start, texture != nullptr, indexedBytes(width, height),
+                   static_cast<uint64_t>(width) * height * 4);
+        return texture;
+    }
+
+    if (gAssetSource == AssetSource::EMBEDDED) {
+        const EmbeddedImage* image = findEmbeddedImage(path);
+        if (image) {
+            SDL_Texture* texture = decodeEmbeddedTexture(renderer, *image);
+            recordLoad(gEmbeddedStats, start, texture != nullptr, embeddedImageBytes(*image),
+                       static_cast<uint64_t>(image->width) * image->height * 4);
+            return texture;
+        }
+    }
+
+    SDL_Texture* texture = loadTexture(renderer, path);
+    int width = 0, height = 0;
+    if (texture) {
+        SDL_QueryTexture(texture, nullptr, nullptr, &width, &height);
+    }
+    recordLoad(gPngStats, start, texture != nullptr, texture ? fileSize(path) : 0,
+               static_cast<uint64_t>(width) * height * 4);
+    return texture;
+}
+
+SDL_Surface* loadAssetSurface(const char* path) {
+    Uint64 start = SDL_GetPerformanceCounter();
+
+    if (gAssetSource == AssetSource::EMBEDDED) {
+        const EmbeddedImage* image = findEmbeddedImage(path);
+        if (image) {
+            SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(0, image->width, image->height, 32,
+                                                                  SDL_PIXELFORMAT_ARGB8888);
+            bool decoded = false;
+            if (surface) {
+                SDL_LockSurface(surface);
+                decoded = decodeEmbeddedParallel(*image, static_cast<uint32_t*>(surface->pixels), surface->pitch);
+                SDL_UnlockSurface(surface);
+            }
+            recordLoad(gEmbeddedStats, start, decoded, embeddedImageBytes(*image),
+                       static_cast<uint64_t>(image->width) * image->height * 4);
+            if (!decoded) {
+                std::cerr << "Unable to decode embedded image: " << image->name << std::endl;
+                SDL_FreeSurface(surface);
+                return nullptr;
+            }
+            return surface;
+        }
+    }
+
+    SDL_Surface* loaded = IMG_Load(path);
+    SDL_Surface* surface = loaded ? SDL_ConvertSurfaceFormat(loaded, SDL_PIXELFORMAT_ARGB8888, 0) : nullptr;
+    SDL_FreeSurface(loaded);
+    recordLoad(gPngStats, start, surface != nullptr, surface ? fileSize(path) : 0,
+               surface ? static_cast<uint64_t>(surface->w) * surface->h * 4 : 0);
+    if (!surface) {
+        std::cerr << "Unable to load image " << path << "! SDL_image Error: " << IMG_GetError() << std::endl;
+        return nullptr;
+    }
+    return surface;
+}
+
+std::string loadAssetText(const std::string& path) {
+    if (gAssetSource == AssetSource::EMBEDDED) {
+        const EmbeddedFile* file = findEmbeddedFile(path.c_str());
+        if (file) {
+            return std::string(reinterpret_cast<const char*>(file->data), file->size);
+        }
+    }
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return std::string();
+    }
+    return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+TTF_Font* openAssetFont(const std::string& path, int pointSize) {
+    if (gAssetSource == AssetSource::EMBEDDED) {
+        const EmbeddedFile* file = findEmbeddedFile(path.c_str());
+        if (file) {
+            SDL_RWops* rw = SDL_RWFromConstMem(file->data, static_cast<int>(file->size));
+            if (rw) {
+                // TTF_OpenFontRW closes the stream when freesrc is set
+                return TTF_OpenFontRW(rw, 1, pointSize);
+            }
+        }
+    }
+    return TTF_OpenFont(path.c_str(), pointSize);
+}
+
+void setGameboyMode(bool enabled) {
+    static bool releaseHandlerAdded = false;
+    if (enabled && !releaseHandlerAdded) {
+        releaseHandlerAdded = addTextureReleaseHandler(releaseIndexedTexture);
+    }
+    gGameboyMode = enabled;
+}
+
+bool isGameboyMode() {
+    return gGameboyMode;
+}
+
+void reserveIndexedTextures(size_t count) {
+    gIndexedTextures.reserve(gIndexedTextures.size() + count);
+}
+
+bool isQuantizedAtLoad(const char* path) {
+    if (!gGameboyMode) return false;
+    return gAssetSource != AssetSource::EMBEDDED || !findEmbeddedIndexedImage(path);
+}
+
+bool updateShadePalette(const ColorPalette& palette, WeatherType weather, DayNightType dayNight) {
+    if (!gGameboyMode || (gShadeLutValid && weather == gShadeWeather && dayNight == gShadeDayNight)) {
+        return false;
+    }
+
+    Uint64 start = SDL_GetPerformanceCounter();
+    buildShadeLuts(palette, weather, dayNight);
+
+    // Lock every texture here (SDL calls stay on the main thread) and
+    // expand them through the new LUTs on the job system
+    FrameVector<RecolorTarget> targets;
+    targets.reserve(gIndexedTextures.size());
+    for (const IndexedTexture& entry : gIndexedTextures) {
+        void* pixels = nullptr;
+        int pitch = 0;
+        if (SDL_LockTexture(entry.texture, nullptr, &pixels, &pitch) != 0) {
+            std::cerr << "Unable to lock indexed texture! SDL Error: " << SDL_GetError() << std::endl;
+            continue;
+        }
+        targets.push_back({&entry, static_cast<uint32_t*>(pixels), pitch});
+    }
+    JobCounter counter;
+    parallelFor(recolorJob, targets.data(), static_cast<int>(targets.size()), 1, counter);
+    waitForCounter(counter);
+    for (const RecolorTarget& target : targets) {
+        SDL_UnlockTexture(target.entry->texture);
+    }
+    gIndexedStats.recolors++;
+    gIndexedStats.recolorMicros += microsSince(start);
+    return true;
+}
+
+IndexedAssetStats getIndexedAssetStats() {
+    return gIndexedStats;
+}
+
+AssetLoadStats getAssetLoadStats(AssetSource source) {
+    std::lock_guard<std::mutex> lock(gLoadStatsMutex);
+    return source == AssetSource::EMBEDDED ? gEmbeddedStats : gPngStats;
+}
+
+void logAssetStats() {
+    size_t packedBytes = 0;
+    for (int i = 0; i < EMBEDDED_IMAGE_COUNT; i++) {
+        packedBytes += embeddedImageBytes(EMBEDDED_IMAGES[i]);
+    }
+    for (int i = 0; i < EMBEDDED_FILE_COUNT; i++) {
+        packedBytes += EMBEDDED_FILES[i].size;
+    }
+
+    std::cout << "=== Asset Loading ("
+              << (gAssetSource == AssetSource::EMBEDDED ? "embedded" : "png") << ") ===" << std::endl;
+    std::cout << "  Embedded in binary: " << EMBEDDED_IMAGE_COUNT << " images, "
+              << EMBEDDED_FILE_COUNT << " files, " << packedBytes / 1024 << " KB" << std::endl;
+    logSourceStats("Embedded", gEmbeddedStats);
+    logSourceStats("PNG", gPngStats);
+
+    if (gGameboyMode) {
+        std::cout << "  GameBoy mode: " << gIndexedStats.textures << " indexed images, "
+                  << gIndexedStats.indexedBytes / 1024 << " KB at 2bpp vs "
+                  << gIndexedStats.rgbaBytes / 1024 << " KB as RGBA" << std::endl;
+        if (gIndexedStats.recolors > 0) {
+            std::cout << "  Palette swaps: " << gIndexedStats.recolors << ", "
+                      << gIndexedStats.recolorMicros / gIndexedStats.recolors << " us avg" << std::endl;
+        }
+    }
+}
@@ -0,0 +1,172 @@
+#include <algorithm>
+#include <iostream>
+#include "../include/color_grade.h"
+#include "../include/job_system.h"
+
+namespace {
+
+// out = in * gain + lift, per channel
+struct Grade {
+    float gain[3];
+    float lift[3];
+};
+
+// Daytime look for each weather, indexed by WeatherType
+const Grade WEATHER_GRADES[] = {
+    {{1.00f, 1.00f, 1.00f}, { 0.0f,  0.0f,  0.0f}},  // Sunny
+    {{0.60f, 0.60f, 0.62f}, {20.0f, 20.0f, 24.0f}},  // Rainy: dark and flat
+    {{0.88f, 0.90f, 0.94f}, {14.0f, 14.0f, 16.0f}},  // Cloudy: washed out
+    {{1.00f, 1.02f, 1.00f}, { 8.0f,  8.0f,  4.0f}}   // Windy: a little brighter
+};
+
+// Applied on top of the weather grade at night
+const Grade NIGHT_GRADE = {{0.20f, 0.14f, 0.45f}, {0.0f, 0.0f, 6.0f}};
+
+const int GRADE_COUNT = 4 * (GRADE_TRANSITION_STEPS + 1);
+
+// Built lazily; static so grading never allocates after init
+GradeLut gLuts[GRADE_COUNT];
+bool gLutBuilt[GRADE_COUNT] = {};
+GradeStats gStats;
+
+float applyGrade(const Grade& grade, int channel, float value) {
+    return value * grade.gain[channel] + grade.lift[channel];
+}
+
+uint8_t clampChannel(float value) {
+    return static_cast<uint8_t>(std::min(255.0f, std::max(0.0f, value + 0.5f)));
+}
+
+void buildLut(const GradeKey& key, GradeLut& lut) {
+    const Grade& day = WEATHER_GRADES[static_cast<int>(key.weather)];
+    float t = static_cast<float>(key.step) / GRADE_TRANSITION_STEPS;
+    uint8_t* channels[3] = {lut.r, lut.g, lut.b};
+
+    for (int c = 0; c < 3; c++) {
+        for (int v = 0; v < 256; v++) {
+            float dayValue = applyGrade(day, c, static_cast<float>(v));
+            float nightValue = applyGrade(NIGHT_GRADE, c, dayValue);
+            channels[c][v] = clampChannel(dayValue + (nightValue - dayValue) * t);
+        }
+    }
+}
+
+} // namespace
+
+float nightAmount(int hour, int minute) {
+    int minutes = hour * 60 + minute;
+    if (minutes >= DUSK_START_MINUTE && minutes < DUSK_START_MINUTE + TRANSITION_MINUTES) {
+        return static_cast<float>(minutes - DUSK_START_MINUTE) / TRANSITION_MINUTES;
+    }
+    if (minutes >= DAWN_START_MINUTE && minutes < DAWN_START_MINUTE + TRANSITION_MINUTES) {
+        return 1.0f - static_cast<float>(minutes - DAWN_START_MINUTE) / TRANSITION_MINUTES;
+    }
+    bool day = minutes >= DAWN_START_MINUTE + TRANSITION_MINUTES && minutes < DUSK_START_MINUTE;
+    return day ? 0.0f : 1.0f;
+}
+
+GradeKey makeGradeKey(WeatherType weather, float nightAmount) {
+    GradeKey key;
+    key.weather = weather;
+    key.step = static_cast<int>(nightAmount * GRADE_TRANSITION_STEPS + 0.5f);
+    key.step = std::min(GRADE_TRANSITION_STEPS, std::max(0, key.step));
+    return key;
+}
+
+const GradeLut& gradeLut(const GradeKey& key) {
+    int index = key.index();
+    if (!gLutBuilt[index]) {
+        buildLut(key, gLuts[index]);
+        gLutBuilt[index] = true;
+        gStats.lutsBuilt++;
+    }
+    return gLuts[index];
+}
+
+SDL_Color gradeColor(const GradeLut& lut, const SDL_Color& color) {
+    return {lut.r[color.r], lut.g[color.g], lut.b[color.b], color.a};
+}
+
+void gradePixels(const GradeLut& lut, const uint32_t* src, int srcPitch,
+                 uint32_t* dst, int dstPitch, int width, int height) {
+    for (int y = 0; y < height; y++) {
+        const uint32_t* in = reinterpret_cast<const uint32_t*>(reinterpret_cast<const uint8_t*>(src) + y * srcPitch);
+        uint32_t* out = reinterpret_cast<uint32_t*>(reinterpret_cast<uint8_t*>(dst) + y * dstPitch);
+        for (int x = 0; x < width; x++) {
+            uint32_t p = in[x];
+            out[x] = (p & 0xFF000000u) |
+                     static_cast<uint32_t>(lut.r[(p >> 16) & 0xFF]) << 16 |
+                     static_cast<uint32_t>(lut.g[(p >> 8) & 0xFF]) << 8 |
+                     lut.b[p & 0xFF];
+        }
+    }
+}
+
+namespace {
+
+const int GRADE_ROWS_PER_JOB = 32;
+
+// One background's rows, graded in bands by the job system
+struct GradeRowsTask {
+    const GradeLut* lut;
+    const uint8_t* src;
+    int srcPitch;
+    uint8_t* dst;
+    int dstPitch;
+    int width;
+};
+
+void gradeRowsJob(void* data, int begin, int end) {
+    const GradeRowsTask* task = static_cast<const GradeRowsTask*>(data);
+    gradePixels(*task->lut, reinterpret_cast<const uint32_t*>(task->src + static_cast<size_t>(begin) * task->srcPitch),
+                task->srcPitch, reinterpret_cast<uint32_t*>(task->dst + static_cast<size_t>(begin) * task->dstPitch),
+                task->dstPitch, task->width, end - begin);
+}
+
+} // namespace
+
+int gradeBackgrounds(std::vector<Background>& backgrounds, const GradeKey& key) {
+    int updated = 0;
+    for (auto& bg : backgrounds) {
+        if (!bg.base || !bg.texture || bg.gradeIndex == key.index()) {
+            continue;
+        }
+
+        Uint64 start = SDL_GetPerformanceCounter();
+        void* pixels = nullptr;
+        int pitch = 0;
+        if (SDL_LockTexture(bg.texture, nullptr, &pixels, &pitch) != 0) {
+            std::cerr << "Unable to lock background " << bg.name << "! SDL Error: " << SDL_GetError() << std::endl;
+            continue;
+        }
+        // Locking stays on this thread; the rows are graded on the workers
+        SDL_LockSurface(bg.base);
+        GradeRowsTask task = {&gradeLut(key), static_cast<const uint8_t*>(bg.base->pixels), bg.base->pitch,
+                              static_cast<uint8_t*>(pixels), pitch, bg.width};
+        JobCounter counter;
+        parallelFor(gradeRowsJob, &task, bg.height, GRADE_ROWS_PER_JOB, counter);
+        waitForCounter(counter);
+        SDL_UnlockSurface(bg.base);
+        SDL_UnlockTexture(bg.texture);
+
+        bg.gradeIndex = key.index();
+        gStats.regrades++;
+        gStats.regradeMicros += (SDL_GetPerformanceCounter() - start) * 1000000.0 / SDL_GetPerformanceFrequency();
+        updated++;
+    }
+    return updated;
+}
+
+GradeStats getGradeStats() {
+    return gStats;
+}
+
+void logGradeStats() {
+    std::cout << "=== Colour Grading ===" << std::endl;
+    std::cout << "  LUTs built: " << gStats.lutsBuilt << " of " << GRADE_COUNT << std::endl;
+    std::cout << "  Background re-grades: " << gStats.regrades;
+    if (gStats.regrades > 0) {
+        std::cout << ", " << gStats.regradeMicros / gStats.regrades << " us avg";
+    }
+    std::cout << std::endl;
+}
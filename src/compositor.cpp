@@ -0,0 +1,118 @@
+#include <iostream>
+#include "../include/game.h"
+#include "../include/compositor.h"
+#include "../include/memory_tracker.h"
+
+namespace {
+
+struct Layer {
+    SDL_Texture* target = nullptr;
+    uint64_t key = 0;
+    bool valid = false;
+};
+
+Layer gLayers[static_cast<int>(LayerId::COUNT)];
+SDL_Texture* gPreviousTarget = nullptr;
+bool gDrawingLayer = false;
+CompositorStats gStats;
+
+Layer& layerFor(LayerId id) {
+    return gLayers[static_cast<int>(id)];
+}
+
+} // namespace
+
+bool initCompositor(SDL_Renderer* renderer) {
+    bool ok = true;
+    for (Layer& layer : gLayers) {
+        layer.target = trackTexture(SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET,
+                                                      SCREEN_WIDTH, SCREEN_HEIGHT), MemoryCategory::UI);
+        if (!layer.target) {
+            std::cerr << "Unable to create layer target! SDL Error: " << SDL_GetError() << std::endl;
+            ok = false;
+            continue;
+        }
+        SDL_SetTextureBlendMode(layer.target, SDL_BLENDMODE_BLEND);
+        layer.valid = false;
+    }
+    return ok;
+}
+
+void cleanupCompositor() {
+    for (Layer& layer : gLayers) {
+        if (layer.target) {
+            destroyTrackedTexture(layer.target);
+            layer.target = nullptr;
+        }
+        layer.valid = false;
+    }
+}
+
+bool beginLayer(SDL_Renderer* renderer, LayerId id, uint64_t key) {
+    Layer& layer = layerFor(id);
+    if (!layer.target) {
+        // No cache; the caller draws straight to the screen
+        return true;
+    }
+    if (layer.valid && layer.key == key) {
+        gStats.hits++;
+        return false;
+    }
+
+    gPreviousTarget = SDL_GetRenderTarget(renderer);
+    if (SDL_SetRenderTarget(renderer, layer.target) != 0) {
+        std::cerr << "Unable to draw into layer! SDL Error: " << SDL_GetError() << std::endl;
+        return true;
+    }
+    gDrawingLayer = true;
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+    SDL_RenderClear(renderer);
+
+    layer.key = key;
+    layer.valid = true;
+    gStats.redraws++;
+    return true;
+}
+
+void endLayer(SDL_Renderer* renderer) {
+    if (gDrawingLayer) {
+        SDL_SetRenderTarget(renderer, gPreviousTarget);
+        gDrawingLayer = false;
+    }
+}
+
+bool drawLayer(SDL_Renderer* renderer, LayerId id, int offsetX) {
+    Layer& layer = layerFor(id);
+    if (!layer.target || !layer.valid) {
+        return false;
+    }
+    if (offsetX == 0) {
+        return SDL_RenderCopy(renderer, layer.target, nullptr, nullptr) == 0;
+    }
+    SDL_Rect dst = {offsetX, 0, SCREEN_WIDTH, SCREEN_HEIGHT};
+    return SDL_RenderCopy(renderer, layer.target, nullptr, &dst) == 0;
+}
+
+bool layerHasTarget(LayerId id) {
+    return layerFor(id).target != nullptr;
+}
+
+void invalidateLayers() {
+    for (Layer& layer : gLayers) {
+        layer.valid = false;
+    }
+}
+
+CompositorStats getCompositorStats() {
+    return gStats;
+}
+
+void logCompositorStats() {
+    int frames = gStats.redraws + gStats.hits;
+    std::cout << "=== Layer Compositor ===" << std::endl;
+    std::cout << "  Layer redraws: " << gStats.redraws << ", cached: " << gStats.hits;
+    if (frames > 0) {
+        std::cout << " (" << (gStats.hits * 100 / frames) << "% hit rate)";
+    }
+    std::cout << std::endl;
+}
@@ -0,0 +1,90 @@
+#include <cstring>
+#include "../include/embedded_assets.h"
+
+#ifndef PIXELPETS_EMBEDDED_ASSETS
+// Nothing packed into this build; the generated tables replace these
+const EmbeddedImage* const EMBEDDED_IMAGES = nullptr;
+const int EMBEDDED_IMAGE_COUNT = 0;
+const EmbeddedFile* const EMBEDDED_FILES = nullptr;
+const int EMBEDDED_FILE_COUNT = 0;
+const EmbeddedIndexedImage* const EMBEDDED_INDEXED_IMAGES = nullptr;
+const int EMBEDDED_INDEXED_IMAGE_COUNT = 0;
+#endif
+
+const EmbeddedImage* findEmbeddedImage(const char* name) {
+    for (int i = 0; i < EMBEDDED_IMAGE_COUNT; i++) {
+        if (std::strcmp(EMBEDDED_IMAGES[i].name, name) == 0) {
+            return &EMBEDDED_IMAGES[i];
+        }
+    }
+    return nullptr;
+}
+
+const EmbeddedFile* findEmbeddedFile(const char* name) {
+    for (int i = 0; i < EMBEDDED_FILE_COUNT; i++) {
+        if (std::strcmp(EMBEDDED_FILES[i].name, name) == 0) {
+            return &EMBEDDED_FILES[i];
+        }
+    }
+    return nullptr;
+}
+
+const EmbeddedIndexedImage* findEmbeddedIndexedImage(const char* name) {
+    for (int i = 0; i < EMBEDDED_INDEXED_IMAGE_COUNT; i++) {
+        if (std::strcmp(EMBEDDED_INDEXED_IMAGES[i].name, name) == 0) {
+            return &EMBEDDED_INDEXED_IMAGES[i];
+        }
+    }
+    return nullptr;
+}
+
+size_t embeddedImageBytes(const EmbeddedImage& image) {
+    return image.paletteSize * sizeof(uint32_t) +
+           (image.height + 1) * sizeof(uint32_t) +
+           image.rowOffsets[image.height];
+}
+
+bool decodeEmbeddedRows(const EmbeddedImage& image, int firstRow, int rowCount,
+                        uint32_t* dst, int pitch) {
+    if (firstRow < 0 || rowCount < 0 || firstRow + rowCount > image.height) {
+        return false;
+    }
+
+    for (int y = firstRow; y < firstRow + rowCount; y++) {
+        const uint8_t* run = image.data + image.rowOffsets[y];
+        const uint8_t* end = image.data + image.rowOffsets[y + 1];
+        uint32_t* out = reinterpret_cast<uint32_t*>(reinterpret_cast<uint8_t*>(dst) + (y - firstRow) * pitch);
+        int x = 0;
+
+        while (run < end) {
+            int control = *run++;
+            if (control < RLE_LITERAL_FLAG) {
+                int count = control + 1;
+                if (run >= end || x + count > image.width || *run >= image.paletteSize) {
+                    return false;
+                }
+                uint32_t color = image.palette[*run++];
+                for (int i = 0; i < count; i++) {
+                    out[x + i] = color;
+                }
+                x += count;
+            } else {
+                int count = control - RLE_LITERAL_FLAG + 1;
+                if (run + count > end || x + count > image.width) {
+                    return false;
+                }
+                for (int i = 0; i < count; i++) {
+                    if (run[i] >= image.paletteSize) return false;
+                    out[x + i] = image.palette[run[i]];
+                }
+                run += count;
+                x += count;
+            }
+        }
+
+        if (x != image.width) {
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,151 @@
+#include <SDL2/SDL.h>
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include "../include/gesture.h"
+
+namespace {
+
+// Written by the thread that owns the recognizer (the simulation)
+GestureStats gStats;
+
+bool outsideSlop(int dx, int dy) {
+    return dx * dx + dy * dy > GESTURE_TOUCH_SLOP * GESTURE_TOUCH_SLOP;
+}
+
+void countGesture(GestureType type) {
+    switch (type) {
+        case GestureType::TAP:        gStats.taps++; break;
+        case GestureType::LONG_PRESS: gStats.longPresses++; break;
+        case GestureType::DRAG_END:   gStats.drags++; break;
+        case GestureType::FLING:      gStats.flings++; break;
+        default: break;
+    }
+}
+
+} // namespace
+
+Gesture GestureRecognizer::onEvent(const InputEvent& event) {
+    Uint64 start = SDL_GetPerformanceCounter();
+    Gesture gesture;
+
+    switch (event.type) {
+        case InputEventType::PRESS:
+            phase = Phase::PRESSED;
+            startX = lastX = event.x;
+            startY = lastY = event.y;
+            pressTime = event.timestamp;
+            historyCount = 0;
+            historyNext = 0;
+            addSample(event.x, event.y, event.timestamp);
+            break;
+
+        case InputEventType::MOTION:
+            if (phase != Phase::PRESSED && phase != Phase::DRAGGING) break;
+            lastX = event.x;
+            lastY = event.y;
+            addSample(event.x, event.y, event.timestamp);
+            if (phase == Phase::DRAGGING) {
+                gesture = make(GestureType::DRAG);
+            } else if (outsideSlop(lastX - startX, lastY - startY)) {
+                phase = Phase::DRAGGING;
+                gesture = make(GestureType::DRAG_START);
+            }
+            break;
+
+        case InputEventType::RELEASE:
+            lastX = event.x;
+            lastY = event.y;
+            addSample(event.x, event.y, event.timestamp);
+            if (phase == Phase::DRAGGING) {
+                gesture = make(GestureType::DRAG_END);
+                velocity(gesture.velocityX, gesture.velocityY);
+                float speed = std::max(std::abs(gesture.velocityX), std::abs(gesture.velocityY));
+                if (speed >= GESTURE_FLING_VELOCITY) {
+                    gesture.type = GestureType::FLING;
+                }
+            } else if (phase == Phase::PRESSED) {
+                // A release far from the press with no motion in between
+                // (a dropped or coalesced move) is still not a tap
+                if (!outsideSlop(lastX - startX, lastY - startY)) {
+                    gesture = make(GestureType::TAP);
+                }
+            }
+            phase = Phase::IDLE;
+            break;
+    }
+
+    countGesture(gesture.type);
+    double micros = (SDL_GetPerformanceCounter() - start) * 1000000.0 / SDL_GetPerformanceFrequency();
+    gStats.events++;
+    gStats.eventMicros += micros;
+    gStats.maxEventMicros = std::max(gStats.maxEventMicros, micros);
+    return gesture;
+}
+
+Gesture GestureRecognizer::poll(Uint32 now) {
+    if (phase != Phase::PRESSED || now - pressTime < GESTURE_LONG_PRESS_MS) {
+        return Gesture();
+    }
+    phase = Phase::HELD;
+    countGesture(GestureType::LONG_PRESS);
+    return make(GestureType::LONG_PRESS);
+}
+
+void GestureRecognizer::cancel() {
+    phase = Phase::IDLE;
+    historyCount = 0;
+}
+
+Gesture GestureRecognizer::make(GestureType type) const {
+    Gesture gesture;
+    gesture.type = type;
+    gesture.x = lastX;
+    gesture.y = lastY;
+    gesture.startX = startX;
+    gesture.startY = startY;
+    return gesture;
+}
+
+void GestureRecognizer::addSample(int16_t x, int16_t y, Uint32 time) {
+    history[historyNext] = {x, y, time};
+    historyNext = (historyNext + 1) % GESTURE_HISTORY;
+    historyCount = std::min(historyCount + 1, GESTURE_HISTORY);
+}
+
+// From the oldest sample inside the window to the newest. A pointer that
+// stopped before lifting has only the release left in the window, so its
+// velocity is zero.
+void GestureRecognizer::velocity(float& vx, float& vy) const {
+    vx = 0;
+    vy = 0;
+    if (historyCount < 2) return;
+
+    const Sample& newest = history[(historyNext + GESTURE_HISTORY - 1) % GESTURE_HISTORY];
+    const Sample* oldest = nullptr;
+    for (int i = 2; i <= historyCount; i++) {
+        const Sample& sample = history[(historyNext + GESTURE_HISTORY - i) % GESTURE_HISTORY];
+        if (newest.time - sample.time > GESTURE_VELOCITY_WINDOW_MS) break;
+        oldest = &sample;
+    }
+    if (!oldest) return;
+
+    // Events within the same millisecond still count as moving
+    float elapsed = static_cast<float>(std::max<Uint32>(1, newest.time - oldest->time));
+    vx = (newest.x - oldest->x) / elapsed;
+    vy = (newest.y - oldest->y) / elapsed;
+}
+
+GestureStats getGestureStats() {
+    return gStats;
+}
+
+void logGestureStats() {
+    std::cout << "=== Gestures ===" << std::endl;
+    std::cout << "  Taps: " << gStats.taps << ", long presses: " << gStats.longPresses
+              << ", drags: " << gStats.drags << ", flings: " << gStats.flings << std::endl;
+    if (gStats.events > 0) {
+        std::cout << "  Recognizer: " << gStats.eventMicros / gStats.events << " us avg, "
+                  << gStats.maxEventMicros << " us max per event" << std::endl;
+    }
+}
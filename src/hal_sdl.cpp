@@ -0,0 +1,188 @@
+#include <SDL2/SDL.h>
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include "../include/game.h"
+#include "../include/hal.h"
+#include "../include/memory_tracker.h"
+
+SDL_Rect canvasViewport(SDL_Renderer* renderer, int canvasWidth, int canvasHeight) {
+    int outputWidth = canvasWidth, outputHeight = canvasHeight;
+    SDL_GetRendererOutputSize(renderer, &outputWidth, &outputHeight);
+
+    int width, height;
+    int scale = std::min(outputWidth / canvasWidth, outputHeight / canvasHeight);
+    if (scale >= 1) {
+        width = canvasWidth * scale;
+        height = canvasHeight * scale;
+    } else if (outputWidth * canvasHeight < outputHeight * canvasWidth) {
+        width = outputWidth;
+        height = outputWidth * canvasHeight / canvasWidth;
+    } else {
+        width = outputHeight * canvasWidth / canvasHeight;
+        height = outputHeight;
+    }
+    return {(outputWidth - width) / 2, (outputHeight - height) / 2, width, height};
+}
+
+void windowPointToCanvas(SDL_Window* window, SDL_Renderer* renderer, int canvasWidth, int canvasHeight,
+                         int& x, int& y) {
+    int windowWidth = 0, windowHeight = 0;
+    int outputWidth = 0, outputHeight = 0;
+    SDL_GetWindowSize(window, &windowWidth, &windowHeight);
+    SDL_GetRendererOutputSize(renderer, &outputWidth, &outputHeight);
+    if (windowWidth <= 0 || windowHeight <= 0) return;
+
+    SDL_Rect viewport = canvasViewport(renderer, canvasWidth, canvasHeight);
+    if (viewport.w <= 0 || viewport.h <= 0) return;
+
+    // Window units -> output pixels -> canvas pixels. Points outside the
+    // canvas map to coordinates outside it, so they miss every button.
+    int outputX = x * outputWidth / windowWidth;
+    int outputY = y * outputHeight / windowHeight;
+    x = (outputX - viewport.x) * canvasWidth / viewport.w - (outputX < viewport.x ? 1 : 0);
+    y = (outputY - viewport.y) * canvasHeight / viewport.h - (outputY < viewport.y ? 1 : 0);
+}
+
+bool SdlDisplay::init(const std::string& title) {
+    // Create window, resizable and at full resolution on high-DPI screens
+    window = SDL_CreateWindow(
+        title.c_str(),
+        SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED,
+        SCREEN_WIDTH * windowScale, SCREEN_HEIGHT * windowScale,
+        SDL_WINDOW_SHOWN | SDL_WINDOW_RESIZABLE | SDL_WINDOW_ALLOW_HIGHDPI
+    );
+    if (!window) {
+        std::cerr << "Window could not be created! SDL_Error: " << SDL_GetError() << std::endl;
+        return false;
+    }
+
+    // Create renderer
+    renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_TARGETTEXTURE);
+    if (!renderer) {
+        std::cerr << "Renderer could not be created! SDL_Error: " << SDL_GetError() << std::endl;
+        SDL_DestroyWindow(window);
+        window = nullptr;
+        return false;
+    }
+
+    // Nearest-neighbour so the upscale keeps pixels square
+    SDL_SetHint(SDL_HINT_RENDER_SCALE_QUALITY, "0");
+
+    // The logical screen, at the device's resolution
+    canvas = trackTexture(SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET,
+                                            SCREEN_WIDTH, SCREEN_HEIGHT), MemoryCategory::UI);
+    if (!canvas) {
+        std::cerr << "Failed to create canvas: " << SDL_GetError() << std::endl;
+        shutdown();
+        return false;
+    }
+    SDL_SetTextureScaleMode(canvas, SDL_ScaleModeNearest);
+
+    return true;
+}
+
+void SdlDisplay::shutdown() {
+    if (canvas) {
+        destroyTrackedTexture(canvas);
+        canvas = nullptr;
+    }
+    if (renderer) {
+        SDL_DestroyRenderer(renderer);
+        renderer = nullptr;
+    }
+    if (window) {
+        SDL_DestroyWindow(window);
+        window = nullptr;
+    }
+}
+
+void SdlDisplay::beginFrame() {
+    SDL_SetRenderTarget(renderer, canvas);
+}
+
+void SdlDisplay::present() {
+    // One upscale of the finished canvas, letterboxed in black
+    SDL_Rect viewport = canvasViewport(renderer, SCREEN_WIDTH, SCREEN_HEIGHT);
+    SDL_SetRenderTarget(renderer, nullptr);
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+    SDL_RenderClear(renderer);
+    SDL_RenderCopy(renderer, canvas, nullptr, &viewport);
+    SDL_RenderPresent(renderer);
+}
+
+void SdlDisplay::windowToCanvas(int& x, int& y) const {
+    windowPointToCanvas(window, renderer, SCREEN_WIDTH, SCREEN_HEIGHT, x, y);
+}
+
+bool SdlInput::pollEvent(SDL_Event& event) {
+    if (SDL_PollEvent(&event) == 0) {
+        return false;
+    }
+
+    // Pointer events arrive in window coordinates
+    switch (event.type) {
+        case SDL_MOUSEBUTTONDOWN:
+        case SDL_MOUSEBUTTONUP:
+            display.windowToCanvas(event.button.x, event.button.y);
+            break;
+        case SDL_MOUSEMOTION:
+            display.windowToCanvas(event.motion.x, event.motion.y);
+            break;
+        default:
+            break;
+    }
+    return true;
+}
+
+std::unique_ptr<Display> createDisplay(int argc, char* args[]) {
+    std::string backend = "sdl";
+    int windowScale = PIXEL_SIZE;
+    SpiPanelConfig spiConfig;
+    spiConfig.width = SCREEN_WIDTH;
+    spiConfig.height = SCREEN_HEIGHT;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = args[i];
+        if (arg.compare(0, 10, "--display=") == 0) {
+            backend = arg.substr(10);
+        } else if (arg.compare(0, 15, "--window-scale=") == 0) {
+            int scale = std::atoi(arg.c_str() + 15);
+            if (scale >= 1) {
+                windowScale = scale;
+            } else {
+                std::cerr << "Invalid window scale: " << arg << std::endl;
+            }
+        } else if (arg.compare(0, 12, "--spi-clock=") == 0) {
+            double mhz = std::atof(arg.c_str() + 12);
+            if (mhz > 0) {
+                spiConfig.busClockHz = static_cast<uint32_t>(mhz * 1000000.0);
+            } else {
+                std::cerr << "Invalid SPI clock: " << arg << std::endl;
+            }
+        } else if (arg == "--spi-flush=full") {
+            spiConfig.flushMode = SpiFlushMode::FULL_FRAME;
+        } else if (arg == "--spi-flush=dirty") {
+            spiConfig.flushMode = SpiFlushMode::DIRTY_RECT;
+        } else if (arg.compare(0, 14, "--spi-buffers=") == 0) {
+            int count = std::atoi(arg.c_str() + 14);
+            if (count >= 1 && count <= 3) {
+                spiConfig.bufferCount = count;
+            } else {
+                std::cerr << "SPI buffer count must be 1, 2 or 3: " << arg << std::endl;
+            }
+        } else if (arg == "--spi-no-throttle") {
+            spiConfig.throttle = false;
+        }
+    }
+
+    spiConfig.windowScale = windowScale;
+
+    if (backend == "spi") {
+        return std::unique_ptr<Display>(new SimulatedSpiDisplay(spiConfig));
+    }
+    if (backend != "sdl") {
+        std::cerr << "Unknown display backend '" << backend << "', using sdl" << std::endl;
+    }
+    return std::unique_ptr<Display>(new SdlDisplay(windowScale));
+}
@@ -0,0 +1,319 @@
+#include <SDL2/SDL.h>
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include "../include/hal.h"
+#include "../include/memory_tracker.h"
+
+// Interval between statistics printouts
+const Uint32 SPI_STATS_INTERVAL = 5000;
+
+// Convert an ARGB8888 pixel to the panel's RGB565
+static inline uint16_t toRgb565(uint32_t argb) {
+    return static_cast<uint16_t>(((argb >> 8) & 0xF800) | ((argb >> 5) & 0x07E0) | ((argb >> 3) & 0x001F));
+}
+
+SimulatedSpiDisplay::SimulatedSpiDisplay(const SpiPanelConfig& config) : config(config) {
+}
+
+bool SimulatedSpiDisplay::init(const std::string& title) {
+    int pixels = config.width * config.height;
+    readback.resize(pixels);
+    gram.assign(pixels, 0);
+    gramVersion = 1;
+    shownGramVersion = 0;
+    lastSubmitted = -1;
+
+    buffers.assign(std::max(1, config.bufferCount), PanelBuffer());
+    freeBuffers.clear();
+    queuedBuffers.clear();
+    for (size_t i = 0; i < buffers.size(); i++) {
+        buffers[i].pixels.assign(pixels, 0);
+        freeBuffers.push(static_cast<int>(i));
+    }
+
+    // Preview window shows the panel at an integer scale
+    window = SDL_CreateWindow(
+        (title + " [SPI " + std::to_string(config.busClockHz / 1000000) + " MHz]").c_str(),
+        SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED,
+        config.width * config.windowScale, config.height * config.windowScale,
+        SDL_WINDOW_SHOWN | SDL_WINDOW_RESIZABLE | SDL_WINDOW_ALLOW_HIGHDPI
+    );
+    if (!window) {
+        std::cerr << "Window could not be created! SDL_Error: " << SDL_GetError() << std::endl;
+        return false;
+    }
+
+    renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_TARGETTEXTURE);
+    if (!renderer) {
+        std::cerr << "Renderer could not be created! SDL_Error: " << SDL_GetError() << std::endl;
+        shutdown();
+        return false;
+    }
+
+    // Nearest-neighbour so the preview shows individual panel pixels
+    SDL_SetHint(SDL_HINT_RENDER_SCALE_QUALITY, "0");
+
+    canvas = trackTexture(SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET,
+                                            config.width, config.height), MemoryCategory::UI);
+    preview = trackTexture(SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGB565, SDL_TEXTUREACCESS_STREAMING,
+                                             config.width, config.height), MemoryCategory::UI);
+    if (!canvas || !preview) {
+        std::cerr << "Failed to create SPI panel textures: " << SDL_GetError() << std::endl;
+        shutdown();
+        return false;
+    }
+
+    // The flush thread plays the part of the DMA engine
+    if (buffers.size() > 1) {
+        stopFlushThread = false;
+        flushThread = std::thread(&SimulatedSpiDisplay::flushThreadMain, this);
+    }
+
+    lastStatsLog = SDL_GetTicks();
+    return true;
+}
+
+void SimulatedSpiDisplay::shutdown() {
+    if (flushThread.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(flushMutex);
+            stopFlushThread = true;
+        }
+        flushCv.notify_all();
+        flushThread.join();
+    }
+    if (canvas) {
+        destroyTrackedTexture(canvas);
+        canvas = nullptr;
+    }
+    if (preview) {
+        destroyTrackedTexture(preview);
+        preview = nullptr;
+    }
+    if (renderer) {
+        SDL_DestroyRenderer(renderer);
+        renderer = nullptr;
+    }
+    if (window) {
+        SDL_DestroyWindow(window);
+        window = nullptr;
+    }
+}
+
+void SimulatedSpiDisplay::beginFrame() {
+    SDL_SetRenderTarget(renderer, canvas);
+}
+
+void SimulatedSpiDisplay::present() {
+    Uint64 presentStart = SDL_GetPerformanceCounter();
+    bool async = buffers.size() > 1;
+
+    // Read back the finished canvas
+    SDL_SetRenderTarget(renderer, canvas);
+    if (SDL_RenderReadPixels(renderer, nullptr, SDL_PIXELFORMAT_ARGB8888,
+                             readback.data(), config.width * 4) != 0) {
+        std::cerr << "Failed to read back SPI canvas: " << SDL_GetError() << std::endl;
+        return;
+    }
+
+    // Wait on the fence until the flush thread has released a buffer
+    int index = 0;
+    if (async) {
+        std::unique_lock<std::mutex> lock(flushMutex);
+        Uint64 waitStart = SDL_GetPerformanceCounter();
+        flushCv.wait(lock, [this] { return !freeBuffers.empty(); });
+        stats.stallMicrosTotal += (SDL_GetPerformanceCounter() - waitStart) * 1000000.0 /
+                                  SDL_GetPerformanceFrequency();
+        index = freeBuffers.pop();
+    }
+
+    // Convert into the buffer and find what changed since the previous frame.
+    // In blocking mode the previous frame is GRAM itself; otherwise it is the
+    // last submitted buffer, which nobody writes while we fill this one.
+    PanelBuffer& buffer = buffers[index];
+    for (size_t i = 0; i < readback.size(); i++) {
+        buffer.pixels[i] = toRgb565(readback[i]);
+    }
+    computeFlushWindow(buffer, async && lastSubmitted >= 0 ? buffers[lastSubmitted].pixels : gram);
+    buffer.submitTime = presentStart;
+    lastSubmitted = index;
+
+    if (async) {
+        {
+            std::lock_guard<std::mutex> lock(flushMutex);
+            queuedBuffers.push(index);
+            stats.frames++;
+        }
+        flushCv.notify_all();
+    } else {
+        {
+            std::lock_guard<std::mutex> lock(flushMutex);
+            stats.frames++;
+        }
+        transferBuffer(buffer);
+    }
+
+    showGram();
+
+    Uint32 now = SDL_GetTicks();
+    if (now - lastStatsLog >= SPI_STATS_INTERVAL) {
+        logStats();
+        lastStatsLog = now;
+    }
+}
+
+void SimulatedSpiDisplay::computeFlushWindow(PanelBuffer& buffer, const std::vector<uint16_t>& previous) {
+    buffer.x0 = 0;
+    buffer.y0 = 0;
+    buffer.x1 = config.width - 1;
+    buffer.y1 = config.height - 1;
+    if (config.flushMode != SpiFlushMode::DIRTY_RECT || lastSubmitted < 0) {
+        return;
+    }
+
+    int x0 = config.width, y0 = config.height, x1 = -1, y1 = -1;
+    for (int y = 0; y < config.height; y++) {
+        const uint16_t* src = &buffer.pixels[y * config.width];
+        const uint16_t* dst = &previous[y * config.width];
+        for (int x = 0; x < config.width; x++) {
+            if (src[x] != dst[x]) {
+                x0 = std::min(x0, x);
+                x1 = std::max(x1, x);
+                y0 = std::min(y0, y);
+                y1 = std::max(y1, y);
+            }
+        }
+    }
+
+    // Widen the window to the controller's column alignment
+    if (x1 >= 0 && config.columnAlignment > 1) {
+        x0 -= x0 % config.columnAlignment;
+        x1 = std::min(config.width - 1, x1 + (config.columnAlignment - 1 - x1 % config.columnAlignment));
+    }
+
+    buffer.x0 = x0;
+    buffer.y0 = y0;
+    buffer.x1 = x1;
+    buffer.y1 = y1;
+}
+
+void SimulatedSpiDisplay::transferBuffer(PanelBuffer& buffer) {
+    double micros = 0;
+    if (buffer.x1 >= 0) {
+        micros = pushWindow(buffer.x0, buffer.y0, buffer.x1, buffer.y1,
+                            &buffer.pixels[buffer.y0 * config.width + buffer.x0], config.width);
+    }
+
+    // Hold the bus for as long as the transfer would take on the device
+    if (config.throttle && micros > 0) {
+        std::this_thread::sleep_for(std::chrono::microseconds(static_cast<long long>(micros)));
+    }
+
+    double latency = (SDL_GetPerformanceCounter() - buffer.submitTime) * 1000000.0 /
+                     SDL_GetPerformanceFrequency();
+    std::lock_guard<std::mutex> lock(flushMutex);
+    stats.latencyMicrosTotal += latency;
+    stats.latencyMicrosMax = std::max(stats.latencyMicrosMax, latency);
+}
+
+void SimulatedSpiDisplay::flushThreadMain() {
+    std::unique_lock<std::mutex> lock(flushMutex);
+    while (true) {
+        flushCv.wait(lock, [this] { return stopFlushThread || !queuedBuffers.empty(); });
+        if (queuedBuffers.empty()) {
+            break;  // Stop requested and nothing left in flight
+        }
+
+        int index = queuedBuffers.pop();
+
+        lock.unlock();
+        transferBuffer(buffers[index]);
+        lock.lock();
+
+        // Signal the fence: the renderer may reuse this buffer
+        freeBuffers.push(index);
+        flushCv.notify_all();
+    }
+}
+
+double SimulatedSpiDisplay::pushWindow(int x0, int y0, int x1, int y1, const uint16_t* pixels, int stride) {
+    x0 = std::max(0, x0);
+    y0 = std::max(0, y0);
+    x1 = std::min(config.width - 1, x1);
+    y1 = std::min(config.height - 1, y1);
+    if (x1 < x0 || y1 < y0) return 0;
+
+    int w = x1 - x0 + 1;
+    int h = y1 - y0 + 1;
+
+    // CASET and RASET take one command byte and four parameter bytes each,
+    // RAMWR one command byte followed by the pixel payload
+    const uint64_t commandBytes = (1 + 4) + (1 + 4) + 1;
+    uint64_t pixelBytes = static_cast<uint64_t>(w) * h * 2;
+    double micros = transferMicros(commandBytes + pixelBytes);
+
+    std::lock_guard<std::mutex> lock(flushMutex);
+
+    // RAMWR streams the window row by row into GRAM
+    for (int row = 0; row < h; row++) {
+        std::copy(pixels + row * stride, pixels + row * stride + w, &gram[(y0 + row) * config.width + x0]);
+    }
+    gramVersion++;
+
+    stats.windows++;
+    stats.commandBytes += commandBytes;
+    stats.pixelBytes += pixelBytes;
+    stats.transferMicros += micros;
+    return micros;
+}
+
+SpiBusStats SimulatedSpiDisplay::getStats() const {
+    std::lock_guard<std::mutex> lock(flushMutex);
+    return stats;
+}
+
+void SimulatedSpiDisplay::windowToCanvas(int& x, int& y) const {
+    windowPointToCanvas(window, renderer, config.width, config.height, x, y);
+}
+
+void SimulatedSpiDisplay::logStats() const {
+    SpiBusStats snapshot = getStats();
+    if (snapshot.frames == 0) return;
+
+    double bytesPerFrame = static_cast<double>(snapshot.commandBytes + snapshot.pixelBytes) / snapshot.frames;
+    double microsPerFrame = snapshot.transferMicros / snapshot.frames;
+    std::cout << "SPI " << config.busClockHz / 1000000 << " MHz ("
+              << (config.flushMode == SpiFlushMode::DIRTY_RECT ? "dirty rect" : "full frame") << ", "
+              << buffers.size() << (buffers.size() > 1 ? " buffers" : " buffer, blocking") << "): "
+              << snapshot.frames << " frames, " << snapshot.windows << " windows, "
+              << static_cast<int>(bytesPerFrame / 1024) << " KB/frame, "
+              << static_cast<int>(microsPerFrame) << " us/frame on the bus ("
+              << static_cast<int>(microsPerFrame / 16667.0 * 100.0) << "% of a 60 Hz frame)" << std::endl;
+    std::cout << "SPI present latency: avg " << static_cast<int>(snapshot.latencyMicrosTotal / snapshot.frames)
+              << " us, max " << static_cast<int>(snapshot.latencyMicrosMax)
+              << " us; render stalled " << static_cast<int>(snapshot.stallMicrosTotal / snapshot.frames)
+              << " us/frame waiting for a buffer" << std::endl;
+}
+
+double SimulatedSpiDisplay::transferMicros(uint64_t bytes) const {
+    return static_cast<double>(bytes) * 8.0 * 1000000.0 / config.busClockHz;
+}
+
+void SimulatedSpiDisplay::showGram() {
+    {
+        // Only upload GRAM when the flush thread has changed it
+        std::lock_guard<std::mutex> lock(flushMutex);
+        if (gramVersion != shownGramVersion) {
+            SDL_UpdateTexture(preview, nullptr, gram.data(), config.width * 2);
+            shownGramVersion = gramVersion;
+        }
+    }
+    SDL_Rect viewport = canvasViewport(renderer, config.width, config.height);
+    SDL_SetRenderTarget(renderer, nullptr);
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+    SDL_RenderClear(renderer);
+    SDL_RenderCopy(renderer, preview, nullptr, &viewport);
+    SDL_RenderPresent(renderer);
+}
@@ -0,0 +1,82 @@
+#include <algorithm>
+#include "../include/indexed_sprite.h"
+
+namespace {
+
+// 4x4 Bayer threshold matrix
+const int BAYER_4X4[4][4] = {
+    { 0,  8,  2, 10},
+    {12,  4, 14,  6},
+    { 3, 11,  1,  9},
+    {15,  7, 13,  5}
+};
+
+const uint32_t* pixelRow(const uint32_t* argb, int pitch, int y) {
+    return reinterpret_cast<const uint32_t*>(reinterpret_cast<const uint8_t*>(argb) + y * pitch);
+}
+
+// Rec. 601 luma in 0..255
+int luminance(uint32_t argb) {
+    int r = (argb >> 16) & 0xFF;
+    int g = (argb >> 8) & 0xFF;
+    int b = argb & 0xFF;
+    return (r * 299 + g * 587 + b * 114) / 1000;
+}
+
+} // namespace
+
+bool hasTransparency(const uint32_t* argb, int width, int height, int pitch) {
+    for (int y = 0; y < height; y++) {
+        const uint32_t* row = pixelRow(argb, pitch, y);
+        for (int x = 0; x < width; x++) {
+            if ((row[x] >> 24) < 128) return true;
+        }
+    }
+    return false;
+}
+
+void quantizeToShades(const uint32_t* argb, int width, int height, int pitch,
+                      bool transparent, std::vector<uint8_t>& out) {
+    // Transparent images spend index 0 on transparency and keep 3 shades
+    const int levels = transparent ? SHADE_COUNT - 1 : SHADE_COUNT;
+    const int firstShade = transparent ? 1 : 0;
+    const int stride = indexedStride(width);
+
+    out.assign(indexedBytes(width, height), 0);
+    for (int y = 0; y < height; y++) {
+        const uint32_t* row = pixelRow(argb, pitch, y);
+        uint8_t* packed = &out[static_cast<size_t>(y) * stride];
+        for (int x = 0; x < width; x++) {
+            int index = 0;
+            if (!transparent || (row[x] >> 24) >= 128) {
+                // Spread the luminance over the levels and let the threshold
+                // matrix decide which neighbouring level each pixel rounds to
+                int scaled = luminance(row[x]) * (levels - 1) * 16 / 255;
+                int level = (scaled + BAYER_4X4[y & 3][x & 3]) / 16;
+                index = firstShade + std::min(level, levels - 1);
+            }
+            packed[x >> 2] |= static_cast<uint8_t>(index << (6 - 2 * (x & 3)));
+        }
+    }
+}
+
+void expandIndexedRows(const IndexedImage& image, const ShadeLut& lut, int firstRow, int rowCount,
+                       uint32_t* dst, int pitch) {
+    const int stride = indexedStride(image.width);
+    for (int y = firstRow; y < firstRow + rowCount; y++) {
+        const uint8_t* packed = image.pixels + static_cast<size_t>(y) * stride;
+        uint32_t* out = reinterpret_cast<uint32_t*>(reinterpret_cast<uint8_t*>(dst) + (y - firstRow) * pitch);
+        int x = 0;
+        // Four pixels per byte
+        for (; x + 4 <= image.width; x += 4) {
+            uint8_t bits = packed[x >> 2];
+            out[x] = lut[bits >> 6];
+            out[x + 1] = lut[(bits >> 4) & 3];
+            out[x + 2] = lut[(bits >> 2) & 3];
+            out[x + 3] = lut[bits & 3];
+        }
+        for (; x < image.width; x++) {
+            out[x] = lut[(packed[x >> 2] >> (6 - 2 * (x & 3))) & 3];
+        }
+    }
+}
@@ -0,0 +1,305 @@
+#include <SDL2/SDL.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <vector>
+#include "../include/input_queue.h"
+#include "../include/assets.h"
+#include "../include/hal.h"
+#include "../include/latency_probe.h"
+
+namespace {
+
+InputRing gRing;
+const Display* gDisplay = nullptr;
+SDL_sem* gInputReady = nullptr;
+bool gPressed = false;   // Producer side; motion is only queued during a press
+uint32_t gNextId = 1;
+
+// Events waiting for room in the ring, oldest first (producer side)
+InputEvent gBacklog[INPUT_BACKLOG_CAPACITY];
+int gBacklogCount = 0;
+
+struct ReplayEvent {
+    Uint32 atMs;
+    InputEventType type;
+    int16_t x;
+    int16_t y;
+};
+
+std::vector<ReplayEvent> gReplay;
+size_t gReplayNext = 0;
+Uint32 gReplayStart = 0;
+bool gReplayStarted = false;
+
+// Written by the producer
+long long gEvents = 0;
+long long gDropped = 0;
+long long gCoalesced = 0;
+int gMaxDepth = 0;
+int gMaxBacklog = 0;
+
+// Written by the consumer
+long long gHandled = 0;
+double gQueueMicros = 0;
+double gMaxQueueMicros = 0;
+double gEventAgeMs = 0;
+Uint32 gMaxEventAgeMs = 0;
+
+void queueEvent(const InputEvent& event) {
+    gRing.push(event);
+    latencyInputQueued(event.id, event.queuedAt);
+    gMaxDepth = std::max(gMaxDepth, gRing.size());
+}
+
+int freeSlots() {
+    return INPUT_QUEUE_CAPACITY - gRing.size();
+}
+
+// Moves only take a slot while enough are left for presses and releases
+bool roomFor(const InputEvent& event) {
+    int reserve = event.type == InputEventType::MOTION ? INPUT_QUEUE_MOTION_RESERVE : 0;
+    return freeSlots() > reserve;
+}
+
+// Move held-back events into the ring, oldest first; returns how many moved
+int drainBacklog() {
+    int moved = 0;
+    while (moved < gBacklogCount && roomFor(gBacklog[moved])) {
+        queueEvent(gBacklog[moved]);
+        moved++;
+    }
+    if (moved > 0) {
+        std::copy(gBacklog + moved, gBacklog + gBacklogCount, gBacklog);
+        gBacklogCount -= moved;
+    }
+    return moved;
+}
+
+// Runs inside SDL_PumpEvents on the main thread, as each event is queued.
+// The event still goes on to SDL's queue, so it must not be modified.
+int SDLCALL inputEventWatch(void* userdata, SDL_Event* event) {
+    InputEvent input;
+    int x = 0, y = 0;
+    switch (event->type) {
+        case SDL_MOUSEBUTTONDOWN:
+            input.type = InputEventType::PRESS;
+            x = event->button.x;
+            y = event->button.y;
+            gPressed = true;
+            break;
+        case SDL_MOUSEBUTTONUP:
+            input.type = InputEventType::RELEASE;
+            x = event->button.x;
+            y = event->button.y;
+            gPressed = false;
+            break;
+        case SDL_MOUSEMOTION:
+            if (!gPressed) return 0;
+            input.type = InputEventType::MOTION;
+            x = event->motion.x;
+            y = event->motion.y;
+            break;
+        default:
+            return 0;
+    }
+
+    if (gDisplay) {
+        gDisplay->windowToCanvas(x, y);
+    }
+    input.x = static_cast<int16_t>(x);
+    input.y = static_cast<int16_t>(y);
+    input.timestamp = event->common.timestamp;
+    pushInputEvent(input);
+    return 0;
+}
+
+} // namespace
+
+bool initInputQueue(const Display& display) {
+    gDisplay = &display;
+    gInputReady = SDL_CreateSemaphore(0);
+    if (!gInputReady) {
+        std::cerr << "Unable to create input semaphore! SDL Error: " << SDL_GetError() << std::endl;
+        return false;
+    }
+    SDL_AddEventWatch(inputEventWatch, nullptr);
+    return true;
+}
+
+void shutdownInputQueue() {
+    SDL_DelEventWatch(inputEventWatch, nullptr);
+    if (gInputReady) {
+        SDL_DestroySemaphore(gInputReady);
+        gInputReady = nullptr;
+    }
+    gDisplay = nullptr;
+}
+
+bool pushInputEvent(const InputEvent& event) {
+    InputEvent stamped = event;
+    stamped.queuedAt = SDL_GetPerformanceCounter();
+    stamped.id = gNextId++;
+    gEvents++;
+
+    drainBacklog();
+    if (gBacklogCount == 0 && roomFor(stamped)) {
+        queueEvent(stamped);
+    } else if (stamped.type == InputEventType::MOTION && gBacklogCount > 0 &&
+               gBacklog[gBacklogCount - 1].type == InputEventType::MOTION) {
+        // Only the latest position of a run of moves matters
+        gBacklog[gBacklogCount - 1] = stamped;
+        gCoalesced++;
+    } else if (gBacklogCount < INPUT_BACKLOG_CAPACITY) {
+        gBacklog[gBacklogCount++] = stamped;
+        gMaxBacklog = std::max(gMaxBacklog, gBacklogCount);
+    } else {
+        gDropped++;
+        return false;
+    }
+
+    if (gInputReady) {
+        SDL_SemPost(gInputReady);
+    }
+    return true;
+}
+
+void flushInputEvents() {
+    if (gBacklogCount > 0 && drainBacklog() > 0 && gInputReady) {
+        SDL_SemPost(gInputReady);
+    }
+}
+
+bool popInputEvent(InputEvent& event) {
+    return gRing.pop(event);
+}
+
+void inputEventHandled(const InputEvent& event) {
+    double micros = (SDL_GetPerformanceCounter() - event.queuedAt) * 1000000.0 / SDL_GetPerformanceFrequency();
+    Uint32 age = SDL_GetTicks() - event.timestamp;
+    gHandled++;
+    gQueueMicros += micros;
+    gMaxQueueMicros = std::max(gMaxQueueMicros, micros);
+    gEventAgeMs += age;
+    gMaxEventAgeMs = std::max(gMaxEventAgeMs, age);
+}
+
+void waitForInput(Uint32 timeoutMs) {
+    if (!gInputReady) {
+        SDL_Delay(timeoutMs);
+        return;
+    }
+    if (SDL_SemWaitTimeout(gInputReady, timeoutMs) == 0) {
+        // One wake covers every event queued so far
+        while (SDL_SemTryWait(gInputReady) == 0) {
+        }
+    }
+}
+
+void pumpInputEvents() {
+    SDL_PumpEvents();
+}
+
+bool loadInputReplay(const std::string& path) {
+    std::string text = loadAssetText(path);
+    if (text.empty()) {
+        std::cerr << "Input replay " << path << " is missing or empty" << std::endl;
+        return false;
+    }
+
+    gReplay.clear();
+    size_t start = 0;
+    int lineNumber = 0;
+    while (start < text.size()) {
+        size_t end = text.find('\n', start);
+        if (end == std::string::npos) end = text.size();
+        std::string line = text.substr(start, end - start);
+        start = end + 1;
+        lineNumber++;
+        if (line.empty() || line[0] == '#' || line[0] == '\r') continue;
+
+        unsigned atMs = 0;
+        char kind[16] = {};
+        int x = 0, y = 0;
+        if (std::sscanf(line.c_str(), "%u %15s %d %d", &atMs, kind, &x, &y) != 4) {
+            std::cerr << path << ":" << lineNumber << ": invalid replay event, skipped" << std::endl;
+            continue;
+        }
+        ReplayEvent event = {atMs, InputEventType::PRESS, static_cast<int16_t>(x), static_cast<int16_t>(y)};
+        if (std::strcmp(kind, "tap") == 0 || std::strcmp(kind, "press") == 0) {
+            gReplay.push_back(event);
+            if (std::strcmp(kind, "tap") == 0) {
+                event.type = InputEventType::RELEASE;
+                gReplay.push_back(event);
+            }
+        } else if (std::strcmp(kind, "release") == 0) {
+            event.type = InputEventType::RELEASE;
+            gReplay.push_back(event);
+        } else if (std::strcmp(kind, "move") == 0) {
+            event.type = InputEventType::MOTION;
+            gReplay.push_back(event);
+        } else {
+            std::cerr << path << ":" << lineNumber << ": unknown replay event '" << kind << "', skipped" << std::endl;
+        }
+    }
+    std::stable_sort(gReplay.begin(), gReplay.end(),
+                     [](const ReplayEvent& a, const ReplayEvent& b) { return a.atMs < b.atMs; });
+    gReplayNext = 0;
+    gReplayStarted = false;
+    return !gReplay.empty();
+}
+
+void pumpInputReplay() {
+    if (gReplay.empty()) return;
+    Uint32 now = SDL_GetTicks();
+    if (!gReplayStarted) {
+        gReplayStart = now;
+        gReplayStarted = true;
+    }
+    // A full backlog leaves the rest for the next call
+    while (gReplayNext < gReplay.size() && now - gReplayStart >= gReplay[gReplayNext].atMs) {
+        const ReplayEvent& replay = gReplay[gReplayNext];
+        InputEvent event;
+        event.type = replay.type;
+        event.x = replay.x;
+        event.y = replay.y;
+        event.timestamp = now;
+        if (!pushInputEvent(event)) break;
+        gReplayNext++;
+    }
+}
+
+bool inputReplayFinished() {
+    if (gReplay.empty() || !gReplayStarted || gReplayNext < gReplay.size()) return false;
+    return SDL_GetTicks() - gReplayStart >= gReplay.back().atMs + INPUT_REPLAY_SETTLE_MS;
+}
+
+InputQueueStats getInputQueueStats() {
+    InputQueueStats stats;
+    stats.events = gEvents;
+    stats.dropped = gDropped;
+    stats.coalesced = gCoalesced;
+    stats.maxBacklog = gMaxBacklog;
+    stats.maxDepth = gMaxDepth;
+    stats.handled = gHandled;
+    stats.queueMicros = gQueueMicros;
+    stats.maxQueueMicros = gMaxQueueMicros;
+    stats.eventAgeMs = gEventAgeMs;
+    stats.maxEventAgeMs = gMaxEventAgeMs;
+    return stats;
+}
+
+void logInputQueueStats() {
+    InputQueueStats stats = getInputQueueStats();
+    std::cout << "=== Input Queue ===" << std::endl;
+    std::cout << "  Events: " << stats.events << " (" << stats.coalesced << " moves coalesced, "
+              << stats.dropped << " dropped), max depth " << stats.maxDepth << " of " << INPUT_QUEUE_CAPACITY
+              << ", max held back " << stats.maxBacklog << std::endl;
+    if (stats.handled > 0) {
+        std::cout << "  Queue to handler: " << stats.queueMicros / stats.handled << " us avg, "
+                  << stats.maxQueueMicros << " us max; pump to handler: "
+                  << stats.eventAgeMs / stats.handled << " ms avg, " << stats.maxEventAgeMs << " ms max"
+                  << std::endl;
+    }
+}
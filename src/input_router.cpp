@@ -0,0 +1,104 @@
+#include <algorithm>
+#include <iostream>
+#include "../include/input_router.h"
+
+namespace {
+
+struct ScreenInput {
+    HitGrid grid;
+    TapHandler handler = nullptr;
+};
+
+ScreenInput gScreens[GAME_STATE_COUNT];
+InputStats gStats;
+
+bool rectContains(const SDL_Rect& rect, int x, int y) {
+    return x >= rect.x && x < rect.x + rect.w &&
+           y >= rect.y && y < rect.y + rect.h;
+}
+
+} // namespace
+
+void HitGrid::clear() {
+    count = 0;
+    std::fill(std::begin(cells), std::end(cells), 0u);
+}
+
+bool HitGrid::add(const SDL_Rect& rect, const HitTarget& target) {
+    if (count >= MAX_HIT_REGIONS) {
+        std::cerr << "Hit grid full, dropping region" << std::endl;
+        return false;
+    }
+    int region = count++;
+    rects[region] = rect;
+    targets[region] = target;
+
+    // Mark every cell the rect touches, clipped to the screen
+    int firstCol = std::max(0, rect.x / HIT_GRID_CELL);
+    int lastCol = std::min(HIT_GRID_COLS - 1, (rect.x + rect.w - 1) / HIT_GRID_CELL);
+    int firstRow = std::max(0, rect.y / HIT_GRID_CELL);
+    int lastRow = std::min(HIT_GRID_ROWS - 1, (rect.y + rect.h - 1) / HIT_GRID_CELL);
+    for (int row = firstRow; row <= lastRow; row++) {
+        for (int col = firstCol; col <= lastCol; col++) {
+            cells[row * HIT_GRID_COLS + col] |= 1u << region;
+        }
+    }
+    return true;
+}
+
+HitTarget HitGrid::hitTest(int x, int y) const {
+    if (x < 0 || y < 0 || x >= SCREEN_WIDTH || y >= SCREEN_HEIGHT) {
+        return HitTarget();
+    }
+
+    // Newest region first, so later regions sit on top
+    uint32_t mask = cells[(y / HIT_GRID_CELL) * HIT_GRID_COLS + x / HIT_GRID_CELL];
+    while (mask) {
+        int region = 31 - __builtin_clz(mask);
+        mask &= ~(1u << region);
+        gStats.regionsChecked++;
+        if (rectContains(rects[region], x, y)) {
+            return targets[region];
+        }
+    }
+    return HitTarget();
+}
+
+void setTapHandler(GameState state, TapHandler handler) {
+    gScreens[static_cast<int>(state)].handler = handler;
+}
+
+bool addHitRegion(GameState state, const SDL_Rect& rect, UiAction action, int index) {
+    HitTarget target;
+    target.action = action;
+    target.index = index;
+    return gScreens[static_cast<int>(state)].grid.add(rect, target);
+}
+
+HitTarget dispatchTap(InputContext& context, int x, int y) {
+    const ScreenInput& screen = gScreens[static_cast<int>(context.state.currentState)];
+    if (!screen.handler) return HitTarget();
+
+    HitTarget target = screen.grid.hitTest(x, y);
+    target.x = x;
+    target.y = y;
+    gStats.taps++;
+    if (target.action != UiAction::NONE) {
+        gStats.hits++;
+    }
+    screen.handler(context, target);
+    return target;
+}
+
+InputStats getInputStats() {
+    return gStats;
+}
+
+void logInputStats() {
+    std::cout << "=== Input ===" << std::endl;
+    std::cout << "  Taps: " << gStats.taps << ", on a region: " << gStats.hits;
+    if (gStats.taps > 0) {
+        std::cout << " (" << static_cast<float>(gStats.regionsChecked) / gStats.taps << " regions checked per tap)";
+    }
+    std::cout << std::endl;
+}
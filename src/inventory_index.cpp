@@ -0,0 +1,311 @@
+#include <algorithm>
+#include <iostream>
+#include "../include/inventory_index.h"
+#include "../include/plant_catalog.h"
+
+namespace {
+
+// List slot holding every plant; slots below it hold one weather each
+const int ALL_PLANTS = WEATHER_COUNT;
+
+std::vector<uint64_t> gKeys[INVENTORY_SORT_COUNT];   // Per plant: sort value << 32 | serial
+std::vector<uint8_t> gWeather;                       // Per plant: the weather list it is in
+std::vector<uint32_t> gLists[INVENTORY_SORT_COUNT][WEATHER_COUNT + 1];
+uint32_t gNextSerial = 0;
+bool gBuilt = false;
+InventoryView gView;
+InventoryIndexStats gStats;
+
+// Batch scratch, sized when the index is built so growth ticks don't allocate
+std::vector<uint8_t> gMoved;     // Per plant: its key changed in this batch
+std::vector<uint32_t> gBatch;
+std::vector<uint32_t> gBucket;
+std::vector<uint32_t> gMerged;
+
+double microsSince(Uint64 start) {
+    return (SDL_GetPerformanceCounter() - start) * 1000000.0 / SDL_GetPerformanceFrequency();
+}
+
+void recordUpdate(Uint64 start) {
+    double micros = microsSince(start);
+    gStats.updateMicros += micros;
+    gStats.maxUpdateMicros = std::max(gStats.maxUpdateMicros, micros);
+}
+
+uint32_t sortValue(const Plant& plant, InventorySort sort) {
+    const PlantSpecies* species = findSpecies(plant.catalogId);
+    switch (sort) {
+        case InventorySort::CATALOG:
+            return static_cast<uint32_t>(plant.catalogId);
+        case InventorySort::NAME:
+            return species ? species->nameRank : UINT16_MAX;
+        case InventorySort::WEATHER:
+            return static_cast<uint32_t>(plant.preferredWeather);
+        case InventorySort::GROWTH:
+            return static_cast<uint32_t>(plant.growth);
+        case InventorySort::VALUE:
+            return (species ? (species->priceMin + species->priceMax) / 2u : 0u) + plant.growth;
+        default:
+            return 0;
+    }
+}
+
+uint64_t makeKey(const Plant& plant, int sort, uint32_t serial) {
+    return static_cast<uint64_t>(sortValue(plant, static_cast<InventorySort>(sort))) << 32 | serial;
+}
+
+uint32_t serialOf(int plant) {
+    return static_cast<uint32_t>(gKeys[0][plant]);
+}
+
+uint8_t weatherSlot(const Plant& plant) {
+    int weather = static_cast<int>(plant.preferredWeather);
+    return static_cast<uint8_t>(weather >= 0 && weather < WEATHER_COUNT ? weather : 0);
+}
+
+// First position in a list whose key is not below key
+size_t findEntry(const std::vector<uint32_t>& list, int sort, uint64_t key) {
+    const std::vector<uint64_t>& keys = gKeys[sort];
+    auto it = std::lower_bound(list.begin(), list.end(), key,
+                               [&keys](uint32_t plant, uint64_t value) { return keys[plant] < value; });
+    return static_cast<size_t>(it - list.begin());
+}
+
+void insertEntries(int sort, int plant) {
+    for (int slot : {ALL_PLANTS, static_cast<int>(gWeather[plant])}) {
+        std::vector<uint32_t>& list = gLists[sort][slot];
+        list.insert(list.begin() + findEntry(list, sort, gKeys[sort][plant]), static_cast<uint32_t>(plant));
+    }
+}
+
+void eraseEntries(int sort, int plant) {
+    for (int slot : {ALL_PLANTS, static_cast<int>(gWeather[plant])}) {
+        std::vector<uint32_t>& list = gLists[sort][slot];
+        size_t position = findEntry(list, sort, gKeys[sort][plant]);
+        if (position < list.size() && list[position] == static_cast<uint32_t>(plant)) {
+            list.erase(list.begin() + position);
+        }
+    }
+}
+
+// Take the moved plants out of a list (the rest is still in order) and
+// merge them back in at their new keys. gBatch is sorted by the new keys.
+void mergeMoved(int sort, int slot) {
+    std::vector<uint32_t>& list = gLists[sort][slot];
+    auto kept = std::remove_if(list.begin(), list.end(), [](uint32_t plant) { return gMoved[plant] != 0; });
+    if (kept == list.end()) return;
+    list.erase(kept, list.end());
+
+    const std::vector<uint32_t>* moved = &gBatch;
+    if (slot != ALL_PLANTS) {
+        gBucket.clear();
+        for (uint32_t plant : gBatch) {
+            if (gWeather[plant] == slot) gBucket.push_back(plant);
+        }
+        moved = &gBucket;
+    }
+
+    const std::vector<uint64_t>& keys = gKeys[sort];
+    gMerged.clear();
+    std::merge(list.begin(), list.end(), moved->begin(), moved->end(), std::back_inserter(gMerged),
+               [&keys](uint32_t a, uint32_t b) { return keys[a] < keys[b]; });
+    list.assign(gMerged.begin(), gMerged.end());
+}
+
+const std::vector<uint32_t>& viewList() {
+    int slot = gView.weatherFilter == INVENTORY_FILTER_ALL ? ALL_PLANTS : gView.weatherFilter;
+    return gLists[static_cast<int>(gView.sort)][slot];
+}
+
+} // namespace
+
+void rebuildInventoryIndex(const std::vector<Plant>& plants) {
+    Uint64 start = SDL_GetPerformanceCounter();
+    size_t count = plants.size();
+
+    gWeather.resize(count);
+    for (int sort = 0; sort < INVENTORY_SORT_COUNT; sort++) {
+        gKeys[sort].resize(count);
+        for (std::vector<uint32_t>& list : gLists[sort]) {
+            list.clear();
+        }
+    }
+
+    size_t slotSizes[WEATHER_COUNT + 1] = {};
+    for (size_t plant = 0; plant < count; plant++) {
+        gWeather[plant] = weatherSlot(plants[plant]);
+        slotSizes[gWeather[plant]]++;
+    }
+    slotSizes[ALL_PLANTS] = count;
+    for (int sort = 0; sort < INVENTORY_SORT_COUNT; sort++) {
+        for (int slot = 0; slot <= ALL_PLANTS; slot++) {
+            gLists[sort][slot].reserve(slotSizes[slot]);
+        }
+    }
+
+    for (size_t plant = 0; plant < count; plant++) {
+        uint32_t serial = gNextSerial++;
+        for (int sort = 0; sort < INVENTORY_SORT_COUNT; sort++) {
+            gKeys[sort][plant] = makeKey(plants[plant], sort, serial);
+            gLists[sort][ALL_PLANTS].push_back(static_cast<uint32_t>(plant));
+            gLists[sort][gWeather[plant]].push_back(static_cast<uint32_t>(plant));
+        }
+    }
+
+    for (int sort = 0; sort < INVENTORY_SORT_COUNT; sort++) {
+        const std::vector<uint64_t>& keys = gKeys[sort];
+        for (std::vector<uint32_t>& list : gLists[sort]) {
+            std::sort(list.begin(), list.end(), [&keys](uint32_t a, uint32_t b) { return keys[a] < keys[b]; });
+        }
+    }
+
+    gMoved.assign(count, 0);
+    gBatch.reserve(count);
+    gBucket.reserve(count);
+    gMerged.reserve(count);
+    gBuilt = true;
+    gStats.rebuilds++;
+    recordUpdate(start);
+}
+
+void inventoryPlantRemoved(int plantIndex, int lastIndex) {
+    if (!gBuilt || plantIndex < 0 || lastIndex != static_cast<int>(gWeather.size()) - 1) return;
+    Uint64 start = SDL_GetPerformanceCounter();
+
+    for (int sort = 0; sort < INVENTORY_SORT_COUNT; sort++) {
+        eraseEntries(sort, plantIndex);
+        if (lastIndex == plantIndex) continue;
+
+        // The last plant keeps its keys, so its entries stay in place and
+        // only the index they hold changes
+        for (int slot : {ALL_PLANTS, static_cast<int>(gWeather[lastIndex])}) {
+            std::vector<uint32_t>& list = gLists[sort][slot];
+            list[findEntry(list, sort, gKeys[sort][lastIndex])] = static_cast<uint32_t>(plantIndex);
+        }
+        gKeys[sort][plantIndex] = gKeys[sort][lastIndex];
+    }
+    gWeather[plantIndex] = gWeather[lastIndex];
+
+    for (std::vector<uint64_t>& keys : gKeys) {
+        keys.pop_back();
+    }
+    gWeather.pop_back();
+    gMoved.pop_back();
+
+    gStats.updates++;
+    recordUpdate(start);
+}
+
+void inventoryPlantChanged(const std::vector<Plant>& plants, int plantIndex) {
+    if (!gBuilt || plantIndex < 0 || plantIndex >= static_cast<int>(gWeather.size())) return;
+    Uint64 start = SDL_GetPerformanceCounter();
+
+    const Plant& plant = plants[plantIndex];
+    uint32_t serial = serialOf(plantIndex);
+    uint8_t weather = weatherSlot(plant);
+    bool moved[INVENTORY_SORT_COUNT];
+    for (int sort = 0; sort < INVENTORY_SORT_COUNT; sort++) {
+        moved[sort] = weather != gWeather[plantIndex] || makeKey(plant, sort, serial) != gKeys[sort][plantIndex];
+        if (moved[sort]) eraseEntries(sort, plantIndex);
+    }
+    gWeather[plantIndex] = weather;
+    for (int sort = 0; sort < INVENTORY_SORT_COUNT; sort++) {
+        if (!moved[sort]) continue;
+        gKeys[sort][plantIndex] = makeKey(plant, sort, serial);
+        insertEntries(sort, plantIndex);
+    }
+
+    gStats.updates++;
+    recordUpdate(start);
+}
+
+void inventoryPlantsChanged(const std::vector<Plant>& plants, const int* plantIndices, int count) {
+    if (!gBuilt || count <= 0) return;
+    Uint64 start = SDL_GetPerformanceCounter();
+
+    for (int sort = 0; sort < INVENTORY_SORT_COUNT; sort++) {
+        gBatch.clear();
+        for (int i = 0; i < count; i++) {
+            int plant = plantIndices[i];
+            if (plant < 0 || plant >= static_cast<int>(gWeather.size())) continue;
+            uint64_t key = makeKey(plants[plant], sort, serialOf(plant));
+            if (key == gKeys[sort][plant] || gMoved[plant]) continue;
+            gKeys[sort][plant] = key;
+            gMoved[plant] = 1;
+            gBatch.push_back(static_cast<uint32_t>(plant));
+        }
+        if (gBatch.empty()) continue;
+
+        const std::vector<uint64_t>& keys = gKeys[sort];
+        std::sort(gBatch.begin(), gBatch.end(), [&keys](uint32_t a, uint32_t b) { return keys[a] < keys[b]; });
+        for (int slot = 0; slot <= ALL_PLANTS; slot++) {
+            mergeMoved(sort, slot);
+        }
+        for (uint32_t plant : gBatch) {
+            gMoved[plant] = 0;
+        }
+    }
+
+    gStats.batches++;
+    gStats.batchedPlants += count;
+    recordUpdate(start);
+}
+
+void setInventoryView(const InventoryView& view) {
+    gView = view;
+    if (gView.weatherFilter < INVENTORY_FILTER_ALL || gView.weatherFilter >= WEATHER_COUNT) {
+        gView.weatherFilter = INVENTORY_FILTER_ALL;
+    }
+}
+
+InventoryView getInventoryView() {
+    return gView;
+}
+
+int inventoryCount() {
+    return static_cast<int>(viewList().size());
+}
+
+int inventoryPlantAt(int position) {
+    const std::vector<uint32_t>& list = viewList();
+    int count = static_cast<int>(list.size());
+    if (position < 0 || position >= count) return -1;
+    return static_cast<int>(list[gView.descending ? count - 1 - position : position]);
+}
+
+int inventoryPositionOf(int plantIndex) {
+    if (plantIndex < 0 || plantIndex >= static_cast<int>(gWeather.size())) return -1;
+    if (gView.weatherFilter != INVENTORY_FILTER_ALL && gWeather[plantIndex] != gView.weatherFilter) return -1;
+
+    const std::vector<uint32_t>& list = viewList();
+    int sort = static_cast<int>(gView.sort);
+    size_t position = findEntry(list, sort, gKeys[sort][plantIndex]);
+    if (position >= list.size() || list[position] != static_cast<uint32_t>(plantIndex)) return -1;
+    int count = static_cast<int>(list.size());
+    return gView.descending ? count - 1 - static_cast<int>(position) : static_cast<int>(position);
+}
+
+InventoryIndexStats getInventoryIndexStats() {
+    return gStats;
+}
+
+void logInventoryIndexStats() {
+    size_t bytes = gWeather.capacity() + gMoved.capacity() +
+                   (gBatch.capacity() + gBucket.capacity() + gMerged.capacity()) * sizeof(uint32_t);
+    for (int sort = 0; sort < INVENTORY_SORT_COUNT; sort++) {
+        bytes += gKeys[sort].capacity() * sizeof(uint64_t);
+        for (const std::vector<uint32_t>& list : gLists[sort]) {
+            bytes += list.capacity() * sizeof(uint32_t);
+        }
+    }
+
+    std::cout << "=== Inventory Index ===" << std::endl;
+    std::cout << "  Plants: " << gWeather.size() << ", " << bytes / 1024 << " KB of indices" << std::endl;
+    int changes = gStats.rebuilds + gStats.updates + gStats.batches;
+    std::cout << "  Rebuilds: " << gStats.rebuilds << ", updates: " << gStats.updates
+              << ", batches: " << gStats.batches << " (" << gStats.batchedPlants << " plants)";
+    if (changes > 0) {
+        std::cout << ", " << gStats.updateMicros / changes << " us avg, " << gStats.maxUpdateMicros << " us max";
+    }
+    std::cout << std::endl;
+}
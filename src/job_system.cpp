@@ -0,0 +1,309 @@
+#include <SDL2/SDL.h>
+#include <algorithm>
+#include <condition_variable>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include "../include/job_system.h"
+
+namespace {
+
+// Deque slot 0 belongs to the main thread and workers use 1..gWorkerCount.
+// Any other thread that queues jobs claims one of the slots after
+// MAX_JOB_WORKERS the first time it does, so
+// the main thread's count and deque only ever hold its own jobs. The owner
+// pushes and pops at the bottom, thieves take from the top.
+struct JobDeque {
+    std::mutex mutex;
+    Job jobs[JOB_QUEUE_CAPACITY];
+    unsigned top = 0;
+    unsigned bottom = 0;
+    std::atomic<int> size{0};   // Lets thieves skip empty deques without locking
+
+    bool push(const Job& job) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (bottom - top >= static_cast<unsigned>(JOB_QUEUE_CAPACITY)) return false;
+        jobs[bottom++ % JOB_QUEUE_CAPACITY] = job;
+        size.fetch_add(1, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(Job& job) {
+        if (size.load(std::memory_order_acquire) == 0) return false;
+        std::lock_guard<std::mutex> lock(mutex);
+        if (bottom == top) return false;
+        job = jobs[--bottom % JOB_QUEUE_CAPACITY];
+        size.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    bool steal(Job& job) {
+        if (size.load(std::memory_order_acquire) == 0) return false;
+        std::lock_guard<std::mutex> lock(mutex);
+        if (bottom == top) return false;
+        job = jobs[top++ % JOB_QUEUE_CAPACITY];
+        size.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+};
+
+const int JOB_SLOT_COUNT = 1 + MAX_JOB_WORKERS + MAX_JOB_SUBMITTERS;
+const int FIRST_SUBMITTER_SLOT = 1 + MAX_JOB_WORKERS;
+
+JobDeque gDeques[JOB_SLOT_COUNT];
+std::thread gWorkers[MAX_JOB_WORKERS];
+int gWorkerCount = 0;
+int gStartedWorkers = 0;   // For the report, which runs after shutdown
+thread_local int tSlot = -1;   // -1 until the thread first touches the job system
+std::atomic<int> gSubmitters{0};
+
+// Workers sleep here when every deque is empty
+std::mutex gSleepMutex;
+std::condition_variable gWake;
+std::atomic<int> gQueued{0};
+bool gStopping = false;
+
+// Main thread queue for jobs that make SDL calls
+std::mutex gMainMutex;
+Job gMainJobs[MAIN_THREAD_JOB_CAPACITY];
+int gMainJobCount = 0;
+std::thread::id gMainThread;
+
+std::atomic<long long> gJobsRun{0};
+std::atomic<long long> gMainThreadRuns{0};
+std::atomic<long long> gSubmitterRuns{0};
+std::atomic<long long> gSteals{0};
+std::atomic<long long> gInlineRuns{0};
+std::atomic<long long> gMainThreadJobs{0};
+long long gWaits = 0;
+double gWaitMicros = 0;
+
+// This thread's deque. Submitters beyond MAX_JOB_SUBMITTERS share the last
+// slot, which is safe (deques lock) but lets them run each other's jobs.
+int ownSlot() {
+    if (tSlot < 0) {
+        int submitter = gSubmitters.fetch_add(1, std::memory_order_relaxed);
+        tSlot = FIRST_SUBMITTER_SLOT + std::min(submitter, MAX_JOB_SUBMITTERS - 1);
+    }
+    return tSlot;
+}
+
+void runJob(const Job& job) {
+    job.function(job.data, job.begin, job.end);
+    gJobsRun.fetch_add(1, std::memory_order_relaxed);
+    int slot = ownSlot();
+    if (slot == 0) {
+        gMainThreadRuns.fetch_add(1, std::memory_order_relaxed);
+    } else if (slot >= FIRST_SUBMITTER_SLOT) {
+        gSubmitterRuns.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (job.counter) {
+        job.counter->pending.fetch_sub(1, std::memory_order_release);
+    }
+}
+
+// Own deque first (newest job, still warm in cache), then steal the
+// oldest job from the others, starting with the next slot
+bool findJob(Job& job) {
+    int slot = ownSlot();
+    if (gDeques[slot].pop(job)) {
+        gQueued.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+    // Unused slots are empty and skipped without locking
+    for (int i = 1; i < JOB_SLOT_COUNT; i++) {
+        if (gDeques[(slot + i) % JOB_SLOT_COUNT].steal(job)) {
+            gQueued.fetch_sub(1, std::memory_order_relaxed);
+            gSteals.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+// Push without waking anyone; false if the job was run inline instead
+bool pushJob(const Job& job) {
+    if (gWorkerCount > 0 && gDeques[ownSlot()].push(job)) {
+        gQueued.fetch_add(1, std::memory_order_release);
+        return true;
+    }
+    gInlineRuns.fetch_add(1, std::memory_order_relaxed);
+    runJob(job);
+    return false;
+}
+
+void wakeWorkers() {
+    // Taking the lock orders the wake after a worker's last empty check
+    { std::lock_guard<std::mutex> lock(gSleepMutex); }
+    gWake.notify_all();
+}
+
+void workerMain(int slot) {
+    tSlot = slot;
+    Job job;
+    while (true) {
+        if (findJob(job)) {
+            runJob(job);
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(gSleepMutex);
+        if (gStopping && gQueued.load(std::memory_order_acquire) == 0) break;
+        gWake.wait(lock, [] { return gStopping || gQueued.load(std::memory_order_acquire) > 0; });
+    }
+}
+
+bool isMainThread() {
+    return std::this_thread::get_id() == gMainThread;
+}
+
+} // namespace
+
+void initJobSystem(int workerCount) {
+    if (gWorkerCount > 0) return;
+    gMainThread = std::this_thread::get_id();
+    tSlot = 0;
+
+    if (workerCount < 0) {
+        workerCount = static_cast<int>(std::thread::hardware_concurrency()) - 1;
+        workerCount = std::max(1, workerCount);
+    }
+    workerCount = std::min(workerCount, MAX_JOB_WORKERS);
+
+    gStopping = false;
+    gWorkerCount = workerCount;
+    gStartedWorkers = workerCount;
+    for (int i = 0; i < workerCount; i++) {
+        gWorkers[i] = std::thread(workerMain, i + 1);
+    }
+}
+
+void shutdownJobSystem() {
+    if (gWorkerCount == 0) return;
+    {
+        std::lock_guard<std::mutex> lock(gSleepMutex);
+        gStopping = true;
+    }
+    gWake.notify_all();
+    for (int i = 0; i < gWorkerCount; i++) {
+        gWorkers[i].join();
+    }
+    gWorkerCount = 0;
+    runMainThreadJobs();
+}
+
+int jobWorkerCount() {
+    return gWorkerCount;
+}
+
+void submitJob(const Job& job) {
+    if (job.counter) {
+        job.counter->pending.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (pushJob(job)) {
+        wakeWorkers();
+    }
+}
+
+void parallelFor(JobFunction function, void* data, int count, int grain, JobCounter& counter) {
+    if (count <= 0) return;
+    grain = std::max(1, grain);
+    int jobs = (count + grain - 1) / grain;
+    counter.pending.fetch_add(jobs, std::memory_order_relaxed);
+
+    bool queued = false;
+    Job job;
+    job.function = function;
+    job.data = data;
+    job.counter = &counter;
+    for (int begin = 0; begin < count; begin += grain) {
+        job.begin = begin;
+        job.end = std::min(count, begin + grain);
+        queued |= pushJob(job);
+    }
+    if (queued) {
+        wakeWorkers();
+    }
+}
+
+void waitForCounter(JobCounter& counter) {
+    bool mainThread = isMainThread();
+    Uint64 start = mainThread ? SDL_GetPerformanceCounter() : 0;
+
+    Job job;
+    while (!counter.done()) {
+        if (mainThread) {
+            runMainThreadJobs();
+        }
+        if (findJob(job)) {
+            runJob(job);
+        } else {
+            // The rest are running on other threads
+            std::this_thread::yield();
+        }
+    }
+
+    if (mainThread) {
+        gWaits++;
+        gWaitMicros += (SDL_GetPerformanceCounter() - start) * 1000000.0 / SDL_GetPerformanceFrequency();
+    }
+}
+
+bool submitMainThreadJob(const Job& job) {
+    std::lock_guard<std::mutex> lock(gMainMutex);
+    if (gMainJobCount >= MAIN_THREAD_JOB_CAPACITY) {
+        std::cerr << "Main thread job queue full, dropping job" << std::endl;
+        return false;
+    }
+    if (job.counter) {
+        job.counter->pending.fetch_add(1, std::memory_order_relaxed);
+    }
+    gMainJobs[gMainJobCount++] = job;
+    gMainThreadJobs.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+int runMainThreadJobs() {
+    if (!isMainThread()) return 0;
+
+    // Take the batch under the lock so jobs may queue more while running
+    Job batch[MAIN_THREAD_JOB_CAPACITY];
+    int count = 0;
+    {
+        std::lock_guard<std::mutex> lock(gMainMutex);
+        count = gMainJobCount;
+        std::copy(gMainJobs, gMainJobs + count, batch);
+        gMainJobCount = 0;
+    }
+    for (int i = 0; i < count; i++) {
+        runJob(batch[i]);
+    }
+    return count;
+}
+
+JobStats getJobStats() {
+    JobStats stats;
+    stats.workers = gStartedWorkers;
+    stats.jobs = gJobsRun.load();
+    stats.mainThreadRuns = gMainThreadRuns.load();
+    stats.submitterRuns = gSubmitterRuns.load();
+    stats.steals = gSteals.load();
+    stats.inlineRuns = gInlineRuns.load();
+    stats.mainThreadJobs = gMainThreadJobs.load();
+    stats.waits = gWaits;
+    stats.waitMicros = gWaitMicros;
+    return stats;
+}
+
+void logJobStats() {
+    JobStats stats = getJobStats();
+    std::cout << "=== Job System ===" << std::endl;
+    std::cout << "  Workers: " << stats.workers << ", jobs: " << stats.jobs
+              << " (" << stats.mainThreadRuns << " on the main thread, " << stats.submitterRuns
+              << " on other submitting threads, " << stats.steals << " stolen, "
+              << stats.inlineRuns << " inline)" << std::endl;
+    std::cout << "  Main thread jobs queued: " << stats.mainThreadJobs << ", waits: " << stats.waits;
+    if (stats.waits > 0) {
+        std::cout << ", " << stats.waitMicros / stats.waits << " us avg";
+    }
+    std::cout << std::endl;
+}
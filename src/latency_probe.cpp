@@ -0,0 +1,97 @@
+#include <SDL2/SDL.h>
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include "../include/latency_probe.h"
+
+namespace {
+
+struct PendingInput {
+    uint32_t id = 0;
+    Uint64 queuedAt = 0;
+};
+
+bool gEnabled = false;
+PendingInput gPending[LATENCY_TRACKED_EVENTS];
+uint32_t gLastPresented = 0;   // Newest id already counted
+LatencyStats gStats;
+
+} // namespace
+
+void setLatencyProbeEnabled(bool enabled) {
+    gEnabled = enabled;
+}
+
+bool latencyProbeEnabled() {
+    return gEnabled;
+}
+
+void latencyInputQueued(uint32_t id, Uint64 queuedAt) {
+    if (!gEnabled) return;
+    PendingInput& slot = gPending[id % LATENCY_TRACKED_EVENTS];
+    if (slot.id > gLastPresented) {
+        gStats.lost++;
+    }
+    slot.id = id;
+    slot.queuedAt = queuedAt;
+}
+
+void latencyFramePresented(uint32_t lastInputId) {
+    if (!gEnabled || lastInputId <= gLastPresented) return;
+    Uint64 now = SDL_GetPerformanceCounter();
+    double frequency = static_cast<double>(SDL_GetPerformanceFrequency());
+
+    for (uint32_t id = gLastPresented + 1; id <= lastInputId; id++) {
+        const PendingInput& slot = gPending[id % LATENCY_TRACKED_EVENTS];
+        if (slot.id != id) continue;   // Overwritten; counted as lost
+        double micros = (now - slot.queuedAt) * 1000000.0 / frequency;
+        int bucket = std::min(LATENCY_HISTOGRAM_BUCKETS - 1, static_cast<int>(micros / 1000.0));
+        gStats.histogram[bucket]++;
+        gStats.samples++;
+        gStats.totalMicros += micros;
+        gStats.maxMicros = std::max(gStats.maxMicros, micros);
+    }
+    gLastPresented = lastInputId;
+}
+
+LatencyStats getLatencyStats() {
+    return gStats;
+}
+
+int latencyPercentileMs(const LatencyStats& stats, double fraction) {
+    if (stats.samples == 0) return 0;
+    long long target = std::max(1LL, static_cast<long long>(stats.samples * fraction + 0.5));
+    long long seen = 0;
+    for (int bucket = 0; bucket < LATENCY_HISTOGRAM_BUCKETS; bucket++) {
+        seen += stats.histogram[bucket];
+        if (seen >= target) return bucket + 1;
+    }
+    return LATENCY_HISTOGRAM_BUCKETS;
+}
+
+void logLatencyStats() {
+    if (!gEnabled) return;
+    LatencyStats stats = getLatencyStats();
+    std::cout << "=== Input to Present Latency ===" << std::endl;
+    std::cout << "  Events: " << stats.samples << " (" << stats.lost << " lost)";
+    if (stats.samples == 0) {
+        std::cout << std::endl;
+        return;
+    }
+    std::cout << ", " << stats.totalMicros / stats.samples / 1000.0 << " ms avg, "
+              << stats.maxMicros / 1000.0 << " ms max" << std::endl;
+    std::cout << "  p50 <= " << latencyPercentileMs(stats, 0.50) << " ms, p90 <= "
+              << latencyPercentileMs(stats, 0.90) << " ms, p99 <= " << latencyPercentileMs(stats, 0.99)
+              << " ms" << std::endl;
+
+    // One row per non-empty bucket, bar scaled to the fullest
+    long long fullest = *std::max_element(stats.histogram, stats.histogram + LATENCY_HISTOGRAM_BUCKETS);
+    for (int bucket = 0; bucket < LATENCY_HISTOGRAM_BUCKETS; bucket++) {
+        long long count = stats.histogram[bucket];
+        if (count == 0) continue;
+        int bar = static_cast<int>(count * 40 / fullest);
+        std::cout << "  " << (bucket < 10 ? " " : "") << bucket
+                  << (bucket == LATENCY_HISTOGRAM_BUCKETS - 1 ? "+ ms " : "  ms ")
+                  << std::string(std::max(1, bar), '#') << " " << count << std::endl;
+    }
+}
@@ -6,105 +6,234 @@
 #include <cmath>
 #include "../include/game.h"
 #include "../include/render.h"
+#include "../include/memory_tracker.h"
+#include "../include/hal.h"
+#include "../include/arena.h"
+#include "../include/layout.h"
+#include "../include/assets.h"
+#include "../include/color_grade.h"
+#include "../include/compositor.h"
+#include "../include/transition.h"
+#include "../include/sprite_cache.h"
+#include "../include/particles.h"
+#include "../include/weather_overlay.h"
+#include "../include/input_router.h"
+#include "../include/input_queue.h"
+#include "../include/gesture.h"
+#include "../include/latency_probe.h"
+#include "../include/save_game.h"
+#include "../include/plant_catalog.h"
+#include "../include/inventory_index.h"
+#include "../include/job_system.h"
+#include "../include/render_snapshot.h"
+#include "../include/simulation.h"
 #include <ctime>
 #include <random>
 #include <algorithm>
+#include <memory>
+#include <cstdio>
 
 // Forward declarations for rendering functions
 void drawPixelText(SDL_Renderer* renderer, const std::string& text, int x, int y, SDL_Color color);
 SDL_Texture* createPlaceholderBackground(SDL_Renderer* renderer, const SDL_Color& bgColor, const std::string& label, int width, int height);
 std::vector<Background> loadBackgrounds(SDL_Renderer* renderer);
 void renderIntroScreen(SDL_Renderer* renderer, const ColorPalette& palette);
-void renderPlantViewScreen(SDL_Renderer* renderer, const ColorPalette& palette, const Plant& plant, const Player& player, 
-                         const PlantNavigationButtons& navButtons, WeatherType weather, DayNightType dayNight,
-                         const std::vector<Background>& backgrounds, const std::vector<Raindrop>& raindrops);
-void renderMenuViewScreen(SDL_Renderer* renderer, const ColorPalette& palette, const std::vector<Plant>& plants, 
-                         const Player& player, const std::vector<Button>& menuGridButtons, 
-                         const Button& prevPageButton, const Button& nextPageButton, int currentPage, int plantsPerPage);
-void renderMapScreen(SDL_Renderer* renderer, const ColorPalette& palette, const std::vector<Button>& locationButtons);
+void renderPlantViewScreen(SDL_Renderer* renderer, const ColorPalette& palette, const RenderSnapshot& snapshot,
+                         const std::vector<PlantSprite>& sprites, const std::vector<Background>& backgrounds,
+                         const WeatherOverlay& weatherOverlay);
+void renderMenuViewScreen(SDL_Renderer* renderer, const ColorPalette& palette, const RenderSnapshot& snapshot,
+                         const std::vector<PlantSprite>& sprites);
+void renderMapScreen(SDL_Renderer* renderer, const ColorPalette& palette);
 void renderLocationScreen(SDL_Renderer* renderer, const ColorPalette& palette, const std::string& locationName, 
-                         const SDL_Color& bgColor, const Button& backButton);
-void renderStoreScreen(SDL_Renderer* renderer, const ColorPalette& palette, const std::vector<Plant>& plants, const Player& player,
-                     const Button& backButton, const std::string& shopkeeperText,
-                     const Button& yesButton, const Button& noButton,
-                     int selectedPlantIndex, int offerAmount);
-
-// Function to load plants
-std::vector<Plant> loadPlants(SDL_Renderer* renderer) {
+                         const SDL_Color& bgColor);
+void renderStoreScreen(SDL_Renderer* renderer, const ColorPalette& palette, const RenderSnapshot& snapshot,
+                     const std::vector<PlantSprite>& sprites);
+void registerInputHandlers();
+
+// Starter plants, built from the catalog. Sprites aren't loaded here:
+// ensurePlantSprite binds them the first time a plant is drawn.
+std::vector<Plant> loadPlants() {
     std::vector<Plant> plants;
-    const int TOTAL_PLANTS = 8; // Reduced number of plants
-    
-    // Create a default texture for plants that fail to load
-    SDL_Texture* defaultTexture = createPlaceholderBackground(renderer, {100, 100, 100, 255}, "?", 32, 32);
-    if (!defaultTexture) {
-        std::cerr << "Failed to create default texture!" << std::endl;
-        return plants;
-    }
+    plants.reserve(STARTER_PLANT_COUNT);
     
-    bool defaultTextureUsed = false;
-    
-    for (int i = 1; i <= TOTAL_PLANTS; i++) {
-        Plant plant;
-        plant.name = "Plant " + std::to_string(i);
-        plant.filename = "assets/plant_" + std::to_string(i) + ".png";
-        plant.isOwned = true; // Make all plants owned by default
-        
-        // Try to load the plant texture
-        plant.texture = loadTexture(renderer, plant.filename);
-        if (plant.texture == nullptr) {
-            std::cerr << "Failed to load plant texture: " << plant.filename << ", using default" << std::endl;
-            plant.texture = defaultTexture;
-            defaultTextureUsed = true;
-        }
-        
-        // Set default dimensions
-        plant.width = 32;
-        plant.height = 32;
-        
-        // Try to get actual dimensions if texture loaded successfully
-        if (plant.texture != defaultTexture) {
-            if (SDL_QueryTexture(plant.texture, nullptr, nullptr, &plant.width, &plant.height) != 0) {
-                std::cerr << "Failed to query texture dimensions for: " << plant.filename << std::endl;
-            }
+    for (int id = 1; id <= STARTER_PLANT_COUNT; id++) {
+        const PlantSpecies* species = findSpecies(id);
+        if (!species) {
+            std::cerr << "Plant catalog has no species " << id << ", skipping" << std::endl;
+            continue;
         }
         
-        // Assign a random preferred weather to each plant
-        plant.preferredWeather = static_cast<WeatherType>(rand() % 4);
+        Plant plant;
+        plant.catalogId = species->id;
+        plant.name = speciesName(*species);
+        plant.filename = speciesSprite(*species);
+        plant.preferredWeather = species->weather;
+        plant.isOwned = true; // Make all plants owned by default
         
-        // Use move semantics when adding to vector
         plants.push_back(std::move(plant));
     }
     
-    // If default texture was used, we need to create a new one for each plant that used it
-    if (defaultTextureUsed) {
-        for (auto& plant : plants) {
-            if (plant.texture == defaultTexture) {
-                plant.texture = createPlaceholderBackground(renderer, {100, 100, 100, 255}, "?", 32, 32);
-            }
-        }
-        SDL_DestroyTexture(defaultTexture);
-    }
-    
     return plants;
 }
 
-// Define buttons as global variables
-PlantNavigationButtons navButtons;
-Button continueButton;
-Button prevPageButton;
-Button nextPageButton;
-Button okButton;
-std::vector<Button> inventoryGridButtons;  // Renamed from menuGridButtons
+// Neighbour sprites decoded on the job system while a swipe may start, so
+// the render thread only has to upload them
+struct SpritePrefetch {
+    int catalogId = 0;                // 0 when the slot is free
+    const char* path = nullptr;
+    SDL_Surface* surface = nullptr;   // Set by the job; null if decoding failed
+    JobCounter counter;
+};
 
-// Add global variables for celebration
-std::vector<Particle> celebrationParticles;
-Uint32 celebrationStartTime = 0;
+static SpritePrefetch gSpritePrefetches[2];
+
+// Frames drawn so far; sprites drawn in this frame or the last are kept
+// when the sprite budget evicts. Starts at 2 so never-drawn sprites go first.
+static uint32_t gRenderFrame = 2;
+
+static void decodeSpriteJob(void* data, int, int) {
+    SpritePrefetch* prefetch = static_cast<SpritePrefetch*>(data);
+    prefetch->surface = loadAssetSurface(prefetch->path);
+}
+
+// Placeholders aren't evicted, so a missing sprite is only tried once
+static void usePlaceholderSprite(SDL_Renderer* renderer, PlantSprite& sprite, const char* filename) {
+    std::cerr << "Failed to load plant texture: " << filename << ", using default" << std::endl;
+    sprite.texture = createPlaceholderBackground(renderer, {100, 100, 100, 255}, "?", 32, 32);
+    sprite.width = 32;
+    sprite.height = 32;
+}
+
+// Upload a decoded prefetch and free its slot. Returns false if it is
+// still decoding and wait is not set.
+static bool completeSpritePrefetch(SDL_Renderer* renderer, std::vector<PlantSprite>& sprites,
+                                   SpritePrefetch& prefetch, bool wait) {
+    if (prefetch.catalogId == 0) return false;
+    if (!prefetch.counter.done()) {
+        if (!wait) return false;
+        waitForCounter(prefetch.counter);
+    }
+    PlantSprite& sprite = sprites[prefetch.catalogId];
+    if (!sprite.texture && prefetch.surface) {
+        sprite.texture = trackTexture(SDL_CreateTextureFromSurface(renderer, prefetch.surface),
+                                      MemoryCategory::PLANT_SPRITE);
+        sprite.width = prefetch.surface->w;
+        sprite.height = prefetch.surface->h;
+    }
+    if (!sprite.texture) {
+        usePlaceholderSprite(renderer, sprite, prefetch.path);
+    }
+    SDL_FreeSurface(prefetch.surface);
+    prefetch.surface = nullptr;
+    prefetch.catalogId = 0;
+    return true;
+}
+
+// Start decoding a sprite that isn't bound yet on the job system, unless
+// it is already under way or both slots are busy
+static void prefetchPlantSprite(std::vector<PlantSprite>& sprites, int catalogId) {
+    const PlantSpecies* species = findSpecies(catalogId);
+    if (!species || catalogId >= static_cast<int>(sprites.size()) || sprites[catalogId].texture) return;
+    SpritePrefetch* slot = nullptr;
+    for (SpritePrefetch& prefetch : gSpritePrefetches) {
+        if (prefetch.catalogId == catalogId) return;
+        if (prefetch.catalogId == 0 && !slot) slot = &prefetch;
+    }
+    if (!slot) return;
+
+    slot->catalogId = catalogId;
+    slot->path = speciesSprite(*species);
+    slot->surface = nullptr;
+    Job job;
+    job.function = decodeSpriteJob;
+    job.data = slot;
+    job.begin = 0;
+    job.end = 1;
+    job.counter = &slot->counter;
+    submitJob(job);
+}
+
+// Bind a species' sprite on first use, or reload it if it was evicted to
+// stay within the sprite budget. Render thread only.
+bool ensurePlantSprite(SDL_Renderer* renderer, std::vector<PlantSprite>& sprites, int catalogId) {
+    const PlantSpecies* species = findSpecies(catalogId);
+    if (!species || catalogId >= static_cast<int>(sprites.size())) return false;
+    PlantSprite& sprite = sprites[catalogId];
+    sprite.lastUsedFrame = gRenderFrame;
+    if (sprite.texture) return true;
+    
+    // Already decoding in the background; finish that rather than start over
+    for (SpritePrefetch& prefetch : gSpritePrefetches) {
+        if (prefetch.catalogId == catalogId) {
+            completeSpritePrefetch(renderer, sprites, prefetch, true);
+            return true;
+        }
+    }
+    
+    const char* filename = speciesSprite(*species);
+    sprite.texture = trackTexture(loadAssetTexture(renderer, filename), MemoryCategory::PLANT_SPRITE);
+    if (!sprite.texture) {
+        usePlaceholderSprite(renderer, sprite, filename);
+        return false;
+    }
+    if (SDL_QueryTexture(sprite.texture, nullptr, nullptr, &sprite.width, &sprite.height) != 0) {
+        std::cerr << "Failed to query texture dimensions for: " << filename << std::endl;
+        sprite.width = 32;
+        sprite.height = 32;
+    }
+    return true;
+}
 
 // Main function
 int main(int argc, char* args[]) {
     // Initialize random seed
     srand(time(NULL));
     
+    // Parse memory budgets (e.g. --mem-budget=plants:16384:evict), the
+    // asset source (--assets=embedded|png), the 4-shade mode (--gameboy),
+    // the save file (--save=path), the number of job workers (--jobs=N,
+    // 0 runs jobs inline), the particle benchmark (--bench-particles[=count])
+    // and latency measurement (--latency, or --replay=path for a scripted run)
+    int benchParticles = 0;
+    int jobWorkers = -1;
+    std::string savePath = DEFAULT_SAVE_PATH;
+    std::string replayPath;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = args[i];
+        const std::string budgetFlag = "--mem-budget=";
+        const std::string assetsFlag = "--assets=";
+        const std::string benchFlag = "--bench-particles";
+        const std::string saveFlag = "--save=";
+        const std::string jobsFlag = "--jobs=";
+        const std::string replayFlag = "--replay=";
+        if (arg.compare(0, budgetFlag.size(), budgetFlag) == 0) {
+            if (!parseMemoryBudgetArg(arg.substr(budgetFlag.size()))) {
+                std::cerr << "Invalid memory budget: " << arg << std::endl;
+            }
+        } else if (arg.compare(0, assetsFlag.size(), assetsFlag) == 0) {
+            parseAssetSourceArg(arg.substr(assetsFlag.size()));
+        } else if (arg == "--gameboy") {
+            setGameboyMode(true);
+        } else if (arg.compare(0, saveFlag.size(), saveFlag) == 0) {
+            savePath = arg.substr(saveFlag.size());
+        } else if (arg.compare(0, jobsFlag.size(), jobsFlag) == 0) {
+            jobWorkers = std::max(0, std::atoi(arg.c_str() + jobsFlag.size()));
+        } else if (arg == "--latency") {
+            setLatencyProbeEnabled(true);
+        } else if (arg.compare(0, replayFlag.size(), replayFlag) == 0) {
+            replayPath = arg.substr(replayFlag.size());
+            setLatencyProbeEnabled(true);
+        } else if (arg.compare(0, benchFlag.size(), benchFlag) == 0) {
+            benchParticles = 50000;
+            if (arg.size() > benchFlag.size() + 1 && arg[benchFlag.size()] == '=') {
+                benchParticles = std::max(1, std::atoi(arg.c_str() + benchFlag.size() + 1));
+            }
+        }
+    }
+    
+    // Count SDL's own allocations; must happen before SDL_Init
+    installSdlMemoryHooks();
+    
     // Initialize SDL
     if (SDL_Init(SDL_INIT_VIDEO) < 0) {
         std::cerr << "SDL could not initialize! SDL_Error: " << SDL_GetError() << std::endl;
@@ -125,113 +254,119 @@ int main(int argc, char* args[]) {
         return 1;
     }
     
-    // Create window
-    SDL_Window* window = SDL_CreateWindow(
-        "PixelPets - Plants",
-        SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED,
-        SCREEN_WIDTH, SCREEN_HEIGHT,
-        SDL_WINDOW_SHOWN
-    );
-    
-    if (!window) {
-        std::cerr << "Window could not be created! SDL_Error: " << SDL_GetError() << std::endl;
+    // Create the display (desktop window or simulated SPI panel) and input
+    std::unique_ptr<Display> display = createDisplay(argc, args);
+    if (!display->init("PixelPets - Plants")) {
+        std::cerr << "Display could not be initialized!" << std::endl;
         IMG_Quit();
         SDL_Quit();
         return 1;
     }
+    SDL_Renderer* renderer = display->getRenderer();
+    SdlInput input(*display);
     
-    // Create renderer
-    SDL_Renderer* renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED);
-    if (!renderer) {
-        std::cerr << "Renderer could not be created! SDL_Error: " << SDL_GetError() << std::endl;
-        SDL_DestroyWindow(window);
+    if (benchParticles > 0) {
+        runParticleBenchmark(*display, benchParticles);
+        display->shutdown();
+        cleanupFont();
         IMG_Quit();
         SDL_Quit();
-        return 1;
+        return 0;
     }
     
-    // Create Player
-    Player player;
+    // Workers for decoding, grading and other parallel work
+    initJobSystem(jobWorkers);
+    
+    // Glyph atlas and screen backgrounds are built once so frames don't allocate
+    if (!initTextAtlas(renderer)) {
+        std::cerr << "Text atlas unavailable, falling back to per-frame text rendering" << std::endl;
+    }
+    loadScreenTextures(renderer);
+    if (!initCompositor(renderer)) {
+        std::cerr << "Layer cache unavailable, drawing every layer each frame" << std::endl;
+    }
+    if (!initTransitions(renderer)) {
+        std::cerr << "Screen transitions disabled" << std::endl;
+    }
+    initSpriteCache();
+    registerInputHandlers();
     
     // Load backgrounds
     std::vector<Background> backgrounds = loadBackgrounds(renderer);
-    WeatherType currentWeather = WeatherType::SUNNY;
-    DayNightType currentDayNight = DayNightType::DAY;
-    Uint32 lastWeatherChange = SDL_GetTicks();
     
-    // Load plants
-    std::vector<Plant> plants = loadPlants(renderer);
+    // Species metadata; plants and the store look everything up here
+    if (!loadPlantCatalog()) {
+        std::cerr << "Plant catalog unavailable, no plants to grow" << std::endl;
+    }
     
-    // Create game state data
-    GameStateData state;
+    // The game state belongs to the simulation thread once it starts
+    Simulation sim;
+    GameStateData& state = sim.state;
     state.currentState = GameState::INTRO;
-    // Move plants into state instead of assignment
-    state.plants = std::move(plants);
-    
-    // Menu view state variables
-    int currentPage = 0;
-    int plantsPerPage = MENU_GRID_ROWS * MENU_GRID_COLS;
-    std::vector<Button> menuGridButtons;
-    
-    // Update menu grid buttons based on the current page
-    auto updateMenuGrid = [&]() {
-        menuGridButtons.clear();
-        int itemWidth = (SCREEN_WIDTH - (MENU_GRID_COLS + 1) * MENU_ITEM_PADDING) / MENU_GRID_COLS;
-        int itemHeight = itemWidth;
-        
-        for (int row = 0; row < MENU_GRID_ROWS; row++) {
-            for (int col = 0; col < MENU_GRID_COLS; col++) {
-                int index = currentPage * plantsPerPage + row * MENU_GRID_COLS + col;
-                if (index < state.plants.size()) {
-                    int x = MENU_ITEM_PADDING + col * (itemWidth + MENU_ITEM_PADDING);
-                    int y = MENU_ITEM_PADDING + row * (itemHeight + MENU_ITEM_PADDING);
-                    Button button = {{x, y, itemWidth, itemHeight}, false};
-                    menuGridButtons.push_back(button);
-                }
+    state.plants = loadPlants();
+    
+    // Restore coins, sold plants and growth from the last session
+    if (openSaveGame(state, savePath)) {
+        std::cout << "Loaded save: " << state.player.coins << " coins, " << state.plants.size() << " plants" << std::endl;
+    }
+    rebuildInventoryIndex(state.plants);
+    
+    // Hit masks for the plants, so a tap never decodes a sprite
+    std::vector<int> plantCatalogIds;
+    for (const Plant& plant : state.plants) {
+        plantCatalogIds.push_back(plant.catalogId);
+    }
+    buildSpeciesMasks(plantCatalogIds.data(), static_cast<int>(plantCatalogIds.size()));
+    
+    // Sprites by catalog id (the catalog is sorted by id), bound on first draw
+    int spriteSlots = speciesCount() > 0 ? speciesAt(speciesCount() - 1).id + 1 : 0;
+    std::vector<PlantSprite> plantSprites(spriteSlots);
+    int neighbourCatalogIds[2] = {0, 0};   // Neighbours of the plant on view while a swipe may be under way
+    
+    // Free sprites that weren't drawn this frame or the last when the sprite
+    // budget is exceeded; a page of sprites never evicts its own members
+    setEvictionHandler(MemoryCategory::PLANT_SPRITE, [&](size_t bytesToFree, SDL_Texture* keep) {
+        size_t freed = 0;
+        for (size_t id = 0; id < plantSprites.size() && freed < bytesToFree; id++) {
+            PlantSprite& sprite = plantSprites[id];
+            if (!sprite.texture || sprite.texture == keep || sprite.pinned ||
+                sprite.lastUsedFrame + 1 >= gRenderFrame ||
+                static_cast<int>(id) == neighbourCatalogIds[0] || static_cast<int>(id) == neighbourCatalogIds[1] ||
+                trackedCategory(sprite.texture) != MemoryCategory::PLANT_SPRITE) {
+                continue;
             }
+            freed += textureBytes(sprite.texture);
+            destroyTrackedTexture(sprite.texture);
+            sprite.texture = nullptr;
         }
-    };
+        return freed;
+    });
+    
+    // Sprites GameBoy mode would have to dither (no packed 2bpp copy)
+    // allocate as they load, so they are bound now rather than on first draw
+    reserveIndexedTextures(plantSprites.size());
+    for (int i = 0; i < speciesCount(); i++) {
+        const PlantSpecies& species = speciesAt(i);
+        if (isQuantizedAtLoad(speciesSprite(species))) {
+            ensurePlantSprite(renderer, plantSprites, species.id);
+            plantSprites[species.id].pinned = true;
+        }
+    }
+    
+    // Weather overlays are drawn behind the plant, effects (confetti,
+    // sparkles) on top
+    WeatherOverlay weatherOverlay;
+    if (!weatherOverlay.init(renderer)) {
+        std::cerr << "Weather overlays disabled" << std::endl;
+    }
     
-    // Initialize the menu grid
-    updateMenuGrid();
-    
-    // Initialize navigation buttons
-    navButtons.prevPlantButton = {{5, SCREEN_HEIGHT - TOOLBAR_HEIGHT + 5, 
-                                  MENU_BUTTON_SIZE, MENU_BUTTON_SIZE}, false};
-    navButtons.nextPlantButton = {{5 + MENU_BUTTON_SIZE, SCREEN_HEIGHT - TOOLBAR_HEIGHT + 5, 
-                                  MENU_BUTTON_SIZE, MENU_BUTTON_SIZE}, false};
-    navButtons.mapButton = {{SCREEN_WIDTH - MENU_BUTTON_SIZE - 5, 
-                           SCREEN_HEIGHT - TOOLBAR_HEIGHT + 5, 
-                           MENU_BUTTON_SIZE, MENU_BUTTON_SIZE}, false};
-    
-    // Initialize location buttons for map screen
-    std::vector<Button> locationButtons;
-    const int LOCATION_BUTTON_SIZE = 40;
-    const int PADDING = 10;
-    
-    // House (top left)
-    locationButtons.push_back({{PADDING, PADDING, LOCATION_BUTTON_SIZE, LOCATION_BUTTON_SIZE}, false});
-    // Greenhouse (top right)
-    locationButtons.push_back({{SCREEN_WIDTH - LOCATION_BUTTON_SIZE - PADDING, PADDING, 
-                               LOCATION_BUTTON_SIZE, LOCATION_BUTTON_SIZE}, false});
-    // Pasture (bottom left)
-    locationButtons.push_back({{PADDING, SCREEN_HEIGHT - LOCATION_BUTTON_SIZE - PADDING, 
-                               LOCATION_BUTTON_SIZE, LOCATION_BUTTON_SIZE}, false});
-    // Store (bottom right)
-    locationButtons.push_back({{SCREEN_WIDTH - LOCATION_BUTTON_SIZE - PADDING, 
-                               SCREEN_HEIGHT - LOCATION_BUTTON_SIZE - PADDING, 
-                               LOCATION_BUTTON_SIZE, LOCATION_BUTTON_SIZE}, false});
-    
-    // Setup raindrops for animation
-    const int MAX_RAINDROPS = 100;
-    std::vector<Raindrop> raindrops(MAX_RAINDROPS);
-    
-    // Initialize raindrops
-    for (int i = 0; i < MAX_RAINDROPS; i++) {
-        raindrops[i].x = rand() % SCREEN_WIDTH;
-        raindrops[i].y = rand() % SCREEN_HEIGHT;
-        raindrops[i].speed = 2.0f + (rand() % 20) / 10.0f;
-        raindrops[i].length = 5 + rand() % 10;
+    if (!initRenderSnapshots(EFFECT_PARTICLE_CAPACITY) || !initSimulation(sim)) {
+        std::cerr << "Unable to start the simulation!" << std::endl;
+        shutdownJobSystem();
+        display->shutdown();
+        IMG_Quit();
+        SDL_Quit();
+        return 1;
     }
     
     // Main loop flag
@@ -243,217 +378,249 @@ int main(int argc, char* args[]) {
     // Color palette
     ColorPalette palette;
     
-    // Main loop
+    // Pointer events go straight from SDL's event pump to the simulation
+    if (!initInputQueue(*display)) {
+        std::cerr << "Input queue unavailable, taps are ignored" << std::endl;
+    }
+    
+    // A replay quits on its own once the last event has had time to show
+    bool replaying = !replayPath.empty() && loadInputReplay(replayPath);
+    
+    // The thread is started before the heap is locked; creating it allocates
+    startSimulationThread(sim);
+    
+    // Everything the loop needs is allocated; from here on frames run out of
+    // the frame arena and preallocated storage
+    lockHeap();
+    
+    // Render loop: pump events for the simulation and draw each snapshot it
+    // publishes, while it works on the next one
+    bool redraw = false;
+    GameState shownState = GameState::INTRO;   // Screen in the last presented frame
     while (!quit) {
+        frameArena().reset();
+        
+        // SDL work handed back from the job system
+        runMainThreadJobs();
+        
+        // Input held back while the simulation's queue was full
+        flushInputEvents();
+        
+        if (replaying) {
+            pumpInputReplay();
+            if (inputReplayFinished()) {
+                quit = true;
+            }
+        }
+        
         // Handle events on queue
-        while (SDL_PollEvent(&e) != 0) {
+        while (input.pollEvent(e)) {
             if (e.type == SDL_QUIT) {
                 quit = true;
             }
-            else if (e.type == SDL_MOUSEBUTTONDOWN) {
-                int mouseX = e.button.x;
-                int mouseY = e.button.y;
-                
-                if (state.currentState == GameState::INTRO) {
-                    player.selectedPlantIndex = 0;
-                    state.currentState = GameState::PLANT_VIEW;
-                }
-                else if (state.currentState == GameState::PLANT_VIEW) {
-                    // Handle plant navigation
-                    if (navButtons.prevPlantButton.contains(mouseX, mouseY)) {
-                        player.selectedPlantIndex = (player.selectedPlantIndex - 1 + state.plants.size()) % state.plants.size();
-                    }
-                    else if (navButtons.nextPlantButton.contains(mouseX, mouseY)) {
-                        player.selectedPlantIndex = (player.selectedPlantIndex + 1) % state.plants.size();
-                    }
-                    else if (navButtons.mapButton.contains(mouseX, mouseY)) {
-                        state.currentState = GameState::MAP_VIEW;
-                    } else if (navButtons.storeButton.contains(mouseX, mouseY)) {
-                        state.currentState = GameState::STORE_VIEW;
-                        resetStoreState(state);
-                    }
-                }
-                else if (state.currentState == GameState::INVENTORY_VIEW) {
-                    // Check if a plant was clicked in inventory
-                    for (size_t i = 0; i < inventoryGridButtons.size(); i++) {
-                        if (inventoryGridButtons[i].contains(mouseX, mouseY)) {
-                            player.selectedPlantIndex = currentPage * plantsPerPage + i;
-                            state.currentState = GameState::PLANT_VIEW;
-                            break;
-                        }
-                    }
-                    // Handle pagination
-                    if (prevPageButton.contains(mouseX, mouseY)) {
-                        currentPage = std::max(0, currentPage - 1);
-                        updateMenuGrid();
-                    }
-                    else if (nextPageButton.contains(mouseX, mouseY)) {
-                        currentPage = std::min(static_cast<int>((state.plants.size() - 1) / plantsPerPage), currentPage + 1);
-                        updateMenuGrid();
-                    }
-                }
-                else if (state.currentState == GameState::MAP_VIEW) {
-                    // Handle location button clicks
-                    for (size_t i = 0; i < locationButtons.size(); i++) {
-                        if (locationButtons[i].contains(mouseX, mouseY)) {
-                            switch (i) {
-                                case 0: // House
-                                    state.currentState = GameState::PLANT_VIEW; // Home goes to plant view
-                                    break;
-                                case 1: // Greenhouse
-                                    state.currentState = GameState::INVENTORY_VIEW; // Greenhouse shows all plants
-                                    break;
-                                case 2: // Pasture
-                                    state.currentState = GameState::PASTURE_VIEW;
-                                    break;
-                                case 3: // Store
-                                    state.currentState = GameState::STORE_VIEW;
-                                    break;
-                            }
-                            break;
-                        }
-                    }
-                    // Handle back button
-                    Button backButton = {{5, SCREEN_HEIGHT - TOOLBAR_HEIGHT + 5, MENU_BUTTON_SIZE, MENU_BUTTON_SIZE}, false};
-                    if (backButton.contains(mouseX, mouseY)) {
-                        state.currentState = GameState::PLANT_VIEW;
-                    }
-                }
-                else if (state.currentState == GameState::HOUSE_VIEW || state.currentState == GameState::GREENHOUSE_VIEW || 
-                         state.currentState == GameState::PASTURE_VIEW || state.currentState == GameState::STORE_VIEW) {
-                    Button backButton = {{5, SCREEN_HEIGHT - TOOLBAR_HEIGHT + 5, MENU_BUTTON_SIZE, MENU_BUTTON_SIZE}, false};
-                    if (backButton.contains(mouseX, mouseY)) {
-                        state.currentState = GameState::MAP_VIEW;
-                    }
-                    
-                    // Handle store interactions
-                    if (state.currentState == GameState::STORE_VIEW) {
-                        handleStoreInteraction(state, mouseX, mouseY);
-                    }
+            else if (e.type == SDL_RENDER_TARGETS_RESET || e.type == SDL_RENDER_DEVICE_RESET) {
+                // Target contents are lost; redraw the cached layers and sprites
+                invalidateLayers();
+                clearSpriteCache();
+                cancelTransition();
+                redraw = true;
+            }
+            else if (e.type == SDL_KEYDOWN) {
+                if (e.key.keysym.sym == SDLK_ESCAPE) {
+                    quit = true;
+                } else if (e.key.keysym.sym == SDLK_m) {
+                    logMemoryReport();
                 }
             }
         }
         
-        // Get current time for animations and timers
-        Uint32 currentTime = SDL_GetTicks();
+        // Nothing new to draw until the simulation publishes again
+        bool fresh = false;
+        const RenderSnapshot* snapshot = acquireSnapshot(fresh);
+        if (!snapshot || (!fresh && !redraw)) {
+            SDL_Delay(1);
+            continue;
+        }
+        const RenderSnapshot& frame = *snapshot;
+        redraw = false;
+        gRenderFrame++;
         
-        // Check if it's time to change weather
-        if (currentTime - lastWeatherChange >= WEATHER_CHANGE_INTERVAL) {
-            currentWeather = static_cast<WeatherType>(rand() % 4);
-            lastWeatherChange = currentTime;
+        // New screen: keep the frame on screen now as the outgoing one
+        if (frame.currentState != shownState) {
+            beginTransition(renderer, display->getCanvas(), transitionStyle(shownState, frame.currentState));
+            shownState = frame.currentState;
         }
         
-        // Update day/night based on system time
-        time_t now = time(0);
-        struct tm *ltm = localtime(&now);
-        int hour = ltm->tm_hour;
+        // Grade the backgrounds; only redone when the weather or the
+        // dusk/dawn transition step changes
+        gradeBackgrounds(backgrounds, frame.grade);
         
-        // Set day/night based on hour (e.g., 6 AM to 6 PM is day)
-        currentDayNight = (hour >= 6 && hour < 18) ? DayNightType::DAY : DayNightType::NIGHT;
+        // In GameBoy mode weather and time of day are a palette swap; the
+        // cached layers hold the old colours
+        if (updateShadePalette(palette, frame.weather, frame.dayNight)) {
+            invalidateLayers();
+            clearSpriteCache();
+        }
         
-        // Update raindrops if weather is rainy
-        if (currentWeather == WeatherType::RAINY) {
-            for (auto& drop : raindrops) {
-                drop.y += drop.speed;
-                if (drop.y > SCREEN_HEIGHT) {
-                    drop.y = -drop.length;
-                    drop.x = rand() % SCREEN_WIDTH;
-                }
-            }
+        // Neighbour sprites decoded in the background, at most one upload a frame
+        for (SpritePrefetch& prefetch : gSpritePrefetches) {
+            if (completeSpritePrefetch(renderer, plantSprites, prefetch, false)) break;
         }
         
-        // Clear screen
-        SDL_SetRenderDrawColor(renderer, palette.background.r, palette.background.g, palette.background.b, palette.background.a);
-        SDL_RenderClear(renderer);
+        display->beginFrame();
+        
+        if (transitionRunning()) {
+            // Mid-transition frames are copies of the two captured screens
+            drawTransition(renderer);
+        } else {
+            // Clear screen
+            SDL_SetRenderDrawColor(renderer, palette.background.r, palette.background.g, palette.background.b, palette.background.a);
+            SDL_RenderClear(renderer);
         
-        // Render the current state
-        switch (state.currentState) {
-            case GameState::INTRO:
-                renderIntroScreen(renderer, palette);
-                break;
+            // Render the current state
+            switch (frame.currentState) {
+                case GameState::INTRO:
+                    renderIntroScreen(renderer, palette);
+                    break;
                 
-            case GameState::PLANT_VIEW:
-                if (player.selectedPlantIndex >= 0 && player.selectedPlantIndex < state.plants.size()) {
-                    renderPlantViewScreen(renderer, palette, state.plants[player.selectedPlantIndex], player,
-                                         navButtons, currentWeather, currentDayNight,
-                                         backgrounds, raindrops);
-                } else {
-                    // If no plant is selected, go back to inventory view
-                    state.currentState = GameState::INVENTORY_VIEW;
-                }
-                break;
+                case GameState::PLANT_VIEW:
+                    // The simulation leaves the plant view when no plant is selected
+                    if (frame.hasFocus) {
+                        ensurePlantSprite(renderer, plantSprites, frame.focus.catalogId);
+                        // Decode the neighbours in the background the moment a
+                        // swipe may start. GameBoy sprites are expanded from
+                        // packed shades here instead, one a frame.
+                        bool boundNeighbour = false;
+                        for (int i = 0; i < 2; i++) {
+                            neighbourCatalogIds[i] = frame.hasNeighbours ? frame.neighbours[i].catalogId : 0;
+                            if (!frame.hasNeighbours) continue;
+                            if (!isGameboyMode()) {
+                                prefetchPlantSprite(plantSprites, neighbourCatalogIds[i]);
+                            } else if (!boundNeighbour && !plantSprites[neighbourCatalogIds[i]].texture) {
+                                ensurePlantSprite(renderer, plantSprites, neighbourCatalogIds[i]);
+                                boundNeighbour = true;
+                            }
+                        }
+                        renderPlantViewScreen(renderer, palette, frame, plantSprites, backgrounds, weatherOverlay);
+                    }
+                    break;
                 
-            case GameState::INVENTORY_VIEW:
-                renderMenuViewScreen(renderer, palette, state.plants, player, inventoryGridButtons,
-                                   prevPageButton, nextPageButton, currentPage, plantsPerPage);
-                break;
+                case GameState::INVENTORY_VIEW:
+                    for (int i = 0; i < frame.pagePlantCount; i++) {
+                        ensurePlantSprite(renderer, plantSprites, frame.page[i].catalogId);
+                    }
+                    renderMenuViewScreen(renderer, palette, frame, plantSprites);
+                    break;
                 
-            case GameState::MAP_VIEW:
-                renderMapScreen(renderer, palette, locationButtons);
-                break;
+                case GameState::MAP_VIEW:
+                    renderMapScreen(renderer, palette);
+                    break;
                 
-            case GameState::HOUSE_VIEW:
-                renderLocationScreen(renderer, palette, "House", {139, 69, 19, 255}, 
-                                   {{5, SCREEN_HEIGHT - TOOLBAR_HEIGHT + 5, MENU_BUTTON_SIZE, MENU_BUTTON_SIZE}, false});
-                break;
+                case GameState::HOUSE_VIEW:
+                    renderLocationScreen(renderer, palette, "House", {139, 69, 19, 255});
+                    break;
                 
-            case GameState::GREENHOUSE_VIEW:
-                renderLocationScreen(renderer, palette, "Greenhouse", {34, 139, 34, 255},
-                                   {{5, SCREEN_HEIGHT - TOOLBAR_HEIGHT + 5, MENU_BUTTON_SIZE, MENU_BUTTON_SIZE}, false});
-                break;
+                case GameState::GREENHOUSE_VIEW:
+                    renderLocationScreen(renderer, palette, "Greenhouse", {34, 139, 34, 255});
+                    break;
                 
-            case GameState::PASTURE_VIEW:
-                renderLocationScreen(renderer, palette, "Pasture", {144, 238, 144, 255},
-                                   {{5, SCREEN_HEIGHT - TOOLBAR_HEIGHT + 5, MENU_BUTTON_SIZE, MENU_BUTTON_SIZE}, false});
-                break;
+                case GameState::PASTURE_VIEW:
+                    renderLocationScreen(renderer, palette, "Pasture", {144, 238, 144, 255});
+                    break;
                 
-            case GameState::STORE_VIEW:
-                renderStoreScreen(renderer, palette, state.plants, player,
-                                 state.storeState.backButton,
-                                 state.storeState.shopkeeperText,
-                                 state.storeState.yesButton,
-                                 state.storeState.noButton,
-                                 state.storeState.selectedPlantIndex,
-                                 state.storeState.offerAmount);
-                break;
+                case GameState::STORE_VIEW:
+                    if (frame.hasOffer) {
+                        ensurePlantSprite(renderer, plantSprites, frame.offerPlant.catalogId);
+                    }
+                    renderStoreScreen(renderer, palette, frame, plantSprites);
+                    break;
                 
-            default:
-                renderIntroScreen(renderer, palette);
-                break;
+                default:
+                    renderIntroScreen(renderer, palette);
+                    break;
+            }
+            
+            // The first frame of a new screen is only captured; the outgoing
+            // screen stays up while it loads
+            if (transitionWaitingForIncoming()) {
+                captureIncoming(renderer, display->getCanvas());
+            }
         }
         
+        // Effects go over every screen
+        frame.effects.render(renderer);
+        
+        // Input that arrived while drawing reaches the simulation before
+        // present() waits on the display
+        pumpInputEvents();
+        
         // Update screen
-        SDL_RenderPresent(renderer);
+        display->present();
         
-        // Cap frame rate
-        SDL_Delay(16);
+        // A tap that changes screens shows on the first frame with any of
+        // the new screen in it, not on the frames that still show only the
+        // old one; the rest of the animation isn't counted as latency.
+        // Later frames report every input up to theirs.
+        if (transitionShowsIncoming()) {
+            latencyFramePresented(frame.inputId);
+        }
     }
     
+    stopSimulationThread();
+    shutdownInputQueue();
+    unlockHeap();
+    closeSaveGame(state);
+    shutdownJobSystem();
+    
     // Cleanup and exit
+    display->logStats();
+    logAssetStats();
+    logGradeStats();
+    logCompositorStats();
+    logTransitionStats();
+    logSpriteCacheStats();
+    logInputStats();
+    logInputQueueStats();
+    logGestureStats();
+    logLatencyStats();
+    logSaveStats();
+    logPlantCatalogStats();
+    logInventoryIndexStats();
+    logJobStats();
+    logSimulationStats();
+    logRenderSnapshotStats();
+    logMemoryReport();
     SDL_StopTextInput();
+    cleanupTextAtlas();
+    cleanupScreenTextures();
+    cleanupCompositor();
+    cleanupTransitions();
+    weatherOverlay.cleanup();
+    clearSpriteCache();
     cleanupFont();
     
     // Clean up plant textures
-    for (auto& plant : state.plants) {
-        if (plant.texture) {
-            SDL_DestroyTexture(plant.texture);
-            plant.texture = nullptr;
+    for (SpritePrefetch& prefetch : gSpritePrefetches) {
+        completeSpritePrefetch(renderer, plantSprites, prefetch, true);
+    }
+    for (PlantSprite& sprite : plantSprites) {
+        if (sprite.texture) {
+            destroyTrackedTexture(sprite.texture);
+            sprite.texture = nullptr;
         }
     }
     
     // Clean up background textures
     for (auto& bg : backgrounds) {
         if (bg.texture) {
-            SDL_DestroyTexture(bg.texture);
+            destroyTrackedTexture(bg.texture);
             bg.texture = nullptr;
         }
     }
     
     // Clean up SDL resources
-    SDL_DestroyRenderer(renderer);
+    display->shutdown();
     renderer = nullptr;
-    SDL_DestroyWindow(window);
-    window = nullptr;
     IMG_Quit();
     SDL_Quit();
     
@@ -464,24 +631,29 @@ void generateOffer(GameStateData& state) {
     // Random number generator for offer amount
     std::random_device rd;
     std::mt19937 gen(rd());
-    std::uniform_int_distribution<> dis(50, 200);
-    state.storeState.offerAmount = dis(gen);
+    // The species sets the price band; well grown plants fetch more
+    const Plant& plant = state.plants[state.storeState.selectedPlantIndex];
+    const PlantSpecies* species = findSpecies(plant.catalogId);
+    std::uniform_int_distribution<> dis(species ? species->priceMin : 50, species ? species->priceMax : 200);
+    state.storeState.offerAmount = dis(gen) + plant.growth;
 
     // Get the selected plant's name
-    std::string plantName = state.plants[state.storeState.selectedPlantIndex].name;
+    const char* plantName = plant.name.c_str();
 
     // Generate text based on offer amount
+    char text[SHOPKEEPER_TEXT_CAPACITY];
     if (state.storeState.offerAmount > 150) {
-        state.storeState.shopkeeperText = "Wow, that " + plantName + " looks amazing! I'll give you a great price!";
+        snprintf(text, sizeof(text), "Wow, that %s looks amazing! I'll give you a great price!", plantName);
     } else if (state.storeState.offerAmount > 100) {
-        state.storeState.shopkeeperText = "Hmm, that " + plantName + " is in good shape. I can offer a fair price.";
+        snprintf(text, sizeof(text), "Hmm, that %s is in good shape. I can offer a fair price.", plantName);
     } else {
-        state.storeState.shopkeeperText = "Well, that " + plantName + " has seen better days... here's what I can offer.";
+        snprintf(text, sizeof(text), "Well, that %s has seen better days... here's what I can offer.", plantName);
     }
+    state.storeState.shopkeeperText.assign(text);
 }
 
-void handleStoreInteraction(GameStateData& state, int x, int y) {
-    if (state.storeState.backButton.contains(x, y)) {
+void handleStoreInteraction(GameStateData& state, UiAction action) {
+    if (action == UiAction::BACK) {
         state.currentState = GameState::MAP_VIEW;
         resetStoreState(state);
         return;
@@ -489,10 +661,10 @@ void handleStoreInteraction(GameStateData& state, int x, int y) {
 
     if (!state.storeState.isAskingToSell && !state.storeState.isShowingOffer) {
         // Initial state - ask if they want to sell
-        if (state.storeState.yesButton.contains(x, y)) {
+        if (action == UiAction::STORE_YES) {
             state.storeState.isAskingToSell = true;
             // Select a random owned plant
-            std::vector<int> ownedIndices;
+            FrameVector<int> ownedIndices;
             for (size_t i = 0; i < state.plants.size(); i++) {
                 if (state.plants[i].isOwned) {
                     ownedIndices.push_back(i);
@@ -509,66 +681,232 @@ void handleStoreInteraction(GameStateData& state, int x, int y) {
                 state.storeState.shopkeeperText = "You don't have any plants to sell!";
                 state.storeState.isAskingToSell = false;
             }
-        } else if (state.storeState.noButton.contains(x, y)) {
+        } else if (action == UiAction::STORE_NO) {
             state.currentState = GameState::MAP_VIEW;
             resetStoreState(state);
         }
     } else if (state.storeState.isShowingOffer) {
         // Showing offer state
-        if (state.storeState.yesButton.contains(x, y)) {
+        if (action == UiAction::STORE_YES) {
             // Accept offer
             if (state.storeState.selectedPlantIndex >= 0 && 
                 state.storeState.selectedPlantIndex < state.plants.size()) {
-                std::string soldPlantName = state.plants[state.storeState.selectedPlantIndex].name;
-                
-                // Add coins to player's balance
-                state.player.coins += state.storeState.offerAmount;
+                char text[SHOPKEEPER_TEXT_CAPACITY];
+                snprintf(text, sizeof(text), "Great! %s will have a good home. Come back soon!",
+                         state.plants[state.storeState.selectedPlantIndex].name.c_str());
                 
-                // Clean up the plant's texture before removing it
-                if (state.plants[state.storeState.selectedPlantIndex].texture) {
-                    SDL_DestroyTexture(state.plants[state.storeState.selectedPlantIndex].texture);
-                }
+                int catalogId = state.plants[state.storeState.selectedPlantIndex].catalogId;
+                sellPlant(state, state.storeState.selectedPlantIndex, state.storeState.offerAmount);
+                journalChange(state, JournalOp::SALE, catalogId, state.storeState.offerAmount);
+                // The slot now holds the plant moved in from the end
+                state.storeState.selectedPlantIndex = -1;
+                state.storeState.offerAmount = 0;
                 
-                // Remove the plant from the vector
-                state.plants.erase(state.plants.begin() + state.storeState.selectedPlantIndex);
-                
-                // Update selected plant index if needed
-                if (state.player.selectedPlantIndex >= state.plants.size()) {
-                    state.player.selectedPlantIndex = std::max(0, static_cast<int>(state.plants.size()) - 1);
-                } else if (state.player.selectedPlantIndex > state.storeState.selectedPlantIndex) {
-                    state.player.selectedPlantIndex--; // Adjust for removed plant
-                }
-                
-                state.storeState.shopkeeperText = "Great! " + soldPlantName + " will have a good home. Come back soon!";
+                state.storeState.shopkeeperText.assign(text);
                 state.storeState.isShowingOffer = false;
-                // Reset after a delay
-                SDL_Delay(2000);
-                state.currentState = GameState::MAP_VIEW;
-                resetStoreState(state);
+                // Leave once the answer has been read
+                state.storeState.replyUntil = std::max<Uint32>(1, SDL_GetTicks() + STORE_REPLY_MS);
+                state.storeState.leaveAfterReply = true;
             }
-        } else if (state.storeState.noButton.contains(x, y)) {
+        } else if (action == UiAction::STORE_NO) {
             // Reject offer
-            std::string rejectedPlantName = state.plants[state.storeState.selectedPlantIndex].name;
-            state.storeState.shopkeeperText = "No deal on the " + rejectedPlantName + "? Maybe next time!";
+            char text[SHOPKEEPER_TEXT_CAPACITY];
+            snprintf(text, sizeof(text), "No deal on the %s? Maybe next time!",
+                     state.plants[state.storeState.selectedPlantIndex].name.c_str());
+            state.storeState.shopkeeperText.assign(text);
             state.storeState.isShowingOffer = false;
-            // Reset after a delay
-            SDL_Delay(2000);
-            resetStoreState(state);
+            // Start over once the answer has been read
+            state.storeState.replyUntil = std::max<Uint32>(1, SDL_GetTicks() + STORE_REPLY_MS);
         }
     }
 }
 
+void updateStore(GameStateData& state, Uint32 currentTime) {
+    StoreState& store = state.storeState;
+    if (store.replyUntil == 0 || static_cast<int32_t>(currentTime - store.replyUntil) < 0) return;
+    if (store.leaveAfterReply && state.currentState == GameState::STORE_VIEW) {
+        state.currentState = GameState::MAP_VIEW;
+    }
+    resetStoreState(state);
+}
+
+void sellPlant(GameStateData& state, int plantIndex, int price) {
+    // Add coins to player's balance
+    state.player.coins += price;
+    
+    // Move the last plant into the sold one's slot so no other plant
+    // changes index; the inventory order comes from the index, not the
+    // vector
+    int lastIndex = static_cast<int>(state.plants.size()) - 1;
+    if (plantIndex != lastIndex) {
+        state.plants[plantIndex] = std::move(state.plants[lastIndex]);
+    }
+    state.plants.pop_back();
+    inventoryPlantRemoved(plantIndex, lastIndex);
+    
+    // Follow the selected plant if it was the one moved
+    int& selected = state.player.selectedPlantIndex;
+    if (selected == lastIndex) {
+        selected = plantIndex;
+    }
+    if (selected >= static_cast<int>(state.plants.size())) {
+        selected = std::max(0, static_cast<int>(state.plants.size()) - 1);
+    }
+}
+
+void buyPlant(GameStateData& state, int plantIndex, int price) {
+    state.player.coins -= price;
+    state.plants[plantIndex].isOwned = true;
+    inventoryPlantChanged(state.plants, plantIndex);
+}
+
 void resetStoreState(GameStateData& state) {
     state.storeState.isAskingToSell = false;
     state.storeState.isShowingOffer = false;
     state.storeState.selectedPlantIndex = -1;
     state.storeState.offerAmount = 0;
     state.storeState.shopkeeperText = "Welcome! I'm interested in buying plants. Want to sell?";
-    
-    // Initialize back button
-    state.storeState.backButton = {{5, SCREEN_HEIGHT - TOOLBAR_HEIGHT + 5, MENU_BUTTON_SIZE, MENU_BUTTON_SIZE}, false};
-    
-    // Initialize Yes/No buttons with default positions (will be updated in render)
-    state.storeState.yesButton = {{0, 0, 40, 20}, false};
-    state.storeState.noButton = {{0, 0, 40, 20}, false};
-} 
\ No newline at end of file
+    state.storeState.replyUntil = 0;
+    state.storeState.leaveAfterReply = false;
+}
+
+// Tap handlers, one per screen
+
+static void handleIntroTap(InputContext& context, const HitTarget& target) {
+    // Any tap starts the game
+    context.state.player.selectedPlantIndex = 0;
+    context.state.currentState = GameState::PLANT_VIEW;
+}
+
+// Next or previous plant in the inventory's sort order, wrapping around.
+// Plants hidden by the filter step through the unfiltered order instead.
+int neighbourPlant(const GameStateData& state, int plantIndex, int step) {
+    int count = static_cast<int>(state.plants.size());
+    if (count == 0) return 0;
+    int position = inventoryPositionOf(plantIndex);
+    if (position < 0 || inventoryCount() == 0) {
+        return (plantIndex + step + count) % count;
+    }
+    return inventoryPlantAt((position + step + inventoryCount()) % inventoryCount());
+}
+
+static void handlePlantViewTap(InputContext& context, const HitTarget& target) {
+    GameStateData& state = context.state;
+    Player& player = context.state.player;
+    switch (target.action) {
+        case UiAction::PREV_PLANT:
+        case UiAction::NEXT_PLANT:
+            player.selectedPlantIndex = neighbourPlant(state, player.selectedPlantIndex,
+                                                       target.action == UiAction::NEXT_PLANT ? 1 : -1);
+            context.effects.burstSparkles(PLANT_SPARKLE_AREA, SPARKLE_BURST_COUNT);
+            break;
+        case UiAction::OPEN_MAP:
+            state.currentState = GameState::MAP_VIEW;
+            break;
+        case UiAction::OPEN_STORE:
+            state.currentState = GameState::STORE_VIEW;
+            resetStoreState(state);
+            break;
+        default:
+            break;
+    }
+}
+
+static void handleInventoryTap(InputContext& context, const HitTarget& target) {
+    GameStateData& state = context.state;
+    int& currentPage = context.currentPage;
+    if (target.action == UiAction::INVENTORY_CELL) {
+        // Cells past the last plant are empty, and taps on transparent
+        // parts of the sprite miss
+        int plantIndex = inventoryPlantAt(currentPage * PLANTS_PER_PAGE + target.index);
+        const SpeciesHitMask* hit = plantIndex >= 0 ? speciesHitMask(state.plants[plantIndex].catalogId) : nullptr;
+        if (hit && alphaMaskHit(hit->mask,
+                                inventoryPlantRect(INVENTORY_GRID[target.index].rect, hit->spriteWidth,
+                                                   hit->spriteHeight),
+                                target.x, target.y)) {
+            context.state.player.selectedPlantIndex = plantIndex;
+            state.currentState = GameState::PLANT_VIEW;
+        }
+    } else if (target.action == UiAction::PREV_PAGE) {
+        currentPage = std::max(0, currentPage - 1);
+    } else if (target.action == UiAction::NEXT_PAGE && inventoryCount() > 0) {
+        currentPage = std::min((inventoryCount() - 1) / PLANTS_PER_PAGE, currentPage + 1);
+    } else if (target.action == UiAction::SORT_ORDER) {
+        // Growth and value read best first
+        InventoryView view = getInventoryView();
+        view.sort = static_cast<InventorySort>((static_cast<int>(view.sort) + 1) % INVENTORY_SORT_COUNT);
+        view.descending = view.sort == InventorySort::GROWTH || view.sort == InventorySort::VALUE;
+        setInventoryView(view);
+        currentPage = 0;
+    } else if (target.action == UiAction::WEATHER_FILTER) {
+        // All, then each weather in turn
+        InventoryView view = getInventoryView();
+        view.weatherFilter = view.weatherFilter + 1 < WEATHER_COUNT ? view.weatherFilter + 1 : INVENTORY_FILTER_ALL;
+        setInventoryView(view);
+        currentPage = 0;
+    }
+}
+
+static void handleMapTap(InputContext& context, const HitTarget& target) {
+    // Screen opened by each location button, in MAP_LOCATION_BUTTONS order
+    static const GameState LOCATION_STATES[LOCATION_COUNT] = {
+        GameState::PLANT_VIEW,      // House goes to plant view
+        GameState::INVENTORY_VIEW,  // Greenhouse shows all plants
+        GameState::PASTURE_VIEW,
+        GameState::STORE_VIEW
+    };
+    if (target.action == UiAction::LOCATION) {
+        context.state.currentState = LOCATION_STATES[target.index];
+    } else if (target.action == UiAction::BACK) {
+        context.state.currentState = GameState::PLANT_VIEW;
+    }
+}
+
+static void handleLocationTap(InputContext& context, const HitTarget& target) {
+    if (target.action == UiAction::BACK) {
+        context.state.currentState = GameState::MAP_VIEW;
+    }
+}
+
+static void handleStoreTap(InputContext& context, const HitTarget& target) {
+    if (target.action != UiAction::NONE) {
+        handleStoreInteraction(context.state, target.action);
+    }
+}
+
+// Register every screen's regions (from layout.h) and handler
+void registerInputHandlers() {
+    setTapHandler(GameState::INTRO, handleIntroTap);
+
+    setTapHandler(GameState::PLANT_VIEW, handlePlantViewTap);
+    addHitRegion(GameState::PLANT_VIEW, PLANT_VIEW_NAV.prevPlantButton.rect, UiAction::PREV_PLANT);
+    addHitRegion(GameState::PLANT_VIEW, PLANT_VIEW_NAV.nextPlantButton.rect, UiAction::NEXT_PLANT);
+    addHitRegion(GameState::PLANT_VIEW, PLANT_VIEW_NAV.mapButton.rect, UiAction::OPEN_MAP);
+    addHitRegion(GameState::PLANT_VIEW, PLANT_VIEW_NAV.storeButton.rect, UiAction::OPEN_STORE);
+
+    setTapHandler(GameState::INVENTORY_VIEW, handleInventoryTap);
+    for (int i = 0; i < PLANTS_PER_PAGE; i++) {
+        addHitRegion(GameState::INVENTORY_VIEW, INVENTORY_GRID[i].rect, UiAction::INVENTORY_CELL, i);
+    }
+    addHitRegion(GameState::INVENTORY_VIEW, INVENTORY_PREV_PAGE.rect, UiAction::PREV_PAGE);
+    addHitRegion(GameState::INVENTORY_VIEW, INVENTORY_NEXT_PAGE.rect, UiAction::NEXT_PAGE);
+    addHitRegion(GameState::INVENTORY_VIEW, INVENTORY_SORT_BUTTON.rect, UiAction::SORT_ORDER);
+    addHitRegion(GameState::INVENTORY_VIEW, INVENTORY_FILTER_BUTTON.rect, UiAction::WEATHER_FILTER);
+
+    setTapHandler(GameState::MAP_VIEW, handleMapTap);
+    for (int i = 0; i < LOCATION_COUNT; i++) {
+        addHitRegion(GameState::MAP_VIEW, MAP_LOCATION_BUTTONS[i].rect, UiAction::LOCATION, i);
+    }
+    addHitRegion(GameState::MAP_VIEW, BACK_BUTTON.rect, UiAction::BACK);
+
+    const GameState locations[] = {GameState::HOUSE_VIEW, GameState::GREENHOUSE_VIEW, GameState::PASTURE_VIEW};
+    for (GameState location : locations) {
+        setTapHandler(location, handleLocationTap);
+        addHitRegion(location, BACK_BUTTON.rect, UiAction::BACK);
+    }
+
+    setTapHandler(GameState::STORE_VIEW, handleStoreTap);
+    addHitRegion(GameState::STORE_VIEW, BACK_BUTTON.rect, UiAction::BACK);
+    addHitRegion(GameState::STORE_VIEW, STORE_YES_BUTTON.rect, UiAction::STORE_YES);
+    addHitRegion(GameState::STORE_VIEW, STORE_NO_BUTTON.rect, UiAction::STORE_NO);
+}
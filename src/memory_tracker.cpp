@@ -0,0 +1,469 @@
+#include <SDL2/SDL.h>
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include "../include/memory_tracker.h"
+
+namespace {
+
+// Capacity of the tracked texture table (power of two)
+const size_t MAX_TRACKED_TEXTURES = 1024;
+
+struct TrackedTexture {
+    SDL_Texture* texture;   // nullptr = empty slot
+    MemoryCategory category;
+    size_t bytes;
+};
+
+// Marks a slot whose texture was removed, so probing continues past it
+SDL_Texture* const TOMBSTONE = reinterpret_cast<SDL_Texture*>(1);
+
+struct HeapCounters {
+    std::atomic<size_t> bytes{0};
+    std::atomic<size_t> peakBytes{0};
+    std::atomic<size_t> allocations{0};
+};
+
+// Every hooked allocation is prefixed with a header holding its size,
+// padded so the returned pointer keeps the strictest fundamental alignment
+constexpr size_t HEAP_HEADER_SIZE = alignof(std::max_align_t) > sizeof(size_t)
+                                    ? alignof(std::max_align_t) : sizeof(size_t);
+
+HeapCounters gCppHeap;
+HeapCounters gSdlHeap;
+
+// Set once initialization is over; see lockHeap()
+std::atomic<bool> gHeapLocked{false};
+std::atomic<size_t> gCppAllocsAfterLock{0};
+std::atomic<size_t> gSdlAllocsAfterLock{0};
+
+SDL_malloc_func gSdlMalloc = nullptr;
+SDL_calloc_func gSdlCalloc = nullptr;
+SDL_realloc_func gSdlRealloc = nullptr;
+SDL_free_func gSdlFree = nullptr;
+
+MemoryCategoryStats gCategoryStats[static_cast<int>(MemoryCategory::COUNT)];
+EvictionHandler gEvictionHandlers[static_cast<int>(MemoryCategory::COUNT)];
+TextureReleaseHandler gTextureReleaseHandlers[MAX_TEXTURE_RELEASE_HANDLERS];
+int gTextureReleaseHandlerCount = 0;
+
+// Open-addressing table of tracked textures. A static array so that tracking
+// never allocates, even for textures created after init.
+TrackedTexture gTrackedTextures[MAX_TRACKED_TEXTURES];
+
+size_t textureSlot(SDL_Texture* texture) {
+    uintptr_t key = reinterpret_cast<uintptr_t>(texture);
+    return static_cast<size_t>((key >> 4) * 0x9E3779B97F4A7C15ull) & (MAX_TRACKED_TEXTURES - 1);
+}
+
+TrackedTexture* findTrackedTexture(SDL_Texture* texture) {
+    size_t slot = textureSlot(texture);
+    for (size_t probe = 0; probe < MAX_TRACKED_TEXTURES; probe++) {
+        TrackedTexture& entry = gTrackedTextures[(slot + probe) & (MAX_TRACKED_TEXTURES - 1)];
+        if (entry.texture == texture) return &entry;
+        if (entry.texture == nullptr) return nullptr;
+    }
+    return nullptr;
+}
+
+TrackedTexture* insertTrackedTexture(SDL_Texture* texture) {
+    size_t slot = textureSlot(texture);
+    for (size_t probe = 0; probe < MAX_TRACKED_TEXTURES; probe++) {
+        TrackedTexture& entry = gTrackedTextures[(slot + probe) & (MAX_TRACKED_TEXTURES - 1)];
+        if (entry.texture == nullptr || entry.texture == TOMBSTONE) return &entry;
+    }
+    return nullptr;
+}
+
+// Allocations made after lockHeap() break the no-heap-after-init contract
+void checkHeapLock(std::atomic<size_t>& violations, bool fatal) {
+    if (!gHeapLocked.load(std::memory_order_relaxed)) return;
+    violations.fetch_add(1, std::memory_order_relaxed);
+#ifdef PIXELPETS_NO_HEAP_AFTER_INIT
+    assert((!fatal || !"heap allocation after init"));
+#endif
+}
+
+void recordAlloc(HeapCounters& counters, size_t size) {
+    size_t current = counters.bytes.fetch_add(size, std::memory_order_relaxed) + size;
+    counters.allocations.fetch_add(1, std::memory_order_relaxed);
+    size_t peak = counters.peakBytes.load(std::memory_order_relaxed);
+    while (current > peak &&
+           !counters.peakBytes.compare_exchange_weak(peak, current, std::memory_order_relaxed)) {
+    }
+}
+
+void recordFree(HeapCounters& counters, size_t size) {
+    counters.bytes.fetch_sub(size, std::memory_order_relaxed);
+}
+
+HeapStats snapshot(const HeapCounters& counters) {
+    HeapStats stats;
+    stats.bytes = counters.bytes.load(std::memory_order_relaxed);
+    stats.peakBytes = counters.peakBytes.load(std::memory_order_relaxed);
+    stats.allocations = counters.allocations.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void* headerToUser(void* block, size_t size) {
+    *static_cast<size_t*>(block) = size;
+    return static_cast<char*>(block) + HEAP_HEADER_SIZE;
+}
+
+void* userToHeader(void* ptr) {
+    return static_cast<char*>(ptr) - HEAP_HEADER_SIZE;
+}
+
+// SDL allocation hooks
+// SDL allocates internally (render command queues, events), so allocations
+// after the lock are only counted, never asserted on
+void* SDLCALL sdlTrackedMalloc(size_t size) {
+    void* block = gSdlMalloc(size + HEAP_HEADER_SIZE);
+    if (!block) return nullptr;
+    checkHeapLock(gSdlAllocsAfterLock, false);
+    recordAlloc(gSdlHeap, size);
+    return headerToUser(block, size);
+}
+
+void* SDLCALL sdlTrackedCalloc(size_t count, size_t size) {
+    size_t total = count * size;
+    void* block = gSdlCalloc(1, total + HEAP_HEADER_SIZE);
+    if (!block) return nullptr;
+    checkHeapLock(gSdlAllocsAfterLock, false);
+    recordAlloc(gSdlHeap, total);
+    return headerToUser(block, total);
+}
+
+void* SDLCALL sdlTrackedRealloc(void* ptr, size_t size) {
+    if (!ptr) return sdlTrackedMalloc(size);
+    void* header = userToHeader(ptr);
+    size_t oldSize = *static_cast<size_t*>(header);
+    void* block = gSdlRealloc(header, size + HEAP_HEADER_SIZE);
+    if (!block) return nullptr;
+    checkHeapLock(gSdlAllocsAfterLock, false);
+    recordFree(gSdlHeap, oldSize);
+    recordAlloc(gSdlHeap, size);
+    return headerToUser(block, size);
+}
+
+void SDLCALL sdlTrackedFree(void* ptr) {
+    if (!ptr) return;
+    void* header = userToHeader(ptr);
+    recordFree(gSdlHeap, *static_cast<size_t*>(header));
+    gSdlFree(header);
+}
+
+// Try to bring a category back under budget
+void enforceBudget(MemoryCategory category, SDL_Texture* keep) {
+    MemoryCategoryStats& stats = gCategoryStats[static_cast<int>(category)];
+    if (stats.budget == 0 || stats.bytes <= stats.budget) return;
+
+    EvictionHandler& handler = gEvictionHandlers[static_cast<int>(category)];
+    if (stats.action == BudgetAction::EVICT && handler) {
+        size_t freed = handler(stats.bytes - stats.budget, keep);
+        if (stats.bytes <= stats.budget) {
+            return;
+        }
+        // What is left is in use; report once until the category fits again
+        if (stats.overBudgetEvents++ == 0) {
+            std::cerr << "Memory budget: evicted " << freed << " bytes from " << memoryCategoryName(category)
+                      << " but still over budget: " << stats.bytes << " / " << stats.budget << " bytes"
+                      << std::endl;
+        }
+        return;
+    }
+
+    // Only report the transition into the over-budget state to avoid per-frame spam
+    if (stats.overBudgetEvents++ == 0) {
+        std::cerr << "Memory budget exceeded for " << memoryCategoryName(category) << ": "
+                  << stats.bytes << " / " << stats.budget << " bytes" << std::endl;
+    }
+}
+
+} // namespace
+
+#ifdef PIXELPETS_HEAP_TRACKING
+
+// Global allocator hooks counting every C++ heap allocation
+void* operator new(size_t size) {
+    checkHeapLock(gCppAllocsAfterLock, true);
+    void* block = std::malloc(size + HEAP_HEADER_SIZE);
+    if (!block) throw std::bad_alloc();
+    recordAlloc(gCppHeap, size);
+    return headerToUser(block, size);
+}
+
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    checkHeapLock(gCppAllocsAfterLock, true);
+    void* block = std::malloc(size + HEAP_HEADER_SIZE);
+    if (!block) return nullptr;
+    recordAlloc(gCppHeap, size);
+    return headerToUser(block, size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t& tag) noexcept {
+    return operator new(size, tag);
+}
+
+void operator delete(void* ptr) noexcept {
+    if (!ptr) return;
+    void* header = userToHeader(ptr);
+    recordFree(gCppHeap, *static_cast<size_t*>(header));
+    std::free(header);
+}
+
+void operator delete[](void* ptr) noexcept {
+    operator delete(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+    operator delete(ptr);
+}
+
+void operator delete[](void* ptr, size_t) noexcept {
+    operator delete(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept {
+    operator delete(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept {
+    operator delete(ptr);
+}
+
+#endif // PIXELPETS_HEAP_TRACKING
+
+size_t textureBytes(SDL_Texture* texture) {
+    if (!texture) return 0;
+
+    Uint32 format;
+    int w, h;
+    if (SDL_QueryTexture(texture, &format, nullptr, &w, &h) != 0) {
+        return 0;
+    }
+
+    // FourCC (YUV) formats report 0 bytes per pixel; treat them as 32-bit
+    size_t bytesPerPixel = SDL_ISPIXELFORMAT_FOURCC(format) ? 4 : SDL_BYTESPERPIXEL(format);
+    return static_cast<size_t>(w) * h * bytesPerPixel;
+}
+
+SDL_Texture* trackTexture(SDL_Texture* texture, MemoryCategory category) {
+    if (!texture) return nullptr;
+
+    if (TrackedTexture* existing = findTrackedTexture(texture)) {
+        std::cerr << "Texture is already tracked under "
+                  << memoryCategoryName(existing->category) << std::endl;
+        return texture;
+    }
+
+    TrackedTexture* entry = insertTrackedTexture(texture);
+    if (!entry) {
+        std::cerr << "Texture table full, not tracking texture" << std::endl;
+        return texture;
+    }
+    size_t bytes = textureBytes(texture);
+    *entry = {texture, category, bytes};
+
+    MemoryCategoryStats& stats = gCategoryStats[static_cast<int>(category)];
+    stats.bytes += bytes;
+    stats.textures++;
+    stats.peakBytes = std::max(stats.peakBytes, stats.bytes);
+
+    enforceBudget(category, texture);
+    return texture;
+}
+
+void destroyTrackedTexture(SDL_Texture* texture) {
+    if (!texture) return;
+
+    for (int i = 0; i < gTextureReleaseHandlerCount; i++) {
+        gTextureReleaseHandlers[i](texture);
+    }
+
+    if (TrackedTexture* entry = findTrackedTexture(texture)) {
+        MemoryCategoryStats& stats = gCategoryStats[static_cast<int>(entry->category)];
+        stats.bytes -= entry->bytes;
+        stats.textures--;
+        if (stats.budget > 0 && stats.bytes <= stats.budget) {
+            stats.overBudgetEvents = 0;
+        }
+        entry->texture = TOMBSTONE;
+    }
+
+    SDL_DestroyTexture(texture);
+}
+
+MemoryCategory trackedCategory(SDL_Texture* texture) {
+    TrackedTexture* entry = findTrackedTexture(texture);
+    return entry ? entry->category : MemoryCategory::COUNT;
+}
+
+void setMemoryBudget(MemoryCategory category, size_t bytes, BudgetAction action) {
+    MemoryCategoryStats& stats = gCategoryStats[static_cast<int>(category)];
+    stats.budget = bytes;
+    stats.action = action;
+    stats.overBudgetEvents = 0;
+    enforceBudget(category, nullptr);
+}
+
+void setEvictionHandler(MemoryCategory category, EvictionHandler handler) {
+    gEvictionHandlers[static_cast<int>(category)] = std::move(handler);
+}
+
+bool addTextureReleaseHandler(TextureReleaseHandler handler) {
+    if (gTextureReleaseHandlerCount == MAX_TEXTURE_RELEASE_HANDLERS) {
+        std::cerr << "Too many texture release handlers" << std::endl;
+        return false;
+    }
+    gTextureReleaseHandlers[gTextureReleaseHandlerCount++] = std::move(handler);
+    return true;
+}
+
+bool parseMemoryBudgetArg(const std::string& arg) {
+    // Map short command line names onto categories
+    const struct { const char* name; MemoryCategory category; } names[] = {
+        {"plants", MemoryCategory::PLANT_SPRITE},
+        {"backgrounds", MemoryCategory::BACKGROUND},
+        {"text", MemoryCategory::TEXT},
+        {"ui", MemoryCategory::UI},
+        {"placeholders", MemoryCategory::PLACEHOLDER},
+        {"scaled", MemoryCategory::SCALED_SPRITE},
+    };
+
+    size_t firstColon = arg.find(':');
+    if (firstColon == std::string::npos) return false;
+    std::string name = arg.substr(0, firstColon);
+
+    size_t secondColon = arg.find(':', firstColon + 1);
+    std::string sizeText = arg.substr(firstColon + 1, secondColon == std::string::npos
+                                      ? std::string::npos : secondColon - firstColon - 1);
+    BudgetAction action = BudgetAction::LOG;
+    if (secondColon != std::string::npos) {
+        std::string actionText = arg.substr(secondColon + 1);
+        if (actionText == "evict") {
+            action = BudgetAction::EVICT;
+        } else if (actionText != "log") {
+            return false;
+        }
+    }
+
+    char* end = nullptr;
+    unsigned long kilobytes = std::strtoul(sizeText.c_str(), &end, 10);
+    if (sizeText.empty() || *end != '\0') return false;
+
+    for (const auto& entry : names) {
+        if (name == entry.name) {
+            setMemoryBudget(entry.category, static_cast<size_t>(kilobytes) * 1024, action);
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* memoryCategoryName(MemoryCategory category) {
+    switch (category) {
+        case MemoryCategory::PLANT_SPRITE: return "Plant sprites";
+        case MemoryCategory::BACKGROUND:   return "Backgrounds";
+        case MemoryCategory::TEXT:         return "Text";
+        case MemoryCategory::UI:           return "UI";
+        case MemoryCategory::PLACEHOLDER:  return "Placeholders";
+        case MemoryCategory::SCALED_SPRITE: return "Scaled sprites";
+        default:                           return "Unknown";
+    }
+}
+
+const MemoryCategoryStats& getMemoryStats(MemoryCategory category) {
+    return gCategoryStats[static_cast<int>(category)];
+}
+
+size_t getTotalTextureBytes() {
+    size_t total = 0;
+    for (const auto& stats : gCategoryStats) {
+        total += stats.bytes;
+    }
+    return total;
+}
+
+HeapStats getCppHeapStats() {
+    return snapshot(gCppHeap);
+}
+
+HeapStats getSdlHeapStats() {
+    return snapshot(gSdlHeap);
+}
+
+void installSdlMemoryHooks() {
+    if (gSdlMalloc) return;  // Already installed
+
+    SDL_GetMemoryFunctions(&gSdlMalloc, &gSdlCalloc, &gSdlRealloc, &gSdlFree);
+    if (SDL_SetMemoryFunctions(sdlTrackedMalloc, sdlTrackedCalloc,
+                               sdlTrackedRealloc, sdlTrackedFree) != 0) {
+        std::cerr << "Failed to install SDL memory hooks: " << SDL_GetError() << std::endl;
+        gSdlMalloc = nullptr;
+    }
+}
+
+void lockHeap() {
+    gHeapLocked.store(true, std::memory_order_relaxed);
+}
+
+void unlockHeap() {
+    gHeapLocked.store(false, std::memory_order_relaxed);
+}
+
+size_t getCppAllocationsAfterLock() {
+    return gCppAllocsAfterLock.load(std::memory_order_relaxed);
+}
+
+size_t getSdlAllocationsAfterLock() {
+    return gSdlAllocsAfterLock.load(std::memory_order_relaxed);
+}
+
+void logMemoryReport() {
+    std::cout << "---- Memory report ----" << std::endl;
+    std::cout << std::left << std::setw(15) << "Category" << std::right
+              << std::setw(8) << "Count" << std::setw(12) << "KB"
+              << std::setw(12) << "Peak KB" << std::setw(12) << "Budget KB" << std::endl;
+
+    for (int i = 0; i < static_cast<int>(MemoryCategory::COUNT); i++) {
+        const MemoryCategoryStats& stats = gCategoryStats[i];
+        std::cout << std::left << std::setw(15) << memoryCategoryName(static_cast<MemoryCategory>(i))
+                  << std::right << std::setw(8) << stats.textures
+                  << std::setw(12) << stats.bytes / 1024
+                  << std::setw(12) << stats.peakBytes / 1024;
+        if (stats.budget > 0) {
+            std::cout << std::setw(12) << stats.budget / 1024
+                      << (stats.action == BudgetAction::EVICT ? " (evict)" : " (log)");
+        } else {
+            std::cout << std::setw(12) << "-";
+        }
+        std::cout << std::endl;
+    }
+    std::cout << std::left << std::setw(15) << "Textures total" << std::right
+              << std::setw(20) << getTotalTextureBytes() / 1024 << std::endl;
+
+#ifdef PIXELPETS_HEAP_TRACKING
+    HeapStats cppHeap = getCppHeapStats();
+    std::cout << "C++ heap: " << cppHeap.bytes / 1024 << " KB live, "
+              << cppHeap.peakBytes / 1024 << " KB peak, "
+              << cppHeap.allocations << " allocations" << std::endl;
+#endif
+    HeapStats sdlHeap = getSdlHeapStats();
+    std::cout << "SDL heap: " << sdlHeap.bytes / 1024 << " KB live, "
+              << sdlHeap.peakBytes / 1024 << " KB peak, "
+              << sdlHeap.allocations << " allocations" << std::endl;
+    if (gHeapLocked.load(std::memory_order_relaxed) || gCppAllocsAfterLock || gSdlAllocsAfterLock) {
+        std::cout << "Allocations after init: " << getCppAllocationsAfterLock() << " C++, "
+                  << getSdlAllocationsAfterLock() << " SDL" << std::endl;
+    }
+}
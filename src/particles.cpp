@@ -0,0 +1,302 @@
+#include <SDL2/SDL.h>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include "../include/game.h"
+#include "../include/hal.h"
+#include "../include/particles.h"
+
+namespace {
+
+// Colors packed as 0xRRGGBBAA
+const uint32_t RAIN_COLOR = 0xADD8E696;   // Light blue, mostly transparent
+const uint32_t WIND_COLOR = 0xE4E4D0B4;   // Palette off-white
+const uint32_t CONFETTI_COLORS[] = {
+    0xFF0000FF,  // Red
+    0xFFFF00FF,  // Yellow
+    0x00FF00FF,  // Green
+    0x0000FFFF,  // Blue
+    0xFF00FFFF   // Purple
+};
+const uint32_t SPARKLE_COLORS[] = {
+    0xFFFF64FF,  // Palette yellow
+    0xFFFFFFFF   // White
+};
+
+const float CONFETTI_GRAVITY = 90.0f;   // Pixels/second^2
+
+} // namespace
+
+bool ParticleSystem::init(int capacityCount) {
+    maxCount = std::max(0, capacityCount);
+    liveCount = 0;
+
+    x.reset(new float[maxCount]);
+    y.reset(new float[maxCount]);
+    vx.reset(new float[maxCount]);
+    vy.reset(new float[maxCount]);
+    ax.reset(new float[maxCount]);
+    ay.reset(new float[maxCount]);
+    age.reset(new float[maxCount]);
+    life.reset(new float[maxCount]);
+    color.reset(new uint32_t[maxCount]);
+    width.reset(new uint8_t[maxCount]);
+    height.reset(new uint8_t[maxCount]);
+
+    // Every particle is a quad: 4 vertices, 2 triangles. The index pattern
+    // never changes, so it is filled in once.
+    vertices.reset(new SDL_Vertex[static_cast<size_t>(maxCount) * 4]);
+    indices.reset(new int[static_cast<size_t>(maxCount) * 6]);
+    rects.reset(new SDL_Rect[maxCount]);
+    for (int i = 0; i < maxCount; i++) {
+        int* quad = &indices[static_cast<size_t>(i) * 6];
+        int first = i * 4;
+        quad[0] = first;     quad[1] = first + 1; quad[2] = first + 2;
+        quad[3] = first + 2; quad[4] = first + 1; quad[5] = first + 3;
+    }
+    return true;
+}
+
+void ParticleSystem::clear() {
+    liveCount = 0;
+    rainCarry = 0.0f;
+    windCarry = 0.0f;
+}
+
+float ParticleSystem::random01() {
+    // xorshift32; much cheaper than rand() when spawning bursts
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 17;
+    rngState ^= rngState << 5;
+    return (rngState >> 8) * (1.0f / 16777216.0f);
+}
+
+int ParticleSystem::spawn(float px, float py, float pvx, float pvy, float pax, float pay,
+                          float lifetime, uint32_t rgba, uint8_t w, uint8_t h) {
+    if (liveCount >= maxCount) {
+        return -1;
+    }
+    int i = liveCount++;
+    x[i] = px;
+    y[i] = py;
+    vx[i] = pvx;
+    vy[i] = pvy;
+    ax[i] = pax;
+    ay[i] = pay;
+    age[i] = 0.0f;
+    life[i] = lifetime;
+    color[i] = rgba;
+    width[i] = w;
+    height[i] = h;
+    return i;
+}
+
+void ParticleSystem::update(float dt) {
+    const int n = liveCount;
+    float* __restrict px = x.get();
+    float* __restrict py = y.get();
+    float* __restrict pvx = vx.get();
+    float* __restrict pvy = vy.get();
+    const float* __restrict pax = ax.get();
+    const float* __restrict pay = ay.get();
+    float* __restrict page = age.get();
+
+    // Semi-implicit Euler; plain loops over separate arrays vectorize
+    for (int i = 0; i < n; i++) {
+        pvx[i] += pax[i] * dt;
+        pvy[i] += pay[i] * dt;
+    }
+    for (int i = 0; i < n; i++) {
+        px[i] += pvx[i] * dt;
+        py[i] += pvy[i] * dt;
+        page[i] += dt;
+    }
+
+    // Swap expired particles with the last live one
+    int i = 0;
+    while (i < liveCount) {
+        if (age[i] < life[i]) {
+            i++;
+            continue;
+        }
+        int last = --liveCount;
+        x[i] = x[last];
+        y[i] = y[last];
+        vx[i] = vx[last];
+        vy[i] = vy[last];
+        ax[i] = ax[last];
+        ay[i] = ay[last];
+        age[i] = age[last];
+        life[i] = life[last];
+        color[i] = color[last];
+        width[i] = width[last];
+        height[i] = height[last];
+    }
+}
+
+void ParticleSystem::copyFrom(const ParticleSystem& other) {
+    liveCount = std::min(other.liveCount, maxCount);
+    std::copy_n(other.x.get(), liveCount, x.get());
+    std::copy_n(other.y.get(), liveCount, y.get());
+    std::copy_n(other.age.get(), liveCount, age.get());
+    std::copy_n(other.life.get(), liveCount, life.get());
+    std::copy_n(other.color.get(), liveCount, color.get());
+    std::copy_n(other.width.get(), liveCount, width.get());
+    std::copy_n(other.height.get(), liveCount, height.get());
+}
+
+void ParticleSystem::render(SDL_Renderer* renderer) const {
+    if (!renderer || liveCount == 0) return;
+
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+    // One quad per particle, alpha fading out over its life
+    for (int i = 0; i < liveCount; i++) {
+        float left = x[i];
+        float top = y[i];
+        float right = left + width[i];
+        float bottom = top + height[i];
+        uint32_t rgba = color[i];
+        float fade = 1.0f - age[i] / life[i];
+        SDL_Color c = {
+            static_cast<Uint8>(rgba >> 24),
+            static_cast<Uint8>(rgba >> 16),
+            static_cast<Uint8>(rgba >> 8),
+            static_cast<Uint8>((rgba & 0xFF) * fade)
+        };
+
+        SDL_Vertex* quad = &vertices[static_cast<size_t>(i) * 4];
+        quad[0] = {{left, top}, c, {0.0f, 0.0f}};
+        quad[1] = {{right, top}, c, {0.0f, 0.0f}};
+        quad[2] = {{left, bottom}, c, {0.0f, 0.0f}};
+        quad[3] = {{right, bottom}, c, {0.0f, 0.0f}};
+    }
+
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+    if (SDL_RenderGeometry(renderer, nullptr, vertices.get(), liveCount * 4, indices.get(), liveCount * 6) != 0) {
+        std::cerr << "Failed to draw particles: " << SDL_GetError() << std::endl;
+    }
+#else
+    // No geometry API: one SDL_RenderFillRects call per run of equal
+    // colors, without the fade
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+    int runStart = 0;
+    for (int i = 0; i <= liveCount; i++) {
+        if (i < liveCount && color[i] == color[runStart]) {
+            rects[i] = {static_cast<int>(x[i]), static_cast<int>(y[i]), width[i], height[i]};
+            continue;
+        }
+        uint32_t rgba = color[runStart];
+        SDL_SetRenderDrawColor(renderer, rgba >> 24, (rgba >> 16) & 0xFF, (rgba >> 8) & 0xFF, rgba & 0xFF);
+        SDL_RenderFillRects(renderer, &rects[runStart], i - runStart);
+        runStart = i;
+        if (i < liveCount) {
+            rects[i] = {static_cast<int>(x[i]), static_cast<int>(y[i]), width[i], height[i]};
+        }
+    }
+#endif
+}
+
+void ParticleSystem::emitRain(float dt, float perSecond, float wind) {
+    rainCarry += perSecond * dt;
+    while (rainCarry >= 1.0f) {
+        rainCarry -= 1.0f;
+        float speed = randomRange(120.0f, 240.0f);
+        uint8_t length = static_cast<uint8_t>(5 + random01() * 10);
+
+        // Spawn above the screen, upwind so drops cover the whole width
+        float startX = randomRange(0.0f, static_cast<float>(SCREEN_WIDTH)) - wind * (SCREEN_HEIGHT / speed);
+        float lifetime = (SCREEN_HEIGHT + length) / speed;
+        spawn(startX, -static_cast<float>(length), wind, speed, 0.0f, 0.0f, lifetime, RAIN_COLOR, 1, length);
+    }
+}
+
+void ParticleSystem::emitWind(float dt, float perSecond, float speed) {
+    windCarry += perSecond * dt;
+    while (windCarry >= 1.0f) {
+        windCarry -= 1.0f;
+        float streakSpeed = speed * randomRange(0.7f, 1.3f);
+        uint8_t length = static_cast<uint8_t>(3 + random01() * 6);
+        float startY = randomRange(0.0f, static_cast<float>(SCREEN_HEIGHT - TOOLBAR_HEIGHT));
+        float lifetime = (SCREEN_WIDTH + length) / streakSpeed;
+
+        // Gusts drift up or down a little
+        spawn(-static_cast<float>(length), startY, streakSpeed, randomRange(-8.0f, 8.0f),
+              0.0f, randomRange(-6.0f, 6.0f), lifetime, WIND_COLOR, length, 1);
+    }
+}
+
+void ParticleSystem::burstConfetti(float cx, float cy, int count) {
+    const int colorCount = sizeof(CONFETTI_COLORS) / sizeof(CONFETTI_COLORS[0]);
+    for (int i = 0; i < count; i++) {
+        // Radial burst that falls under gravity
+        float angle = random01() * 6.2831853f;
+        float speed = randomRange(30.0f, 150.0f);
+        uint8_t size = static_cast<uint8_t>(2 + random01() * 3);
+        uint32_t rgba = CONFETTI_COLORS[static_cast<int>(random01() * colorCount) % colorCount];
+        if (spawn(cx, cy, std::cos(angle) * speed, std::sin(angle) * speed, 0.0f, CONFETTI_GRAVITY,
+                  randomRange(0.5f, 1.5f), rgba, size, size) < 0) {
+            return;
+        }
+    }
+}
+
+void ParticleSystem::burstSparkles(const SDL_Rect& area, int count) {
+    const int colorCount = sizeof(SPARKLE_COLORS) / sizeof(SPARKLE_COLORS[0]);
+    for (int i = 0; i < count; i++) {
+        float px = area.x + random01() * area.w;
+        float py = area.y + random01() * area.h;
+        uint8_t size = static_cast<uint8_t>(1 + random01() * 2);
+        uint32_t rgba = SPARKLE_COLORS[static_cast<int>(random01() * colorCount) % colorCount];
+        // Short-lived glints that float upwards
+        if (spawn(px, py, randomRange(-5.0f, 5.0f), randomRange(-20.0f, -5.0f), 0.0f, 0.0f,
+                  randomRange(0.3f, 0.7f), rgba, size, size) < 0) {
+            return;
+        }
+    }
+}
+
+void runParticleBenchmark(Display& display, int count) {
+    const int FRAMES = 300;
+    const float DT = 1.0f / 60.0f;
+    SDL_Renderer* renderer = display.getRenderer();
+
+    ParticleSystem particles;
+    if (!particles.init(count)) {
+        std::cerr << "Unable to allocate " << count << " particles" << std::endl;
+        return;
+    }
+
+    double updateMicros = 0;
+    double renderMicros = 0;
+    double frequency = static_cast<double>(SDL_GetPerformanceFrequency());
+    for (int frame = 0; frame < FRAMES; frame++) {
+        // Keep the pool full with a mix of every emitter
+        while (particles.count() < particles.capacity()) {
+            int before = particles.count();
+            particles.emitRain(1.0f, 1.0f, 20.0f);
+            particles.burstConfetti(SCREEN_WIDTH / 2.0f, SCREEN_HEIGHT / 3.0f, 64);
+            particles.burstSparkles({20, 40, 95, 120}, 16);
+            particles.emitWind(1.0f, 1.0f, 90.0f);
+            if (particles.count() == before) break;
+        }
+
+        display.beginFrame();
+        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+        SDL_RenderClear(renderer);
+
+        Uint64 start = SDL_GetPerformanceCounter();
+        particles.update(DT);
+        Uint64 updated = SDL_GetPerformanceCounter();
+        particles.render(renderer);
+        Uint64 rendered = SDL_GetPerformanceCounter();
+
+        updateMicros += (updated - start) * 1000000.0 / frequency;
+        renderMicros += (rendered - updated) * 1000000.0 / frequency;
+        display.present();
+    }
+
+    std::cout << "Particle benchmark: " << count << " particles, " << FRAMES << " frames" << std::endl;
+    std::cout << "  update " << updateMicros / FRAMES << " us/frame, render "
+              << renderMicros / FRAMES << " us/frame, total "
+              << (updateMicros + renderMicros) / FRAMES / 1000.0 << " ms/frame" << std::endl;
+}
@@ -0,0 +1,284 @@
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <vector>
+#include "../include/plant_catalog.h"
+#include "../include/assets.h"
+#include "../include/job_system.h"
+
+namespace {
+
+// Ids index a dense table, so keep them small
+const int MAX_SPECIES_ID = 4096;
+const int CATALOG_FIELDS = 8;
+
+const char* const WEATHER_KEYS[WEATHER_COUNT] = {"sunny", "rainy", "cloudy", "windy"};
+const char* const RARITY_KEYS[RARITY_COUNT] = {"common", "uncommon", "rare", "legendary"};
+
+std::vector<PlantSpecies> gSpecies;       // Sorted by id
+std::string gStrings;                     // Names and sprite paths, NUL separated
+std::vector<int16_t> gSlotById;           // -1 where no species has the id
+std::vector<uint16_t> gWeatherSlots;
+std::vector<uint16_t> gRaritySlots;
+int gWeatherStart[WEATHER_COUNT + 1] = {};
+int gRarityStart[RARITY_COUNT + 1] = {};
+std::vector<SpeciesHitMask> gHitMasks;    // By slot; spriteWidth 0 where none was built
+int gHitMaskCount = 0;
+double gHitMaskMicros = 0;
+
+int findKey(const char* const* keys, int count, const std::string& value) {
+    for (int i = 0; i < count; i++) {
+        if (value == keys[i]) return i;
+    }
+    return -1;
+}
+
+// One species per job: decode its sprite and sample the mask
+void buildMaskJob(void* data, int begin, int end) {
+    const uint16_t* slots = static_cast<const uint16_t*>(data);
+    for (int i = begin; i < end; i++) {
+        SpeciesHitMask& hit = gHitMasks[slots[i]];
+        SDL_Surface* pixels = loadAssetSurface(speciesSprite(gSpecies[slots[i]]));
+        if (!pixels) {
+            hit.spriteWidth = 32;
+            hit.spriteHeight = 32;
+            continue;
+        }
+        hit.spriteWidth = pixels->w;
+        hit.spriteHeight = pixels->h;
+        buildAlphaMask(pixels, hit.mask);
+        SDL_FreeSurface(pixels);
+    }
+}
+
+size_t hitMaskBytes() {
+    size_t bytes = gHitMasks.capacity() * sizeof(SpeciesHitMask);
+    for (const SpeciesHitMask& hit : gHitMasks) {
+        bytes += hit.mask.bits.capacity();
+    }
+    return bytes;
+}
+
+bool parseNumber(const std::string& text, int low, int high, int& out) {
+    char* end = nullptr;
+    long value = std::strtol(text.c_str(), &end, 10);
+    if (text.empty() || *end != '\0' || value < low || value > high) return false;
+    out = static_cast<int>(value);
+    return true;
+}
+
+uint32_t addString(const std::string& text) {
+    uint32_t offset = static_cast<uint32_t>(gStrings.size());
+    gStrings.append(text);
+    gStrings.push_back('\0');
+    return offset;
+}
+
+// Parse one CSV line; the catalog has no quoted fields
+bool parseSpecies(const std::string& line, PlantSpecies& species) {
+    std::string fields[CATALOG_FIELDS];
+    int count = 0;
+    size_t start = 0;
+    while (count < CATALOG_FIELDS) {
+        size_t comma = line.find(',', start);
+        fields[count++] = line.substr(start, comma == std::string::npos ? std::string::npos : comma - start);
+        if (comma == std::string::npos) break;
+        start = comma + 1;
+    }
+    if (count != CATALOG_FIELDS || line.find(',', start) != std::string::npos) return false;
+
+    int id, growth, priceMin, priceMax;
+    int weather = findKey(WEATHER_KEYS, WEATHER_COUNT, fields[3]);
+    int rarity = findKey(RARITY_KEYS, RARITY_COUNT, fields[2]);
+    if (!parseNumber(fields[0], 1, MAX_SPECIES_ID - 1, id) || fields[1].empty() ||
+        rarity < 0 || weather < 0 || !parseNumber(fields[4], 1, PLANT_MAX_GROWTH, growth) ||
+        !parseNumber(fields[5], 0, 65535, priceMin) || !parseNumber(fields[6], priceMin, 65535, priceMax) ||
+        fields[7].empty()) {
+        return false;
+    }
+
+    species.id = static_cast<uint16_t>(id);
+    species.rarity = static_cast<Rarity>(rarity);
+    species.weather = static_cast<WeatherType>(weather);
+    species.growthPerTick = static_cast<uint8_t>(growth);
+    species.priceMin = static_cast<uint16_t>(priceMin);
+    species.priceMax = static_cast<uint16_t>(priceMax);
+    species.nameOffset = addString(fields[1]);
+    species.spriteOffset = addString(fields[7]);
+    species.nameRank = 0;
+    return true;
+}
+
+// Group slots by key with a counting sort; slots stay in id order within
+// each group
+template <typename KeyOf>
+void buildIndex(int groups, KeyOf keyOf, std::vector<uint16_t>& slots, int* starts) {
+    std::fill(starts, starts + groups + 1, 0);
+    for (const PlantSpecies& species : gSpecies) {
+        starts[keyOf(species) + 1]++;
+    }
+    for (int g = 0; g < groups; g++) {
+        starts[g + 1] += starts[g];
+    }
+    slots.assign(gSpecies.size(), 0);
+    std::vector<int> next(starts, starts + groups);
+    for (size_t slot = 0; slot < gSpecies.size(); slot++) {
+        slots[next[keyOf(gSpecies[slot])]++] = static_cast<uint16_t>(slot);
+    }
+}
+
+} // namespace
+
+bool loadPlantCatalog(const std::string& path) {
+    gSpecies.clear();
+    gStrings.clear();
+
+    std::string text = loadAssetText(path);
+    if (text.empty()) {
+        std::cerr << "Plant catalog " << path << " is missing or empty" << std::endl;
+        return false;
+    }
+
+    size_t start = 0;
+    int lineNumber = 0;
+    while (start < text.size()) {
+        size_t end = text.find('\n', start);
+        if (end == std::string::npos) end = text.size();
+        std::string line = text.substr(start, end - start);
+        start = end + 1;
+        lineNumber++;
+
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.empty() || line[0] == '#') continue;
+
+        PlantSpecies species;
+        if (!parseSpecies(line, species)) {
+            std::cerr << path << ":" << lineNumber << ": invalid species, skipped" << std::endl;
+            continue;
+        }
+        gSpecies.push_back(species);
+    }
+
+    std::stable_sort(gSpecies.begin(), gSpecies.end(),
+                     [](const PlantSpecies& a, const PlantSpecies& b) { return a.id < b.id; });
+
+    // Dense id table; later duplicates are dropped
+    int maxId = gSpecies.empty() ? 0 : gSpecies.back().id;
+    gSlotById.assign(maxId + 1, -1);
+    size_t kept = 0;
+    for (const PlantSpecies& species : gSpecies) {
+        if (gSlotById[species.id] >= 0) {
+            std::cerr << path << ": duplicate species id " << species.id << ", skipped" << std::endl;
+            continue;
+        }
+        gSlotById[species.id] = static_cast<int16_t>(kept);
+        gSpecies[kept++] = species;
+    }
+    gSpecies.resize(kept);
+    gSpecies.shrink_to_fit();
+    gStrings.shrink_to_fit();
+
+    // Alphabetical rank, so sorting plants by name compares one integer
+    std::vector<uint16_t> byName(gSpecies.size());
+    for (size_t slot = 0; slot < byName.size(); slot++) {
+        byName[slot] = static_cast<uint16_t>(slot);
+    }
+    std::sort(byName.begin(), byName.end(), [](uint16_t a, uint16_t b) {
+        return std::strcmp(speciesName(gSpecies[a]), speciesName(gSpecies[b])) < 0;
+    });
+    for (size_t rank = 0; rank < byName.size(); rank++) {
+        gSpecies[byName[rank]].nameRank = static_cast<uint16_t>(rank);
+    }
+
+    buildIndex(WEATHER_COUNT, [](const PlantSpecies& s) { return static_cast<int>(s.weather); },
+               gWeatherSlots, gWeatherStart);
+    buildIndex(RARITY_COUNT, [](const PlantSpecies& s) { return static_cast<int>(s.rarity); },
+               gRaritySlots, gRarityStart);
+    return !gSpecies.empty();
+}
+
+int speciesCount() {
+    return static_cast<int>(gSpecies.size());
+}
+
+const PlantSpecies& speciesAt(int slot) {
+    return gSpecies[slot];
+}
+
+const PlantSpecies* findSpecies(int id) {
+    if (id < 0 || id >= static_cast<int>(gSlotById.size()) || gSlotById[id] < 0) {
+        return nullptr;
+    }
+    return &gSpecies[gSlotById[id]];
+}
+
+const char* speciesName(const PlantSpecies& species) {
+    return gStrings.c_str() + species.nameOffset;
+}
+
+const char* speciesSprite(const PlantSpecies& species) {
+    return gStrings.c_str() + species.spriteOffset;
+}
+
+SpeciesRange speciesByWeather(WeatherType weather) {
+    int w = static_cast<int>(weather);
+    const uint16_t* slots = gWeatherSlots.data();
+    return {slots + gWeatherStart[w], slots + gWeatherStart[w + 1]};
+}
+
+SpeciesRange speciesByRarity(Rarity rarity) {
+    int r = static_cast<int>(rarity);
+    const uint16_t* slots = gRaritySlots.data();
+    return {slots + gRarityStart[r], slots + gRarityStart[r + 1]};
+}
+
+void buildSpeciesMasks(const int* catalogIds, int count) {
+    Uint64 start = SDL_GetPerformanceCounter();
+    gHitMasks.resize(gSpecies.size());
+
+    // Each species once, however many plants share it
+    std::vector<uint16_t> slots;
+    for (int i = 0; i < count; i++) {
+        const PlantSpecies* species = findSpecies(catalogIds[i]);
+        if (!species) continue;
+        uint16_t slot = static_cast<uint16_t>(gSlotById[species->id]);
+        if (gHitMasks[slot].spriteWidth == 0 && std::find(slots.begin(), slots.end(), slot) == slots.end()) {
+            slots.push_back(slot);
+        }
+    }
+
+    JobCounter counter;
+    parallelFor(buildMaskJob, slots.data(), static_cast<int>(slots.size()), 1, counter);
+    waitForCounter(counter);
+
+    gHitMaskCount += static_cast<int>(slots.size());
+    gHitMaskMicros += (SDL_GetPerformanceCounter() - start) * 1000000.0 / SDL_GetPerformanceFrequency();
+}
+
+const SpeciesHitMask* speciesHitMask(int catalogId) {
+    const PlantSpecies* species = findSpecies(catalogId);
+    if (!species || gSlotById[species->id] >= static_cast<int>(gHitMasks.size())) return nullptr;
+    const SpeciesHitMask& hit = gHitMasks[gSlotById[species->id]];
+    return hit.spriteWidth > 0 ? &hit : nullptr;
+}
+
+size_t plantCatalogBytes() {
+    return gSpecies.capacity() * sizeof(PlantSpecies) + gStrings.capacity() +
+           gSlotById.capacity() * sizeof(int16_t) +
+           (gWeatherSlots.capacity() + gRaritySlots.capacity()) * sizeof(uint16_t) + hitMaskBytes();
+}
+
+void logPlantCatalogStats() {
+    std::cout << "=== Plant Catalog ===" << std::endl;
+    std::cout << "  Species: " << speciesCount() << ", " << plantCatalogBytes() << " bytes" << std::endl;
+    std::cout << "  By rarity:";
+    for (int r = 0; r < RARITY_COUNT; r++) {
+        std::cout << " " << RarityNames[r] << " " << speciesByRarity(static_cast<Rarity>(r)).size();
+    }
+    std::cout << std::endl;
+    if (gHitMaskCount > 0) {
+        std::cout << "  Hit masks: " << gHitMaskCount << ", built in " << gHitMaskMicros / 1000.0 << " ms"
+                  << std::endl;
+    }
+}
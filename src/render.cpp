@@ -5,8 +5,18 @@
 #include <vector>
 #include <cmath>
 #include <sstream>
+#include <cstdio>
+#include <algorithm>
 #include "../include/game.h"
 #include "../include/render.h"
+#include "../include/memory_tracker.h"
+#include "../include/arena.h"
+#include "../include/layout.h"
+#include "../include/assets.h"
+#include "../include/color_grade.h"
+#include "../include/compositor.h"
+#include "../include/sprite_cache.h"
+#include "../include/inventory_index.h"
 
 // Global font
 TTF_Font* gFont = nullptr;
@@ -21,7 +31,7 @@ bool initFont() {
     // Try different font sizes in case the file is not found
     const int fontSizes[] = {8, 10, 12, 14, 16};
     for (int size : fontSizes) {
-        gFont = TTF_OpenFont("assets/fonts/pixel.ttf", size);
+        gFont = openAssetFont("assets/fonts/pixel.ttf", size);
         if (gFont != nullptr) {
             std::cout << "Successfully loaded font at size " << size << std::endl;
             return true;
@@ -41,13 +51,109 @@ void cleanupFont() {
     TTF_Quit();
 }
 
+// Glyph atlas: printable ASCII pre-rendered into one texture at startup, so
+// drawing text needs no TTF surfaces or temporary textures per frame
+const int FIRST_GLYPH = 32;
+const int LAST_GLYPH = 126;
+const int GLYPH_ATLAS_WIDTH = 256;
+
+struct GlyphInfo {
+    SDL_Rect src;   // Location in the atlas
+    int advance;    // Horizontal pen advance
+};
+
+SDL_Texture* gGlyphAtlas = nullptr;
+GlyphInfo gGlyphs[LAST_GLYPH - FIRST_GLYPH + 1];
+int gGlyphLineHeight = 0;
+
+// Build the glyph atlas (requires initFont)
+bool initTextAtlas(SDL_Renderer* renderer) {
+    if (!gFont || !renderer) return false;
+
+    const int glyphCount = LAST_GLYPH - FIRST_GLYPH + 1;
+    SDL_Surface* glyphSurfaces[glyphCount] = {};
+    SDL_Color white = {255, 255, 255, 255};
+
+    // Render each glyph and lay them out in rows
+    int penX = 0, penY = 0, rowHeight = 0;
+    for (int i = 0; i < glyphCount; i++) {
+        Uint16 ch = static_cast<Uint16>(FIRST_GLYPH + i);
+        int advance = 0;
+        TTF_GlyphMetrics(gFont, ch, nullptr, nullptr, nullptr, nullptr, &advance);
+        gGlyphs[i] = {{0, 0, 0, 0}, advance};
+
+        glyphSurfaces[i] = TTF_RenderGlyph_Solid(gFont, ch, white);
+        if (!glyphSurfaces[i]) continue;
+
+        if (penX + glyphSurfaces[i]->w > GLYPH_ATLAS_WIDTH) {
+            penX = 0;
+            penY += rowHeight;
+            rowHeight = 0;
+        }
+        gGlyphs[i].src = {penX, penY, glyphSurfaces[i]->w, glyphSurfaces[i]->h};
+        penX += glyphSurfaces[i]->w;
+        rowHeight = std::max(rowHeight, glyphSurfaces[i]->h);
+    }
+
+    // Copy the glyphs into one transparent surface
+    SDL_Surface* atlasSurface = SDL_CreateRGBSurfaceWithFormat(0, GLYPH_ATLAS_WIDTH, penY + rowHeight,
+                                                               32, SDL_PIXELFORMAT_RGBA8888);
+    if (atlasSurface) {
+        SDL_FillRect(atlasSurface, nullptr, 0);
+        for (int i = 0; i < glyphCount; i++) {
+            if (!glyphSurfaces[i]) continue;
+            SDL_SetSurfaceBlendMode(glyphSurfaces[i], SDL_BLENDMODE_NONE);
+            SDL_BlitSurface(glyphSurfaces[i], nullptr, atlasSurface, &gGlyphs[i].src);
+        }
+        gGlyphAtlas = trackTexture(SDL_CreateTextureFromSurface(renderer, atlasSurface), MemoryCategory::TEXT);
+        SDL_FreeSurface(atlasSurface);
+    }
+    for (SDL_Surface* surface : glyphSurfaces) {
+        if (surface) SDL_FreeSurface(surface);
+    }
+
+    if (!gGlyphAtlas) {
+        std::cerr << "Failed to create glyph atlas! SDL Error: " << SDL_GetError() << std::endl;
+        return false;
+    }
+    SDL_SetTextureBlendMode(gGlyphAtlas, SDL_BLENDMODE_BLEND);
+    gGlyphLineHeight = TTF_FontHeight(gFont);
+    return true;
+}
+
+// Release the glyph atlas
+void cleanupTextAtlas() {
+    if (gGlyphAtlas) {
+        destroyTrackedTexture(gGlyphAtlas);
+        gGlyphAtlas = nullptr;
+    }
+}
+
+// Atlas entry for a character. Non-ASCII (UTF-8) lead bytes draw as '?',
+// continuation bytes draw nothing.
+static const GlyphInfo* glyphFor(unsigned char c) {
+    if (c >= 0x80 && c < 0xC0) return nullptr;
+    if (c < FIRST_GLYPH || c > LAST_GLYPH) c = '?';
+    return &gGlyphs[c - FIRST_GLYPH];
+}
+
 // Helper function to get text dimensions
-SDL_Rect getTextDimensions(const std::string& text) {
+SDL_Rect getTextDimensions(const char* text) {
     SDL_Rect dimensions = {0, 0, 0, 0};
     if (!gFont) return dimensions;
+
+    if (gGlyphAtlas) {
+        for (const char* c = text; *c; c++) {
+            if (const GlyphInfo* glyph = glyphFor(static_cast<unsigned char>(*c))) {
+                dimensions.w += glyph->advance;
+            }
+        }
+        dimensions.h = gGlyphLineHeight;
+        return dimensions;
+    }
     
     int w, h;
-    if (TTF_SizeText(gFont, text.c_str(), &w, &h) == 0) {
+    if (TTF_SizeText(gFont, text, &w, &h) == 0) {
         dimensions.w = w;
         dimensions.h = h;
     }
@@ -55,25 +161,43 @@ SDL_Rect getTextDimensions(const std::string& text) {
 }
 
 // Helper function to center text horizontally
-int centerTextX(const std::string& text, int containerWidth) {
+int centerTextX(const char* text, int containerWidth) {
     SDL_Rect dimensions = getTextDimensions(text);
     return (containerWidth - dimensions.w) / 2;
 }
 
 // New function to render text using SDL_ttf
-void renderText(SDL_Renderer* renderer, const std::string& text, int x, int y, SDL_Color color) {
+void renderText(SDL_Renderer* renderer, const char* text, int x, int y, SDL_Color color) {
     if (!gFont) return;
     
     // Enable alpha blending for text
     SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+
+    // Draw glyph by glyph from the atlas, tinted to the requested color
+    if (gGlyphAtlas) {
+        SDL_SetTextureColorMod(gGlyphAtlas, color.r, color.g, color.b);
+        SDL_SetTextureAlphaMod(gGlyphAtlas, color.a);
+        int penX = x;
+        for (const char* c = text; *c; c++) {
+            const GlyphInfo* glyph = glyphFor(static_cast<unsigned char>(*c));
+            if (!glyph) continue;
+            if (glyph->src.w > 0) {
+                SDL_Rect renderQuad = {penX, y, glyph->src.w, glyph->src.h};
+                SDL_RenderCopy(renderer, gGlyphAtlas, &glyph->src, &renderQuad);
+            }
+            penX += glyph->advance;
+        }
+        return;
+    }
     
-    SDL_Surface* textSurface = TTF_RenderText_Solid(gFont, text.c_str(), color);
+    SDL_Surface* textSurface = TTF_RenderText_Solid(gFont, text, color);
     if (textSurface == nullptr) {
         std::cerr << "Unable to render text surface! SDL_ttf Error: " << TTF_GetError() << std::endl;
         return;
     }
     
-    SDL_Texture* textTexture = SDL_CreateTextureFromSurface(renderer, textSurface);
+    SDL_Texture* textTexture = trackTexture(SDL_CreateTextureFromSurface(renderer, textSurface),
+                                            MemoryCategory::TEXT);
     if (textTexture == nullptr) {
         std::cerr << "Unable to create texture from rendered text! SDL Error: " << SDL_GetError() << std::endl;
     } else {
@@ -82,12 +206,47 @@ void renderText(SDL_Renderer* renderer, const std::string& text, int x, int y, S
     }
     
     SDL_FreeSurface(textSurface);
-    SDL_DestroyTexture(textTexture);
+    destroyTrackedTexture(textTexture);
+}
+
+// Screen backgrounds, loaded once instead of on every frame
+SDL_Texture* gGardenBackground = nullptr;
+SDL_Texture* gMapBackground = nullptr;
+SDL_Texture* gStoreBackground = nullptr;
+
+void loadScreenTextures(SDL_Renderer* renderer) {
+    gGardenBackground = trackTexture(loadAssetTexture(renderer, "assets/bg_garden.png"), MemoryCategory::BACKGROUND);
+    gMapBackground = trackTexture(loadAssetTexture(renderer, "assets/map.png"), MemoryCategory::BACKGROUND);
+    gStoreBackground = trackTexture(loadAssetTexture(renderer, "assets/store.png"), MemoryCategory::BACKGROUND);
+}
+
+void cleanupScreenTextures() {
+    for (SDL_Texture** texture : {&gGardenBackground, &gMapBackground, &gStoreBackground}) {
+        if (*texture) {
+            destroyTrackedTexture(*texture);
+            *texture = nullptr;
+        }
+    }
 }
 
 // Forward declarations
-void drawPixelText(SDL_Renderer* renderer, const std::string& text, int x, int y, SDL_Color color);
+void drawPixelText(SDL_Renderer* renderer, const char* text, int x, int y, SDL_Color color);
 void renderTexture(SDL_Renderer* renderer, SDL_Texture* texture, int x, int y, SDL_Rect* clip, double scale);
+static void drawPlantViewBackground(SDL_Renderer* renderer, const ColorPalette& palette, const GradeKey& grade,
+                                    const Background* background);
+static void drawPlantViewForeground(SDL_Renderer* renderer, const ColorPalette& palette,
+                                    const RenderSnapshot& snapshot);
+static void drawPlantCard(SDL_Renderer* renderer, const ColorPalette& palette, const PlantSnapshot& plant,
+                          const PlantSprite* sprite, int offsetX);
+
+// A species' sprite, or nullptr if it isn't bound
+static const PlantSprite* findSprite(const std::vector<PlantSprite>& sprites, int catalogId) {
+    if (catalogId < 0 || catalogId >= static_cast<int>(sprites.size()) || !sprites[catalogId].texture ||
+        sprites[catalogId].width <= 0 || sprites[catalogId].height <= 0) {
+        return nullptr;
+    }
+    return &sprites[catalogId];
+}
 
 // Function to create a placeholder background texture
 SDL_Texture* createPlaceholderBackground(SDL_Renderer* renderer, const SDL_Color& bgColor, const std::string& label, int width, int height) {
@@ -108,6 +267,7 @@ SDL_Texture* createPlaceholderBackground(SDL_Renderer* renderer, const SDL_Color
         std::cerr << "Failed to create placeholder texture: " << SDL_GetError() << std::endl;
         return nullptr;
     }
+    trackTexture(texture, MemoryCategory::PLACEHOLDER);
     
     // Store the current render target
     SDL_Texture* previousTarget = SDL_GetRenderTarget(renderer);
@@ -115,7 +275,7 @@ SDL_Texture* createPlaceholderBackground(SDL_Renderer* renderer, const SDL_Color
     // Set the render target to our new texture
     if (SDL_SetRenderTarget(renderer, texture) != 0) {
         std::cerr << "Failed to set render target: " << SDL_GetError() << std::endl;
-        SDL_DestroyTexture(texture);
+        destroyTrackedTexture(texture);
         return nullptr;
     }
     
@@ -136,7 +296,7 @@ SDL_Texture* createPlaceholderBackground(SDL_Renderer* renderer, const SDL_Color
     // Restore the previous render target
     if (SDL_SetRenderTarget(renderer, previousTarget) != 0) {
         std::cerr << "Failed to restore render target: " << SDL_GetError() << std::endl;
-        SDL_DestroyTexture(texture);
+        destroyTrackedTexture(texture);
         return nullptr;
     }
     
@@ -179,141 +339,187 @@ void renderIntroScreen(SDL_Renderer* renderer, const ColorPalette& palette) {
     drawPixelText(renderer, "TAP TO START", SCREEN_WIDTH/2 - 40, SCREEN_HEIGHT - 40, palette.white);
 }
 
+// Keep a plant card's layer current and, when visible, copy it offsetX
+// pixels across. Without a layer target the card is drawn in place.
+static void drawPlantCardLayer(SDL_Renderer* renderer, const ColorPalette& palette, LayerId layer,
+                               const PlantSnapshot& plant, const std::vector<PlantSprite>& sprites,
+                               int offsetX, bool visible) {
+    const PlantSprite* sprite = findSprite(sprites, plant.catalogId);
+    if (!layerHasTarget(layer)) {
+        if (visible) {
+            drawPlantCard(renderer, palette, plant, sprite, offsetX);
+        }
+        return;
+    }
+    uint64_t key = layerKey(0, reinterpret_cast<uintptr_t>(sprite ? sprite->texture : nullptr));
+    key = layerKey(key, static_cast<uint64_t>(plant.catalogId));
+    if (beginLayer(renderer, layer, key)) {
+        drawPlantCard(renderer, palette, plant, sprite, 0);
+        endLayer(renderer);
+    }
+    if (visible) {
+        drawLayer(renderer, layer, offsetX);
+    }
+}
+
 // Render the plant view screen with weather and day/night cycle
-void renderPlantViewScreen(SDL_Renderer* renderer, const ColorPalette& palette, const Plant& plant,
-                         const Player& player, PlantNavigationButtons& navButtons, 
-                         WeatherType weather, DayNightType dayNight, 
+void renderPlantViewScreen(SDL_Renderer* renderer, const ColorPalette& palette, const RenderSnapshot& snapshot,
+                         const std::vector<PlantSprite>& sprites,
                          const std::vector<Background>& backgrounds,
-                         const std::vector<Raindrop>& raindrops) {
+                         const WeatherOverlay& weatherOverlay) {
     if (!renderer) return;
     
+    const GradeKey& grade = snapshot.grade;
+    const Background* background = !backgrounds.empty() && backgrounds[0].texture ? &backgrounds[0] : nullptr;
+    
+    // Sky and background only change with the grade
+    uint64_t backgroundKey = layerKey(0, grade.index());
+    backgroundKey = layerKey(backgroundKey, reinterpret_cast<uintptr_t>(background ? background->texture : nullptr));
+    backgroundKey = layerKey(backgroundKey, background ? background->gradeIndex : -1);
+    if (beginLayer(renderer, LayerId::PLANT_BACKGROUND, backgroundKey)) {
+        drawPlantViewBackground(renderer, palette, grade, background);
+        endLayer(renderer);
+    }
+    drawLayer(renderer, LayerId::PLANT_BACKGROUND);
+    
+    // Rain and wind overlays scroll behind the plant
+    weatherOverlay.render(renderer, snapshot.overlay);
+    
+    // The plant card, and its neighbours beside it during a swipe. The
+    // neighbours are drawn into their layers as soon as a swipe may start,
+    // so following the finger is only copies.
+    int offset = snapshot.swipeOffset;
+    drawPlantCardLayer(renderer, palette, LayerId::PLANT_CARD, snapshot.focus, sprites, offset, true);
+    if (snapshot.hasNeighbours) {
+        drawPlantCardLayer(renderer, palette, LayerId::PREV_PLANT_CARD, snapshot.neighbours[0], sprites,
+                           offset - SCREEN_WIDTH, offset > 0);
+        drawPlantCardLayer(renderer, palette, LayerId::NEXT_PLANT_CARD, snapshot.neighbours[1], sprites,
+                           offset + SCREEN_WIDTH, offset < 0);
+    }
+    
+    // Buttons and toolbar stay put; they only change with the coins
+    uint64_t foregroundKey = layerKey(0, static_cast<uint64_t>(snapshot.coins));
+    if (beginLayer(renderer, LayerId::PLANT_FOREGROUND, foregroundKey)) {
+        drawPlantViewForeground(renderer, palette, snapshot);
+        endLayer(renderer);
+    }
+    drawLayer(renderer, LayerId::PLANT_FOREGROUND);
+}
+
+// Sky fill and graded background for the plant view
+static void drawPlantViewBackground(SDL_Renderer* renderer, const ColorPalette& palette, const GradeKey& grade,
+                                    const Background* background) {
     // Clear screen with background color
     SDL_SetRenderDrawColor(renderer, palette.background.r, palette.background.g, palette.background.b, palette.background.a);
     SDL_RenderClear(renderer);
     
-    // Draw background based on weather and time of day
-    SDL_Color bgColor;
-    if (dayNight == DayNightType::NIGHT) {
-        bgColor = {25, 25, 112, 255}; // Midnight blue for night
-    } else {
-        switch (weather) {
-            case WeatherType::SUNNY:
-                bgColor = {135, 206, 235, 255}; // Sky blue
-                break;
-            case WeatherType::RAINY:
-                bgColor = {105, 105, 105, 255}; // Dark gray
-                break;
-            case WeatherType::CLOUDY:
-                bgColor = {176, 196, 222, 255}; // Light steel blue
-                break;
-            case WeatherType::WINDY:
-                bgColor = {176, 224, 230, 255}; // Powder blue
-                break;
-        }
-    }
+    // Sky blue graded for the weather and time of day, like the background
+    SDL_Color bgColor = gradeColor(gradeLut(grade), {135, 206, 235, 255});
     
     // Fill background with color
     SDL_SetRenderDrawColor(renderer, bgColor.r, bgColor.g, bgColor.b, bgColor.a);
-    SDL_Rect bgRect = {0, 0, SCREEN_WIDTH, SCREEN_HEIGHT - TOOLBAR_HEIGHT};
+    SDL_Rect bgRect = {0, 0, SCREEN_WIDTH, TOOLBAR_RECT.y};
     SDL_RenderFillRect(renderer, &bgRect);
     
     // Draw background texture if available
-    if (!backgrounds.empty() && backgrounds[0].texture) {
+    if (background) {
         // Scale to fill width completely
-        double scale = static_cast<double>(SCREEN_WIDTH) / backgrounds[0].width;
-        int scaledHeight = static_cast<int>(backgrounds[0].height * scale);
+        double scale = static_cast<double>(SCREEN_WIDTH) / background->width;
+        int scaledHeight = static_cast<int>(background->height * scale);
         
         // Center vertically if needed
         int y = std::max(0, (SCREEN_HEIGHT - TOOLBAR_HEIGHT - scaledHeight) / 2);
         
-        renderTexture(renderer, backgrounds[0].texture, 0, y, nullptr, scale);
+        renderTexture(renderer, background->texture, 0, y, nullptr, scale);
     }
-    
-    // Draw weather effects
-    if (weather == WeatherType::RAINY) {
-        SDL_SetRenderDrawColor(renderer, 173, 216, 230, 150);
-        for (const auto& drop : raindrops) {
-            SDL_RenderDrawLine(renderer, drop.x, drop.y, drop.x, drop.y + drop.length);
-        }
-    }
-    
-    // Calculate plant scale and position to ensure it's fully visible
-    // Use a smaller percentage of screen space to ensure plants don't touch edges
-    double maxWidth = SCREEN_WIDTH * 0.5;  // Reduced from 0.6
-    double maxHeight = (SCREEN_HEIGHT - TOOLBAR_HEIGHT) * 0.5;  // Reduced from 0.6
-    
-    double scaleWidth = maxWidth / plant.width;
-    double scaleHeight = maxHeight / plant.height;
-    double plantScale = std::min(scaleWidth, scaleHeight);
-    
-    int scaledPlantWidth = static_cast<int>(plant.width * plantScale);
-    int scaledPlantHeight = static_cast<int>(plant.height * plantScale);
-    
-    // Center the plant on screen with additional padding
-    int plantX = (SCREEN_WIDTH - scaledPlantWidth) / 2;
-    int plantY = ((SCREEN_HEIGHT - TOOLBAR_HEIGHT) - scaledPlantHeight) / 2;
-    
+}
+
+// The plant and its name, shifted offsetX pixels
+static void drawPlantCard(SDL_Renderer* renderer, const ColorPalette& palette, const PlantSnapshot& plant,
+                          const PlantSprite* sprite, int offsetX) {
     // Draw the plant
-    if (plant.texture) {
-        renderTexture(renderer, plant.texture, plantX, plantY, nullptr, plantScale);
+    if (sprite) {
+        // Calculate plant scale and position to ensure it's fully visible
+        // Use a smaller percentage of screen space to ensure plants don't touch edges
+        double maxWidth = SCREEN_WIDTH * 0.5;  // Reduced from 0.6
+        double maxHeight = (SCREEN_HEIGHT - TOOLBAR_HEIGHT) * 0.5;  // Reduced from 0.6
+        
+        double scaleWidth = maxWidth / sprite->width;
+        double scaleHeight = maxHeight / sprite->height;
+        double plantScale = snapSpriteScale(std::min(scaleWidth, scaleHeight));
+        
+        int scaledPlantWidth = static_cast<int>(sprite->width * plantScale);
+        int scaledPlantHeight = static_cast<int>(sprite->height * plantScale);
+        
+        // Center the plant on screen with additional padding
+        int plantX = offsetX + (SCREEN_WIDTH - scaledPlantWidth) / 2;
+        int plantY = ((SCREEN_HEIGHT - TOOLBAR_HEIGHT) - scaledPlantHeight) / 2;
+        
+        drawScaledSprite(renderer, sprite->texture, plantX, plantY, scaledPlantWidth, scaledPlantHeight);
     }
     
     // Draw plant name at the top
-    std::string plantName = plant.name;
-    int textX = centerTextX(plantName, SCREEN_WIDTH);
+    const char* plantName = plant.name;
+    int textX = offsetX + centerTextX(plantName, SCREEN_WIDTH);
     drawPixelText(renderer, plantName, textX, 10, palette.white);
-    
+}
+
+// Coins, buttons and toolbar for the plant view
+static void drawPlantViewForeground(SDL_Renderer* renderer, const ColorPalette& palette,
+                                    const RenderSnapshot& snapshot) {
     // Draw token count in top right corner
-    std::string tokenText = std::to_string(player.coins) + " coins";
+    char tokenText[32];
+    snprintf(tokenText, sizeof(tokenText), "%d coins", snapshot.coins);
     SDL_Rect tokenDims = getTextDimensions(tokenText);
     drawPixelText(renderer, tokenText, SCREEN_WIDTH - tokenDims.w - 10, 10, palette.yellow);
     
-    // Position navigation buttons at the bottom
-    int buttonY = SCREEN_HEIGHT - TOOLBAR_HEIGHT - 40;
-    int buttonSpacing = 10;
-    int buttonSize = 24;
-
-    // Calculate total width of buttons
-    int totalButtonsWidth = (buttonSize + buttonSpacing) * 4 - buttonSpacing; // 4 buttons
-    int startX = (SCREEN_WIDTH - totalButtonsWidth) / 2;
-
-    // Position buttons
-    SDL_Rect prevRect = {startX, buttonY, buttonSize, buttonSize};
-    SDL_Rect nextRect = {startX + buttonSize + buttonSpacing, buttonY, buttonSize, buttonSize};
-    SDL_Rect mapRect = {startX + (buttonSize + buttonSpacing) * 2, buttonY, buttonSize, buttonSize};
-    SDL_Rect storeRect = {startX + (buttonSize + buttonSpacing) * 3, buttonY, buttonSize, buttonSize};
-    
-    navButtons.prevPlantButton.rect = prevRect;
-    navButtons.nextPlantButton.rect = nextRect;
-    navButtons.mapButton.rect = mapRect;
-    navButtons.storeButton.rect = storeRect;
-
     // Draw navigation buttons
-    drawButton(renderer, navButtons.prevPlantButton, palette);
-    drawButton(renderer, navButtons.nextPlantButton, palette);
-    drawButton(renderer, navButtons.mapButton, palette);
-    drawButton(renderer, navButtons.storeButton, palette);
+    drawButton(renderer, PLANT_VIEW_NAV.prevPlantButton, palette);
+    drawButton(renderer, PLANT_VIEW_NAV.nextPlantButton, palette);
+    drawButton(renderer, PLANT_VIEW_NAV.mapButton, palette);
+    drawButton(renderer, PLANT_VIEW_NAV.storeButton, palette);
 
     // Draw toolbar
-    SDL_Rect toolbarRect = {0, SCREEN_HEIGHT - TOOLBAR_HEIGHT, SCREEN_WIDTH, TOOLBAR_HEIGHT};
     SDL_SetRenderDrawColor(renderer, palette.darkest.r, palette.darkest.g, 
                           palette.darkest.b, palette.darkest.a);
-    SDL_RenderFillRect(renderer, &toolbarRect);
+    SDL_RenderFillRect(renderer, &TOOLBAR_RECT);
     SDL_SetRenderDrawColor(renderer, palette.lightest.r, palette.lightest.g, 
                           palette.lightest.b, palette.lightest.a);
-    SDL_RenderDrawRect(renderer, &toolbarRect);
+    SDL_RenderDrawRect(renderer, &TOOLBAR_RECT);
 }
 
 // Render the menu view screen
-void renderMenuViewScreen(SDL_Renderer* renderer, const ColorPalette& palette, 
-                        const std::vector<Plant>& plants, const Player& player,
-                        const std::vector<Button>& menuGridButtons, 
-                        const Button& prevPageButton, const Button& nextPageButton,
-                        int currentPage, int plantsPerPage) {
+SDL_Rect inventoryPlantRect(const SDL_Rect& cell, int width, int height) {
+    if (width <= 0 || height <= 0) return cell;
+    
+    double scale = static_cast<double>(cell.w) / std::max(width, height);
+    scale = snapSpriteScale(scale * 0.85);  // Slightly larger scale factor than before (was 0.8)
+    
+    int scaledWidth = static_cast<int>(width * scale);
+    int scaledHeight = static_cast<int>(height * scale);
+    
+    // Center plant within its grid cell
+    return {cell.x + (cell.w - scaledWidth) / 2, cell.y + (cell.h - scaledHeight) / 2, scaledWidth, scaledHeight};
+}
+
+// Button with a centered text label
+static void drawLabelButton(SDL_Renderer* renderer, const Button& button, const char* label, const ColorPalette& palette) {
+    SDL_SetRenderDrawColor(renderer, palette.medium.r, palette.medium.g, palette.medium.b, palette.medium.a);
+    SDL_RenderFillRect(renderer, &button.rect);
+    SDL_SetRenderDrawColor(renderer, palette.darkest.r, palette.darkest.g, palette.darkest.b, palette.darkest.a);
+    SDL_RenderDrawRect(renderer, &button.rect);
+
+    SDL_Rect size = getTextDimensions(label);
+    drawPixelText(renderer, label, button.rect.x + (button.rect.w - size.w) / 2,
+                  button.rect.y + (button.rect.h - size.h) / 2, palette.white);
+}
+
+void renderMenuViewScreen(SDL_Renderer* renderer, const ColorPalette& palette, const RenderSnapshot& snapshot,
+                        const std::vector<PlantSprite>& sprites) {
     if (!renderer) return;
     
-    // Load and draw garden background
-    SDL_Texture* gardenBg = loadTexture(renderer, "assets/bg_garden.png");
+    // Draw garden background
+    SDL_Texture* gardenBg = gGardenBackground;
     if (gardenBg) {
         // Scale background to fit screen
         int bgWidth, bgHeight;
@@ -330,63 +536,33 @@ void renderMenuViewScreen(SDL_Renderer* renderer, const ColorPalette& palette,
         int y = (SCREEN_HEIGHT - scaledHeight) / 2;
         
         renderTexture(renderer, gardenBg, x, y, nullptr, scale);
-        SDL_DestroyTexture(gardenBg);
     } else {
         // Fallback solid color if background fails to load
         SDL_SetRenderDrawColor(renderer, 34, 139, 34, 255); // Forest green
         SDL_RenderClear(renderer);
     }
     
-    // Constants for plant layout
-    const int PLANTS_PER_ROW = 3;  // Changed from 4 to 3
-    const int SIDE_MARGIN = 30;    // Increased margin for better spacing
-    const int TOP_MARGIN = 60;     // Increased top margin
-    const int ROW_SPACING = 120;   // Increased row spacing for larger plants
-    
-    // Calculate plant size and spacing to fit 3 plants per row with margins
-    const int AVAILABLE_WIDTH = SCREEN_WIDTH - (2 * SIDE_MARGIN);
-    const int PLANT_SPACING = 20;  // Increased spacing between plants
-    const int TOTAL_SPACING = PLANT_SPACING * (PLANTS_PER_ROW - 1);
-    const int PLANT_BASE_SIZE = (AVAILABLE_WIDTH - TOTAL_SPACING) / PLANTS_PER_ROW;
-    
-    // Draw all plants in grid
-    for (size_t i = 0; i < plants.size(); i++) {
-        int row = i / PLANTS_PER_ROW;
-        int col = i % PLANTS_PER_ROW;
-        
-        // Calculate position for each plant
-        int x = SIDE_MARGIN + col * (PLANT_BASE_SIZE + PLANT_SPACING);
-        int y = TOP_MARGIN + row * ROW_SPACING;
-        
-        // Update button position
-        if (i < menuGridButtons.size()) {
-            const_cast<Button&>(menuGridButtons[i]).rect = {
-                x,
-                y,
-                PLANT_BASE_SIZE,
-                PLANT_BASE_SIZE
-            };
-        }
-        
-        // Draw plant
-        if (plants[i].texture && plants[i].width > 0 && plants[i].height > 0) {
-            double scale = static_cast<double>(PLANT_BASE_SIZE) / std::max(plants[i].width, plants[i].height);
-            scale *= 0.85;  // Slightly larger scale factor than before (was 0.8)
-            
-            int scaledWidth = static_cast<int>(plants[i].width * scale);
-            int scaledHeight = static_cast<int>(plants[i].height * scale);
-            
-            // Center plant within its grid cell
-            int plantX = x + (PLANT_BASE_SIZE - scaledWidth) / 2;
-            int plantY = y + (PLANT_BASE_SIZE - scaledHeight) / 2;
-            
-            renderTexture(renderer, plants[i].texture, plantX, plantY, nullptr, scale);
+    // Draw the current page of the sorted, filtered view into the grid cells
+    for (int i = 0; i < snapshot.pagePlantCount; i++) {
+        const PlantSprite* sprite = findSprite(sprites, snapshot.page[i].catalogId);
+        if (sprite) {
+            SDL_Rect dst = inventoryPlantRect(INVENTORY_GRID[i].rect, sprite->width, sprite->height);
+            drawScaledSprite(renderer, sprite->texture, dst.x, dst.y, dst.w, dst.h);
         }
     }
+    
+    // Page buttons, with the sort order and filter between them
+    const InventoryView& view = snapshot.view;
+    drawButton(renderer, INVENTORY_PREV_PAGE, palette);
+    drawButton(renderer, INVENTORY_NEXT_PAGE, palette);
+    drawLabelButton(renderer, INVENTORY_SORT_BUTTON, InventorySortLabels[static_cast<int>(view.sort)], palette);
+    drawLabelButton(renderer, INVENTORY_FILTER_BUTTON,
+                    view.weatherFilter == INVENTORY_FILTER_ALL ? "All" : WeatherTypeNames[view.weatherFilter].c_str(),
+                    palette);
 }
 
 // Update the drawPixelText function to use the new renderText
-void drawPixelText(SDL_Renderer* renderer, const std::string& text, int x, int y, SDL_Color color) {
+void drawPixelText(SDL_Renderer* renderer, const char* text, int x, int y, SDL_Color color) {
     renderText(renderer, text, x, y, color);
 }
 
@@ -428,30 +604,33 @@ void renderTexture(SDL_Renderer* renderer, SDL_Texture* texture, int x, int y, S
 std::vector<Background> loadBackgrounds(SDL_Renderer* renderer) {
     std::vector<Background> backgrounds;
     
-    // Load background textures
+    // One base image per scene; weather and time of day are applied by
+    // gradeBackgrounds instead of shipping a variant for each
     const std::vector<std::string> bgFiles = {
         "assets/bg_day_sunny.png",
-        // "assets/bg_day_rainy.png",
-        // "assets/bg_day_cloudy.png",
-        // "assets/bg_day_windy.png",
-        // "assets/bg_night.png"
     };
     
     for (const auto& file : bgFiles) {
         Background bg;
         bg.filename = file;
         
-        // Try to load the background texture
-        bg.texture = loadTexture(renderer, file);
-        if (bg.texture == nullptr) {
-            std::cerr << "Failed to load background texture: " << file << std::endl;
+        // Keep the ungraded pixels to grade from
+        bg.base = loadAssetSurface(file.c_str());
+        if (bg.base == nullptr) {
+            std::cerr << "Failed to load background: " << file << std::endl;
             continue;
         }
+        bg.width = bg.base->w;
+        bg.height = bg.base->h;
         
-        // Get texture dimensions
-        if (SDL_QueryTexture(bg.texture, nullptr, nullptr, &bg.width, &bg.height) != 0) {
-            std::cerr << "Failed to query texture dimensions for: " << file << std::endl;
+        // Streaming texture that holds the current grade
+        bg.texture = trackTexture(SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING,
+                                                    bg.width, bg.height), MemoryCategory::BACKGROUND);
+        if (bg.texture == nullptr) {
+            std::cerr << "Failed to create background texture: " << file << std::endl;
+            continue;
         }
+        SDL_SetTextureBlendMode(bg.texture, SDL_BLENDMODE_BLEND);
         
         // Set background name based on filename
         bg.name = file.substr(7, file.length() - 11); // Remove "assets/" and ".png"
@@ -464,8 +643,7 @@ std::vector<Background> loadBackgrounds(SDL_Renderer* renderer) {
 }
 
 // Add new function to render the map screen
-void renderMapScreen(SDL_Renderer* renderer, const ColorPalette& palette, 
-                    const std::vector<Button>& locationButtons) {
+void renderMapScreen(SDL_Renderer* renderer, const ColorPalette& palette) {
     if (!renderer) return;
     
     // Clear screen
@@ -473,7 +651,7 @@ void renderMapScreen(SDL_Renderer* renderer, const ColorPalette& palette,
     SDL_RenderClear(renderer);
     
     // Draw map background
-    SDL_Texture* mapTexture = loadTexture(renderer, "assets/map.png");
+    SDL_Texture* mapTexture = gMapBackground;
     if (mapTexture) {
         // Scale map to fit screen width while maintaining aspect ratio
         int mapWidth, mapHeight;
@@ -485,11 +663,20 @@ void renderMapScreen(SDL_Renderer* renderer, const ColorPalette& palette,
         int y = (SCREEN_HEIGHT - scaledHeight) / 2;
         
         renderTexture(renderer, mapTexture, 0, y, nullptr, scale);
-        SDL_DestroyTexture(mapTexture);
     }
     
-    // Draw location buttons with updated positions
-    for (const auto& button : locationButtons) {
+    // Icons for the locations, in MAP_LOCATION_BUTTONS order
+    static const char* const LOCATION_ICONS[LOCATION_COUNT] = {
+        "🏠",  // House top left
+        "🌿",  // Greenhouse top right
+        "🌾",  // Pasture bottom left
+        "🏪"   // Store bottom right
+    };
+    
+    // Draw location buttons
+    for (int i = 0; i < LOCATION_COUNT; i++) {
+        const Button& button = MAP_LOCATION_BUTTONS[i];
+        
         // Draw button background
         SDL_SetRenderDrawColor(renderer, palette.medium.r, palette.medium.g, palette.medium.b, palette.medium.a);
         SDL_RenderFillRect(renderer, &button.rect);
@@ -498,48 +685,27 @@ void renderMapScreen(SDL_Renderer* renderer, const ColorPalette& palette,
         SDL_SetRenderDrawColor(renderer, palette.darkest.r, palette.darkest.g, palette.darkest.b, palette.darkest.a);
         SDL_RenderDrawRect(renderer, &button.rect);
         
-        // Draw location icon
-        std::string icon;
-        if (button.rect.x < SCREEN_WIDTH/2) {
-            // Left side
-            if (button.rect.y < SCREEN_HEIGHT/2) {
-                icon = "🏠"; // House top left
-            } else {
-                icon = "🌾"; // Pasture bottom left
-            }
-        } else {
-            // Right side
-            if (button.rect.y < SCREEN_HEIGHT/2) {
-                icon = "🌿"; // Greenhouse top right
-            } else {
-                icon = "🏪"; // Store bottom right
-            }
-        }
-        
         // Center the icon in the button
         int iconX = button.rect.x + (button.rect.w - 16) / 2;
         int iconY = button.rect.y + (button.rect.h - 16) / 2;
-        drawPixelText(renderer, icon, iconX, iconY, palette.white);
+        drawPixelText(renderer, LOCATION_ICONS[i], iconX, iconY, palette.white);
     }
     
     // Draw toolbar background
     SDL_SetRenderDrawColor(renderer, palette.darkest.r, palette.darkest.g, palette.darkest.b, palette.darkest.a);
-    SDL_Rect toolbarRect = {0, SCREEN_HEIGHT - TOOLBAR_HEIGHT, SCREEN_WIDTH, TOOLBAR_HEIGHT};
-    SDL_RenderFillRect(renderer, &toolbarRect);
+    SDL_RenderFillRect(renderer, &TOOLBAR_RECT);
     
     // Draw back button
-    Button backButton = {{5, SCREEN_HEIGHT - TOOLBAR_HEIGHT + 5, MENU_BUTTON_SIZE, MENU_BUTTON_SIZE}, false};
-    SDL_RenderFillRect(renderer, &backButton.rect);
+    SDL_RenderFillRect(renderer, &BACK_BUTTON.rect);
     drawPixelText(renderer, "←", 
-                 backButton.rect.x + 8,
-                 backButton.rect.y + 8,
+                 BACK_BUTTON.rect.x + 8,
+                 BACK_BUTTON.rect.y + 8,
                  palette.white);
 }
 
 // Function to render a location screen
 void renderLocationScreen(SDL_Renderer* renderer, const ColorPalette& palette, 
-                         const std::string& locationName, const SDL_Color& bgColor,
-                         const Button& backButton) {
+                         const std::string& locationName, const SDL_Color& bgColor) {
     if (!renderer) return;
     
     // Clear screen with location background color
@@ -552,35 +718,43 @@ void renderLocationScreen(SDL_Renderer* renderer, const ColorPalette& palette,
     
     // Draw toolbar background
     SDL_SetRenderDrawColor(renderer, palette.darkest.r, palette.darkest.g, palette.darkest.b, palette.darkest.a);
-    SDL_Rect toolbarRect = {0, SCREEN_HEIGHT - TOOLBAR_HEIGHT, SCREEN_WIDTH, TOOLBAR_HEIGHT};
-    SDL_RenderFillRect(renderer, &toolbarRect);
+    SDL_RenderFillRect(renderer, &TOOLBAR_RECT);
     
     // Draw back button
     SDL_SetRenderDrawColor(renderer, palette.medium.r, palette.medium.g, palette.medium.b, palette.medium.a);
-    SDL_RenderFillRect(renderer, &backButton.rect);
+    SDL_RenderFillRect(renderer, &BACK_BUTTON.rect);
     drawPixelText(renderer, "←", 
-                 backButton.rect.x + 8,
-                 backButton.rect.y + 8,
+                 BACK_BUTTON.rect.x + 8,
+                 BACK_BUTTON.rect.y + 8,
                  palette.white);
 }
 
-// Simpler text wrapping function that doesn't require stringstream
-std::vector<std::string> wrapText(const std::string& text, int maxWidth) {
-    std::vector<std::string> lines;
-    std::string currentLine;
-    std::string currentWord;
+// Simpler text wrapping function that doesn't require stringstream.
+// Lines live in the frame arena and are only valid until the next frame.
+FrameVector<FrameString> wrapText(const char* text, int maxWidth) {
+    FrameVector<FrameString> lines;
+    FrameString currentLine;
+    FrameString currentWord;
+    FrameString candidate;
+    
+    // Width of the current line with the current word appended
+    auto candidateWidth = [&]() {
+        candidate = currentLine;
+        if (!currentLine.empty()) candidate += ' ';
+        candidate += currentWord;
+        return getTextDimensions(candidate.c_str()).w;
+    };
     
-    for (char c : text) {
+    for (const char* p = text; *p; p++) {
+        char c = *p;
         if (c == ' ') {
-            SDL_Rect testSize = getTextDimensions(currentLine + (currentLine.empty() ? "" : " ") + currentWord);
-            if (testSize.w > maxWidth && !currentLine.empty()) {
+            if (candidateWidth() > maxWidth && !currentLine.empty()) {
                 lines.push_back(currentLine);
                 currentLine = currentWord;
             } else {
-                if (!currentLine.empty()) currentLine += " ";
-                currentLine += currentWord;
+                currentLine = candidate;
             }
-            currentWord = "";
+            currentWord.clear();
         } else {
             currentWord += c;
         }
@@ -588,14 +762,11 @@ std::vector<std::string> wrapText(const std::string& text, int maxWidth) {
     
     // Handle the last word
     if (!currentWord.empty()) {
-        SDL_Rect testSize = getTextDimensions(currentLine + (currentLine.empty() ? "" : " ") + currentWord);
-        if (testSize.w > maxWidth && !currentLine.empty()) {
+        if (candidateWidth() > maxWidth && !currentLine.empty()) {
             lines.push_back(currentLine);
             lines.push_back(currentWord);
         } else {
-            if (!currentLine.empty()) currentLine += " ";
-            currentLine += currentWord;
-            lines.push_back(currentLine);
+            lines.push_back(candidate);
         }
     } else if (!currentLine.empty()) {
         lines.push_back(currentLine);
@@ -604,18 +775,15 @@ std::vector<std::string> wrapText(const std::string& text, int maxWidth) {
     return lines;
 }
 
-void renderStoreScreen(SDL_Renderer* renderer, const ColorPalette& palette, 
-                      const std::vector<Plant>& plants, const Player& player,
-                      const Button& backButton, const std::string& shopkeeperText,
-                      const Button& yesButton, const Button& noButton,
-                      int selectedPlantIndex, int offerAmount) {
+void renderStoreScreen(SDL_Renderer* renderer, const ColorPalette& palette, const RenderSnapshot& snapshot,
+                      const std::vector<PlantSprite>& sprites) {
     // Clear screen with background color
     SDL_SetRenderDrawColor(renderer, palette.background.r, palette.background.g, 
                           palette.background.b, palette.background.a);
     SDL_RenderClear(renderer);
 
     // Draw store background
-    SDL_Texture* storeTexture = loadTexture(renderer, "assets/store.png");
+    SDL_Texture* storeTexture = gStoreBackground;
     if (storeTexture) {
         // Scale store background to fit screen width while maintaining aspect ratio
         int storeWidth, storeHeight;
@@ -627,15 +795,14 @@ void renderStoreScreen(SDL_Renderer* renderer, const ColorPalette& palette,
         int y = (SCREEN_HEIGHT - scaledHeight) / 2;
         
         renderTexture(renderer, storeTexture, 0, y, nullptr, scale);
-        SDL_DestroyTexture(storeTexture);
     }
 
     // Draw back button
-    drawButton(renderer, backButton, palette);
+    drawButton(renderer, BACK_BUTTON, palette);
 
     // Draw dialog box with white background
-    int dialogBoxY = SCREEN_HEIGHT - TOOLBAR_HEIGHT - 120;
-    SDL_Rect dialogBox = {10, dialogBoxY, SCREEN_WIDTH - 20, 100};
+    const SDL_Rect& dialogBox = STORE_DIALOG_RECT;
+    int dialogBoxY = dialogBox.y;
     
     // Draw white background
     SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
@@ -652,68 +819,45 @@ void renderStoreScreen(SDL_Renderer* renderer, const ColorPalette& palette,
     
     // Draw wrapped shopkeeper text in black
     SDL_Color textColor = {0, 0, 0, 255};
-    std::vector<std::string> wrappedText = wrapText(shopkeeperText, WRAP_WIDTH);
+    FrameVector<FrameString> wrappedText = wrapText(snapshot.shopkeeperText, WRAP_WIDTH);
     int lineY = dialogBoxY + TEXT_MARGIN;
     for (const auto& line : wrappedText) {
-        drawPixelText(renderer, line, dialogBox.x + TEXT_MARGIN, lineY, textColor);
+        drawPixelText(renderer, line.c_str(), dialogBox.x + TEXT_MARGIN, lineY, textColor);
         lineY += 20;  // Line spacing
     }
 
     // Draw selected plant info and visual if showing offer
-    if (selectedPlantIndex >= 0 && selectedPlantIndex < plants.size()) {
+    if (snapshot.hasOffer) {
         // Draw plant info
-        std::string plantInfo = "Plant: " + plants[selectedPlantIndex].name;
+        char plantInfo[64];
+        snprintf(plantInfo, sizeof(plantInfo), "Plant: %s", snapshot.offerPlant.name);
         drawPixelText(renderer, plantInfo, dialogBox.x + TEXT_MARGIN, lineY, textColor);
         
-        if (offerAmount > 0) {
-            std::string offerText = "Offer: " + std::to_string(offerAmount) + " coins";
+        if (snapshot.offerAmount > 0) {
+            char offerText[32];
+            snprintf(offerText, sizeof(offerText), "Offer: %d coins", snapshot.offerAmount);
             drawPixelText(renderer, offerText, dialogBox.x + TEXT_MARGIN, lineY + 20, textColor);
         }
         
         // Draw the selected plant texture
-        if (plants[selectedPlantIndex].texture) {
+        const PlantSprite* sprite = findSprite(sprites, snapshot.offerPlant.catalogId);
+        if (sprite) {
             const int PLANT_DISPLAY_SIZE = 48;  // Size for plant preview
             int plantX = SCREEN_WIDTH - PLANT_DISPLAY_SIZE - 20;  // Position on right side
             int plantY = dialogBoxY + (dialogBox.h - PLANT_DISPLAY_SIZE) / 2;  // Centered vertically in dialog
             
             // Calculate scale to fit in display size
-            double scaleW = static_cast<double>(PLANT_DISPLAY_SIZE) / plants[selectedPlantIndex].width;
-            double scaleH = static_cast<double>(PLANT_DISPLAY_SIZE) / plants[selectedPlantIndex].height;
-            double scale = std::min(scaleW, scaleH);
+            double scaleW = static_cast<double>(PLANT_DISPLAY_SIZE) / sprite->width;
+            double scaleH = static_cast<double>(PLANT_DISPLAY_SIZE) / sprite->height;
+            double scale = snapSpriteScale(std::min(scaleW, scaleH));
             
-            renderTexture(renderer, plants[selectedPlantIndex].texture, 
-                         plantX, plantY, nullptr, scale);
+            drawScaledSprite(renderer, sprite->texture, plantX, plantY,
+                             static_cast<int>(sprite->width * scale),
+                             static_cast<int>(sprite->height * scale));
         }
     }
 
-    // Position Yes/No buttons below dialog box
-    const int BUTTON_WIDTH = 40;
-    const int BUTTON_HEIGHT = 20;
-    const int BUTTON_SPACING = 20;
-    
-    // Center the buttons horizontally
-    int totalWidth = (BUTTON_WIDTH * 2) + BUTTON_SPACING;
-    int startX = (SCREEN_WIDTH - totalWidth) / 2;
-    
-    // Position buttons below the dialog box
-    int buttonY = dialogBoxY + dialogBox.h + 10;
-    
-    // Update button positions
-    const_cast<Button&>(yesButton).rect = {
-        startX,
-        buttonY,
-        BUTTON_WIDTH,
-        BUTTON_HEIGHT
-    };
-    
-    const_cast<Button&>(noButton).rect = {
-        startX + BUTTON_WIDTH + BUTTON_SPACING,
-        buttonY,
-        BUTTON_WIDTH,
-        BUTTON_HEIGHT
-    };
-
-    // Draw Yes/No buttons with just text
-    drawPixelText(renderer, "[Y]", startX + 5, buttonY + 5, palette.white);
-    drawPixelText(renderer, "[N]", startX + BUTTON_WIDTH + BUTTON_SPACING + 5, buttonY + 5, palette.white);
+    // Draw Yes/No buttons below the dialog box with just text
+    drawPixelText(renderer, "[Y]", STORE_YES_BUTTON.rect.x + 5, STORE_YES_BUTTON.rect.y + 5, palette.white);
+    drawPixelText(renderer, "[N]", STORE_NO_BUTTON.rect.x + 5, STORE_NO_BUTTON.rect.y + 5, palette.white);
 } 
\ No newline at end of file
@@ -0,0 +1,89 @@
+#include <SDL2/SDL.h>
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include "../include/render_snapshot.h"
+
+namespace {
+
+// gMiddle holds the middle slot's index, with FRESH set while it holds a
+// snapshot the renderer hasn't taken yet
+const uint8_t SLOT_MASK = 0x3;
+const uint8_t FRESH = 0x4;
+
+RenderSnapshot gSlots[3];
+std::atomic<uint8_t> gMiddle{1};
+uint8_t gBack = 0;          // Owned by the simulation thread
+uint8_t gFront = 2;         // Owned by the render thread
+bool gHasFront = false;
+
+// Each counter is written by one thread only
+long long gPublished = 0;
+long long gReplaced = 0;
+long long gAcquired = 0;
+double gLatencyMicros = 0;
+double gMaxLatencyMicros = 0;
+
+} // namespace
+
+bool initRenderSnapshots(int particleCapacity) {
+    for (RenderSnapshot& slot : gSlots) {
+        if (!slot.effects.init(particleCapacity)) {
+            std::cerr << "Unable to allocate snapshot particles" << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+RenderSnapshot& beginSnapshot() {
+    return gSlots[gBack];
+}
+
+void publishSnapshot() {
+    gSlots[gBack].publishedAt = SDL_GetPerformanceCounter();
+    // Release makes the filled slot visible to the renderer; acquire makes
+    // sure the renderer is done with the slot it handed back
+    uint8_t previous = gMiddle.exchange(gBack | FRESH, std::memory_order_acq_rel);
+    if (previous & FRESH) {
+        gReplaced++;
+    }
+    gBack = previous & SLOT_MASK;
+    gPublished++;
+}
+
+const RenderSnapshot* acquireSnapshot(bool& fresh) {
+    fresh = (gMiddle.load(std::memory_order_relaxed) & FRESH) != 0;
+    if (fresh) {
+        gFront = gMiddle.exchange(gFront, std::memory_order_acq_rel) & SLOT_MASK;
+        gHasFront = true;
+
+        double micros = (SDL_GetPerformanceCounter() - gSlots[gFront].publishedAt) * 1000000.0 /
+                        SDL_GetPerformanceFrequency();
+        gAcquired++;
+        gLatencyMicros += micros;
+        gMaxLatencyMicros = std::max(gMaxLatencyMicros, micros);
+    }
+    return gHasFront ? &gSlots[gFront] : nullptr;
+}
+
+RenderSnapshotStats getRenderSnapshotStats() {
+    RenderSnapshotStats stats;
+    stats.published = gPublished;
+    stats.acquired = gAcquired;
+    stats.replaced = gReplaced;
+    stats.latencyMicros = gLatencyMicros;
+    stats.maxLatencyMicros = gMaxLatencyMicros;
+    return stats;
+}
+
+void logRenderSnapshotStats() {
+    RenderSnapshotStats stats = getRenderSnapshotStats();
+    std::cout << "=== Frame Snapshots ===" << std::endl;
+    std::cout << "  Published: " << stats.published << ", drawn: " << stats.acquired
+              << ", replaced before drawing: " << stats.replaced << std::endl;
+    if (stats.acquired > 0) {
+        std::cout << "  Publish to draw: " << stats.latencyMicros / stats.acquired << " us avg, "
+                  << stats.maxLatencyMicros << " us max" << std::endl;
+    }
+}
@@ -0,0 +1,589 @@
+#include <SDL2/SDL.h>
+#include <algorithm>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "../include/save_game.h"
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+// Plain copy of everything the snapshot file holds, so the writer thread
+// never touches GameStateData. Every image reserves room for the whole
+// collection in openSaveGame; copying one then reuses that storage.
+struct PlantSave {
+    uint16_t catalogId;
+    uint8_t flags;        // Bit 0 = owned
+    uint8_t weather;
+    uint16_t growth;
+};
+
+struct SaveImage {
+    uint32_t sequence = 0;   // Last journal record the image includes
+    int32_t coins = 0;
+    int32_t selectedCatalogId = -1;   // Selected plant by species; -1 for none
+    std::vector<PlantSave> plants;
+};
+
+struct JournalEntry {
+    JournalOp op;
+    uint16_t catalogId;
+    int32_t value;
+    uint32_t sequence;
+};
+
+std::string gSnapshotPath;
+std::string gJournalPath;
+std::string gTempPath;
+std::string gSaveDirectory;
+uint32_t gNextSequence = 1;
+bool gOverflowReported = false;   // The collection outgrew the save; said once
+SaveStats gStats;
+
+// Main thread: the image being captured
+SaveImage gCaptured;
+
+// Hand-off to the writer, guarded by gSaveMutex. The lock is only held to
+// copy these, never during I/O.
+std::mutex gSaveMutex;
+std::condition_variable gSaveCv;
+SaveImage gPublished;
+JournalEntry gPending[SAVE_PENDING_RECORDS];
+int gPendingCount = 0;
+bool gPendingOverflow = false;   // Records were dropped; only a snapshot is complete
+bool gCompactRequested = false;
+bool gHasWork = false;
+bool gStopWriter = false;
+std::thread gWriter;
+
+// Writer thread only (and openSaveGame before it starts)
+FILE* gJournal = nullptr;
+int gJournalRecords = 0;
+SaveImage gWriterImage;
+JournalEntry gWriterBatch[SAVE_PENDING_RECORDS];
+std::vector<uint8_t> gSnapshotBuffer;   // Sized for the collection in openSaveGame
+
+uint32_t crc32(const uint8_t* data, size_t size) {
+    static uint32_t table[256];
+    static bool tableReady = false;
+    if (!tableReady) {
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t c = i;
+            for (int bit = 0; bit < 8; bit++) {
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            table[i] = c;
+        }
+        tableReady = true;
+    }
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < size; i++) {
+        crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+void put16(uint8_t* p, uint16_t v) {
+    p[0] = v & 0xFF;
+    p[1] = v >> 8;
+}
+
+void put32(uint8_t* p, uint32_t v) {
+    for (int i = 0; i < 4; i++) p[i] = (v >> (8 * i)) & 0xFF;
+}
+
+uint16_t get16(const uint8_t* p) {
+    return static_cast<uint16_t>(p[0] | p[1] << 8);
+}
+
+uint32_t get32(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | static_cast<uint32_t>(p[1]) << 8 |
+           static_cast<uint32_t>(p[2]) << 16 | static_cast<uint32_t>(p[3]) << 24;
+}
+
+double microsSince(Uint64 start) {
+    return (SDL_GetPerformanceCounter() - start) * 1000000.0 / SDL_GetPerformanceFrequency();
+}
+
+int findPlant(const GameStateData& state, int catalogId) {
+    for (size_t i = 0; i < state.plants.size(); i++) {
+        if (state.plants[i].catalogId == catalogId) return static_cast<int>(i);
+    }
+    return -1;
+}
+
+// Make sure written data reaches storage before it is relied on
+bool syncFile(FILE* file) {
+    if (fflush(file) != 0) return false;
+#ifdef _WIN32
+    return _commit(_fileno(file)) == 0;
+#else
+    return fsync(fileno(file)) == 0;
+#endif
+}
+
+
+// Room for a collection of the given size in an image and the file buffer
+void reserveImage(SaveImage& image, size_t plantCount) {
+    image.plants.reserve(plantCount);
+}
+
+// Returns false, leaving the image alone, if the collection has outgrown
+// the room reserved when the save was opened
+bool captureImage(const GameStateData& state, uint32_t sequence, SaveImage& image) {
+    size_t count = state.plants.size();
+    if (count > image.plants.capacity()) {
+        if (!gOverflowReported) {
+            std::cerr << "Save has room for " << image.plants.capacity() << " plants but the game has " << count
+                      << "; progress is not being saved" << std::endl;
+            gOverflowReported = true;
+        }
+        return false;
+    }
+    image.sequence = sequence;
+    image.coins = state.player.coins;
+    int selected = state.player.selectedPlantIndex;
+    image.selectedCatalogId = selected >= 0 && selected < static_cast<int>(count) ? state.plants[selected].catalogId : -1;
+    image.plants.resize(count);
+    for (size_t i = 0; i < count; i++) {
+        const Plant& plant = state.plants[i];
+        image.plants[i].catalogId = static_cast<uint16_t>(plant.catalogId);
+        image.plants[i].flags = plant.isOwned ? 1 : 0;
+        image.plants[i].weather = static_cast<uint8_t>(plant.preferredWeather);
+        image.plants[i].growth = static_cast<uint16_t>(plant.growth);
+    }
+    return true;
+}
+
+// Header layout:
+//   0  "PPSV"           4  version (u16)     6  header size (u16)
+//   8  sequence (u32)  12  coins (i32)      16  selected catalog id (i32, -1 none)
+//  20  plant count (u16)   22  record size (u16)
+//  24  record table CRC    28  header CRC (bytes 0-27)
+// Plant record: catalog id (u16), flags (u8, bit 0 = owned),
+// preferred weather (u8, informational: the catalog wins on load),
+// growth (u16), reserved (u16)
+size_t encodeSnapshot(const SaveImage& image) {
+    int plantCount = static_cast<int>(image.plants.size());
+    uint8_t* records = gSnapshotBuffer.data() + SAVE_HEADER_SIZE;
+    for (int i = 0; i < plantCount; i++) {
+        const PlantSave& plant = image.plants[i];
+        uint8_t* record = records + static_cast<size_t>(i) * SAVE_PLANT_RECORD_SIZE;
+        put16(record, plant.catalogId);
+        record[2] = plant.flags;
+        record[3] = plant.weather;
+        put16(record + 4, plant.growth);
+        put16(record + 6, 0);
+    }
+
+    size_t recordBytes = static_cast<size_t>(plantCount) * SAVE_PLANT_RECORD_SIZE;
+    uint8_t* header = gSnapshotBuffer.data();
+    std::memcpy(header, "PPSV", 4);
+    put16(header + 4, SAVE_VERSION);
+    put16(header + 6, SAVE_HEADER_SIZE);
+    put32(header + 8, image.sequence);
+    put32(header + 12, static_cast<uint32_t>(image.coins));
+    put32(header + 16, static_cast<uint32_t>(image.selectedCatalogId));
+    put16(header + 20, static_cast<uint16_t>(plantCount));
+    put16(header + 22, SAVE_PLANT_RECORD_SIZE);
+    put32(header + 24, crc32(records, recordBytes));
+    put32(header + 28, crc32(header, 28));
+    return SAVE_HEADER_SIZE + recordBytes;
+}
+
+// Journal record: op (u8), reserved (u8), catalog id (u16), value (i32),
+// sequence (u32), CRC of bytes 0-11
+void encodeRecord(const JournalEntry& entry, uint8_t* record) {
+    record[0] = static_cast<uint8_t>(entry.op);
+    record[1] = 0;
+    put16(record + 2, entry.catalogId);
+    put32(record + 4, static_cast<uint32_t>(entry.value));
+    put32(record + 8, entry.sequence);
+    put32(record + 12, crc32(record, 12));
+}
+
+// Make the rename itself durable
+void syncDirectory() {
+#ifndef _WIN32
+    int fd = open(gSaveDirectory.c_str(), O_RDONLY);
+    if (fd >= 0) {
+        fsync(fd);
+        close(fd);
+    }
+#endif
+}
+
+// Write the image to the temp file, sync it and rename it over the
+// snapshot, then start an empty journal. Writer thread (or before it runs).
+// On failure the old snapshot and journal are left as they were.
+bool writeSnapshot(const SaveImage& image) {
+    Uint64 start = SDL_GetPerformanceCounter();
+
+    size_t size = encodeSnapshot(image);
+    FILE* file = fopen(gTempPath.c_str(), "wb");
+    if (!file) {
+        std::cerr << "Unable to write save file " << gTempPath << std::endl;
+        return false;
+    }
+    bool written = fwrite(gSnapshotBuffer.data(), 1, size, file) == size;
+    written = syncFile(file) && written;
+    written = fclose(file) == 0 && written;
+    if (!written) {
+        std::cerr << "Failed to write save file " << gTempPath << std::endl;
+        remove(gTempPath.c_str());
+        return false;
+    }
+
+#ifdef _WIN32
+    // rename() won't replace an existing file on Windows
+    remove(gSnapshotPath.c_str());
+#endif
+    if (rename(gTempPath.c_str(), gSnapshotPath.c_str()) != 0) {
+        std::cerr << "Failed to replace save file " << gSnapshotPath << std::endl;
+        return false;
+    }
+    syncDirectory();
+
+    // The snapshot now covers every journal record, so start a new journal
+    if (gJournal) {
+        fclose(gJournal);
+    }
+    gJournal = fopen(gJournalPath.c_str(), "wb");
+    gJournalRecords = 0;
+
+    std::lock_guard<std::mutex> lock(gSaveMutex);
+    gStats.compactions++;
+    gStats.compactMicros += microsSince(start);
+    return true;
+}
+
+// Append records and sync them, so they survive a power cut
+void appendRecords(const JournalEntry* entries, int count) {
+    if (!gJournal || count == 0) return;
+    Uint64 start = SDL_GetPerformanceCounter();
+
+    uint8_t record[SAVE_JOURNAL_RECORD_SIZE];
+    for (int i = 0; i < count; i++) {
+        encodeRecord(entries[i], record);
+        if (fwrite(record, sizeof(record), 1, gJournal) != 1) {
+            std::cerr << "Failed to write save journal" << std::endl;
+            break;
+        }
+    }
+    if (!syncFile(gJournal)) {
+        std::cerr << "Failed to sync save journal" << std::endl;
+    }
+    gJournalRecords += count;
+
+    std::lock_guard<std::mutex> lock(gSaveMutex);
+    gStats.journalWrites += count;
+    gStats.journalSyncs++;
+    gStats.journalMicros += microsSince(start);
+}
+
+void writerThreadMain() {
+    for (;;) {
+        bool stop;
+        bool compact;
+        int batchCount;
+        {
+            std::unique_lock<std::mutex> lock(gSaveMutex);
+            gSaveCv.wait(lock, [] { return gHasWork || gStopWriter; });
+            // The published image already includes every pending record
+            gWriterImage = gPublished;
+            batchCount = gPendingCount;
+            std::copy(gPending, gPending + batchCount, gWriterBatch);
+            compact = gCompactRequested || gPendingOverflow;
+            stop = gStopWriter;
+            gPendingCount = 0;
+            gPendingOverflow = false;
+            gCompactRequested = false;
+            gHasWork = false;
+        }
+
+        bool compacted = false;
+        if (compact || gJournalRecords + batchCount >= SAVE_COMPACT_RECORDS) {
+            compacted = writeSnapshot(gWriterImage);
+            if (!compacted) {
+                // Keep the batch in the old journal and try the snapshot
+                // again with the next change. If records were dropped,
+                // replay stops at the gap in sequence numbers.
+                std::lock_guard<std::mutex> lock(gSaveMutex);
+                gCompactRequested = true;
+            }
+        }
+        if (!compacted) {
+            appendRecords(gWriterBatch, batchCount);
+        }
+        if (stop) break;
+    }
+}
+
+// Copy the current state (and the records that produced it) to the writer
+void publish(const GameStateData& state, const JournalEntry* entries, int count, bool compact) {
+    Uint64 start = SDL_GetPerformanceCounter();
+    if (!captureImage(state, gNextSequence - 1, gCaptured)) return;
+    {
+        std::lock_guard<std::mutex> lock(gSaveMutex);
+        gPublished = gCaptured;
+        if (gPendingCount + count <= SAVE_PENDING_RECORDS) {
+            std::copy(entries, entries + count, gPending + gPendingCount);
+            gPendingCount += count;
+        } else {
+            // The image holds these changes too; save it whole instead
+            gPendingOverflow = true;
+        }
+        gCompactRequested = gCompactRequested || compact;
+        gHasWork = true;
+    }
+    gSaveCv.notify_one();
+
+    // Main thread fields; the writer only updates its own under the lock
+    double micros = microsSince(start);
+    gStats.publishes++;
+    gStats.publishMicros += micros;
+    gStats.maxPublishMicros = std::max(gStats.maxPublishMicros, micros);
+}
+
+// Apply a snapshot; returns false (leaving state alone) if it is missing
+// or damaged. Plants the snapshot doesn't list were sold.
+bool loadSnapshot(GameStateData& state, uint32_t& sequence) {
+    FILE* file = fopen(gSnapshotPath.c_str(), "rb");
+    if (!file) return false;
+
+    // Read it whole; the buffer is resized back to the collection afterwards
+    fseek(file, 0, SEEK_END);
+    long fileSize = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    gSnapshotBuffer.resize(std::max(gSnapshotBuffer.size(), static_cast<size_t>(std::max(0L, fileSize))));
+    size_t size = fread(gSnapshotBuffer.data(), 1, gSnapshotBuffer.size(), file);
+    fclose(file);
+
+    const uint8_t* header = gSnapshotBuffer.data();
+    if (size < static_cast<size_t>(SAVE_HEADER_SIZE) || std::memcmp(header, "PPSV", 4) != 0 ||
+        get32(header + 28) != crc32(header, 28)) {
+        std::cerr << "Save file " << gSnapshotPath << " is damaged, starting fresh" << std::endl;
+        return false;
+    }
+    int version = get16(header + 4);
+    if (version != SAVE_VERSION && version != 1) {
+        std::cerr << "Unsupported save version " << version << std::endl;
+        return false;
+    }
+
+    int count = get16(header + 20);
+    int recordSize = get16(header + 22);
+    const uint8_t* records = header + get16(header + 6);
+    if (recordSize < SAVE_PLANT_RECORD_SIZE || count > MAX_SAVED_PLANTS ||
+        records + static_cast<size_t>(count) * recordSize > gSnapshotBuffer.data() + size ||
+        get32(header + 24) != crc32(records, static_cast<size_t>(count) * recordSize)) {
+        std::cerr << "Save file " << gSnapshotPath << " has a damaged plant table, starting fresh" << std::endl;
+        return false;
+    }
+
+    std::vector<bool> listed(state.plants.size(), false);
+    for (int i = 0; i < count; i++) {
+        const uint8_t* record = records + static_cast<size_t>(i) * recordSize;
+        int index = findPlant(state, get16(record));
+        if (index < 0) continue;
+        Plant& plant = state.plants[index];
+        plant.isOwned = (record[2] & 1) != 0;
+        plant.growth = std::min(static_cast<int>(get16(record + 4)), PLANT_MAX_GROWTH);
+        listed[index] = true;
+    }
+    for (int i = static_cast<int>(state.plants.size()) - 1; i >= 0; i--) {
+        if (!listed[i]) {
+            state.plants.erase(state.plants.begin() + i);
+        }
+    }
+
+    state.player.coins = static_cast<int32_t>(get32(header + 12));
+    // Plants are rebuilt in catalog order, so the selection is found by
+    // species. Version 1 stored a position in the list, which sales
+    // reorder, so it is dropped.
+    int selectedCatalogId = version == 1 ? -1 : static_cast<int32_t>(get32(header + 16));
+    state.player.selectedPlantIndex = selectedCatalogId >= 0 ? findPlant(state, selectedCatalogId) : -1;
+    sequence = get32(header + 8);
+    return true;
+}
+
+void applyRecord(GameStateData& state, JournalOp op, int catalogId, int value) {
+    int index = findPlant(state, catalogId);
+    if (index < 0) return;
+    switch (op) {
+        case JournalOp::SALE:
+            sellPlant(state, index, value);
+            break;
+        case JournalOp::PURCHASE:
+            buyPlant(state, index, value);
+            break;
+        case JournalOp::GROWTH:
+            state.plants[index].growth = std::min(value, PLANT_MAX_GROWTH);
+            break;
+    }
+}
+
+// Replay stops at the first damaged record, which is where a crash cut the
+// journal short
+bool replayJournal(GameStateData& state, uint32_t snapshotSequence) {
+    gNextSequence = snapshotSequence + 1;
+    FILE* file = fopen(gJournalPath.c_str(), "rb");
+    if (!file) return true;
+
+    bool clean = true;
+    uint32_t lastSequence = 0;
+    uint8_t record[SAVE_JOURNAL_RECORD_SIZE];
+    size_t read;
+    while ((read = fread(record, 1, sizeof(record), file)) == sizeof(record)) {
+        uint32_t sequence = get32(record + 8);
+        if (get32(record + 12) != crc32(record, 12) || sequence <= lastSequence) {
+            gStats.rejectedRecords++;
+            clean = false;
+            break;
+        }
+        // Records already folded into the snapshot are skipped
+        if (sequence > snapshotSequence) {
+            applyRecord(state, static_cast<JournalOp>(record[0]), get16(record + 2),
+                        static_cast<int32_t>(get32(record + 4)));
+            gStats.replayedRecords++;
+            gNextSequence = sequence + 1;
+        }
+        lastSequence = sequence;
+    }
+    if (read != 0) {
+        gStats.rejectedRecords++;
+        clean = false;
+    }
+    fclose(file);
+    return clean;
+}
+
+} // namespace
+
+bool openSaveGame(GameStateData& state, const std::string& path) {
+    gSnapshotPath = path;
+    gJournalPath = path + ".log";
+    gTempPath = path + ".tmp";
+    size_t slash = path.find_last_of('/');
+    gSaveDirectory = slash == std::string::npos ? "." : path.substr(0, slash + 1);
+
+    // Plants are only ever removed once loaded, so the starting collection
+    // bounds every image and snapshot
+    size_t capacity = std::min(state.plants.size(), static_cast<size_t>(MAX_SAVED_PLANTS));
+    if (capacity < state.plants.size()) {
+        std::cerr << "Save files hold at most " << MAX_SAVED_PLANTS << " plants; the game has "
+                  << state.plants.size() << " and will not be saved" << std::endl;
+    }
+    reserveImage(gCaptured, capacity);
+    reserveImage(gPublished, capacity);
+    reserveImage(gWriterImage, capacity);
+    gSnapshotBuffer.assign(SAVE_HEADER_SIZE + capacity * SAVE_PLANT_RECORD_SIZE, 0);
+
+    uint32_t sequence = 0;
+    bool found = loadSnapshot(state, sequence);
+    gSnapshotBuffer.resize(SAVE_HEADER_SIZE + capacity * SAVE_PLANT_RECORD_SIZE);
+    bool clean = replayJournal(state, sequence);
+    found = found || gStats.replayedRecords > 0;
+
+    // Start from a clean snapshot when the journal had a torn tail, so new
+    // records aren't appended after the damage
+    if ((!clean || gStats.replayedRecords > 0) && captureImage(state, gNextSequence - 1, gWriterImage)) {
+        writeSnapshot(gWriterImage);
+    }
+
+    if (!gJournal) {
+        gJournal = fopen(gJournalPath.c_str(), "ab");
+    }
+    if (!gJournal) {
+        std::cerr << "Unable to open save journal " << gJournalPath << ", progress will not be saved" << std::endl;
+        return found;
+    }
+    gJournalRecords = 0;
+
+    captureImage(state, gNextSequence - 1, gPublished);
+    gStopWriter = false;
+    gWriter = std::thread(writerThreadMain);
+    return found;
+}
+
+void journalChange(const GameStateData& state, JournalOp op, int catalogId, int value) {
+    if (!gWriter.joinable()) return;
+    JournalEntry entry = {op, static_cast<uint16_t>(catalogId), value, gNextSequence++};
+    publish(state, &entry, 1, false);
+}
+
+void journalChanges(const GameStateData& state, JournalOp op, const PlantChange* changes, int count) {
+    if (!gWriter.joinable() || count <= 0) return;
+    // Too many to queue: the snapshot the writer takes instead covers them
+    if (count > SAVE_PENDING_RECORDS) {
+        gNextSequence += count;
+        publish(state, nullptr, 0, true);
+        return;
+    }
+    JournalEntry entries[SAVE_PENDING_RECORDS];
+    for (int i = 0; i < count; i++) {
+        entries[i] = {op, static_cast<uint16_t>(changes[i].catalogId), changes[i].value, gNextSequence++};
+    }
+    publish(state, entries, count, false);
+}
+
+void compactSaveGame(const GameStateData& state) {
+    if (!gWriter.joinable()) return;
+    publish(state, nullptr, 0, true);
+}
+
+void closeSaveGame(const GameStateData& state) {
+    if (!gWriter.joinable()) return;
+    publish(state, nullptr, 0, true);
+    {
+        std::lock_guard<std::mutex> lock(gSaveMutex);
+        gStopWriter = true;
+    }
+    gSaveCv.notify_one();
+    gWriter.join();
+
+    if (gJournal) {
+        fclose(gJournal);
+        gJournal = nullptr;
+    }
+}
+
+SaveStats getSaveStats() {
+    std::lock_guard<std::mutex> lock(gSaveMutex);
+    return gStats;
+}
+
+void logSaveStats() {
+    SaveStats stats = getSaveStats();
+    std::cout << "=== Save Game ===" << std::endl;
+    std::cout << "  Loaded " << stats.replayedRecords << " journal records";
+    if (stats.rejectedRecords > 0) {
+        std::cout << " (" << stats.rejectedRecords << " damaged records dropped)";
+    }
+    std::cout << std::endl;
+    std::cout << "  Published " << stats.publishes << " changes";
+    if (stats.publishes > 0) {
+        std::cout << ", " << stats.publishMicros / stats.publishes << " us each on the main thread (max "
+                  << stats.maxPublishMicros << " us)";
+    }
+    std::cout << std::endl;
+    std::cout << "  Journal records: " << stats.journalWrites << " in " << stats.journalSyncs << " syncs";
+    if (stats.journalSyncs > 0) {
+        std::cout << ", " << stats.journalMicros / stats.journalSyncs / 1000.0 << " ms each";
+    }
+    std::cout << std::endl;
+    std::cout << "  Compactions: " << stats.compactions;
+    if (stats.compactions > 0) {
+        std::cout << ", " << stats.compactMicros / stats.compactions / 1000.0 << " ms each";
+    }
+    std::cout << std::endl;
+}
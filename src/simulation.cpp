@@ -0,0 +1,323 @@
+#include <SDL2/SDL.h>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+#include <thread>
+#include "../include/simulation.h"
+#include "../include/arena.h"
+#include "../include/input_queue.h"
+#include "../include/input_router.h"
+#include "../include/inventory_index.h"
+#include "../include/layout.h"
+#include "../include/plant_catalog.h"
+#include "../include/save_game.h"
+
+namespace {
+
+std::thread gThread;
+std::atomic<bool> gStopping{false};
+
+long long gSteps = 0;
+double gStepMicros = 0;
+double gMaxStepMicros = 0;
+
+PlantSnapshot snapshotOf(const Plant& plant) {
+    PlantSnapshot snapshot;
+    snapshot.catalogId = plant.catalogId;
+    const PlantSpecies* species = findSpecies(plant.catalogId);
+    snapshot.name = species ? speciesName(*species) : "?";
+    snapshot.growth = plant.growth;
+    return snapshot;
+}
+
+bool validPlant(const Simulation& sim, int plantIndex) {
+    return plantIndex >= 0 && plantIndex < static_cast<int>(sim.state.plants.size());
+}
+
+// Swipes and long presses on the plant view. Only presses that missed
+// every button arm them, so buttons keep working as before.
+void applyGesture(Simulation& sim, const Gesture& gesture) {
+    GameStateData& state = sim.state;
+    if (!sim.swipeArmed || state.currentState != GameState::PLANT_VIEW) return;
+    int& selected = state.player.selectedPlantIndex;
+
+    switch (gesture.type) {
+        case GestureType::DRAG_START:
+            // Mostly vertical; not a swipe
+            if (std::abs(gesture.y - gesture.startY) > std::abs(gesture.x - gesture.startX)) {
+                sim.swipeArmed = false;
+                break;
+            }
+            // The card follows the finger from here
+            [[fallthrough]];
+        case GestureType::DRAG:
+            sim.swipeOffset = std::max(-SCREEN_WIDTH, std::min(SCREEN_WIDTH, gesture.x - gesture.startX));
+            break;
+
+        case GestureType::DRAG_END:
+        case GestureType::FLING: {
+            int direction = 0;
+            if (gesture.type == GestureType::FLING && std::abs(gesture.velocityX) > std::abs(gesture.velocityY)) {
+                direction = gesture.velocityX > 0 ? 1 : -1;
+            } else if (std::abs(sim.swipeOffset) > SWIPE_COMMIT_DISTANCE) {
+                direction = sim.swipeOffset > 0 ? 1 : -1;
+            }
+            // Dragging right brings in the previous plant. The card offset
+            // moves with the selection so nothing jumps; it then settles.
+            if (direction != 0) {
+                selected = neighbourPlant(state, selected, -direction);
+                sim.swipeOffset -= direction * SCREEN_WIDTH;
+            }
+            sim.swipeArmed = false;
+            break;
+        }
+
+        case GestureType::LONG_PRESS: {
+            // Hold on the plant to find it in the greenhouse
+            int position = inventoryPositionOf(selected);
+            sim.currentPage = position >= 0 ? position / PLANTS_PER_PAGE : 0;
+            state.currentState = GameState::INVENTORY_VIEW;
+            sim.swipeArmed = false;
+            sim.swipeOffset = 0;
+            break;
+        }
+
+        default:
+            break;
+    }
+}
+
+// Everything the event watch queued since the last step. A press is a tap
+// straight away; the gesture recognizer sees every event as well.
+void applyInput(Simulation& sim) {
+    InputContext context = {sim.state, sim.currentPage, sim.effects};
+    InputEvent event;
+    while (popInputEvent(event)) {
+        if (event.type == InputEventType::PRESS) {
+            bool onPlantView = sim.state.currentState == GameState::PLANT_VIEW;
+            HitTarget target = dispatchTap(context, event.x, event.y);
+            sim.swipeArmed = onPlantView && sim.state.currentState == GameState::PLANT_VIEW &&
+                             target.action == UiAction::NONE && validPlant(sim, sim.state.player.selectedPlantIndex);
+        }
+        applyGesture(sim, sim.gestures.onEvent(event));
+        inputEventHandled(event);
+        sim.lastInputId = event.id;
+    }
+    applyGesture(sim, sim.gestures.poll(SDL_GetTicks()));
+}
+
+// Ease the plant card back to rest once the finger is off it
+void settleSwipe(Simulation& sim, float dtMs) {
+    if (sim.state.currentState != GameState::PLANT_VIEW) {
+        sim.swipeArmed = false;
+        sim.swipeOffset = 0;
+        return;
+    }
+    if (sim.swipeArmed && sim.gestures.dragging()) return;
+    sim.swipeOffset *= std::exp(-dtMs / SWIPE_SETTLE_MS);
+    if (std::abs(sim.swipeOffset) < 0.5f) {
+        sim.swipeOffset = 0;
+    }
+}
+
+// Grow owned plants, faster in the weather they like. A tick is spread
+// over steps in slices so a big greenhouse doesn't hitch, and each slice
+// is merged into the inventory index and saved in one batch.
+void growPlants(Simulation& sim, Uint32 currentTime) {
+    std::vector<Plant>& plants = sim.state.plants;
+    if (currentTime - sim.lastGrowthTick >= GROWTH_TICK_INTERVAL) {
+        sim.lastGrowthTick = currentTime;
+        sim.growthCursor = 0;
+    }
+    if (sim.growthCursor >= plants.size()) return;
+
+    size_t sliceEnd = std::min(plants.size(), sim.growthCursor + GROWTH_TICK_SLICE);
+    FrameVector<int> grown;
+    FrameVector<PlantChange> changes;
+    grown.reserve(sliceEnd - sim.growthCursor);
+    changes.reserve(sliceEnd - sim.growthCursor);
+    for (; sim.growthCursor < sliceEnd; sim.growthCursor++) {
+        Plant& plant = plants[sim.growthCursor];
+        const PlantSpecies* species = findSpecies(plant.catalogId);
+        if (!species || !plant.isOwned || plant.growth >= PLANT_MAX_GROWTH) continue;
+        int step = species->growthPerTick * (plant.preferredWeather == sim.weather ? 2 : 1);
+        plant.growth = std::min(PLANT_MAX_GROWTH, plant.growth + step);
+        changes.push_back({plant.catalogId, plant.growth});
+        grown.push_back(static_cast<int>(sim.growthCursor));
+    }
+    inventoryPlantsChanged(plants, grown.data(), static_cast<int>(grown.size()));
+    // One save hand-off for the whole slice
+    journalChanges(sim.state, JournalOp::GROWTH, changes.data(), static_cast<int>(changes.size()));
+}
+
+void simulationMain(Simulation* sim) {
+    while (!gStopping.load(std::memory_order_acquire)) {
+        Uint32 start = SDL_GetTicks();
+        frameArena().reset();
+        stepSimulation(*sim);
+        fillSnapshot(*sim, beginSnapshot());
+        publishSnapshot();
+
+        // Same pace as the single-threaded loop's frame cap, but input
+        // starts the next step early
+        Uint32 elapsed = SDL_GetTicks() - start;
+        if (elapsed < static_cast<Uint32>(SIMULATION_STEP_MS)) {
+            waitForInput(SIMULATION_STEP_MS - elapsed);
+        }
+    }
+}
+
+} // namespace
+
+bool initSimulation(Simulation& sim) {
+    if (!sim.effects.init(EFFECT_PARTICLE_CAPACITY)) {
+        return false;
+    }
+    // Reserve room for the longest shopkeeper line
+    sim.state.storeState.shopkeeperText.reserve(SHOPKEEPER_TEXT_CAPACITY);
+
+    Uint32 now = SDL_GetTicks();
+    sim.lastWeatherChange = now;
+    sim.lastGrowthTick = now;
+    sim.lastStepTime = now;
+    sim.growthCursor = sim.state.plants.size();
+    sim.lastCoins = sim.state.player.coins;
+    return true;
+}
+
+void stepSimulation(Simulation& sim) {
+    Uint64 start = SDL_GetPerformanceCounter();
+    GameStateData& state = sim.state;
+    applyInput(sim);
+
+    // Get current time for animations and timers
+    Uint32 currentTime = SDL_GetTicks();
+
+    // Check if it's time to change weather
+    if (currentTime - sim.lastWeatherChange >= WEATHER_CHANGE_INTERVAL) {
+        sim.weather = static_cast<WeatherType>(rand() % 4);
+        sim.lastWeatherChange = currentTime;
+    }
+
+    growPlants(sim, currentTime);
+    updateStore(state, currentTime);
+
+    // Day/night from the system clock (6 AM to 6 PM is day); the grade
+    // follows dusk and dawn in steps
+    time_t now = time(0);
+    struct tm* ltm = localtime(&now);
+    sim.dayNight = (ltm->tm_hour >= 6 && ltm->tm_hour < 18) ? DayNightType::DAY : DayNightType::NIGHT;
+    sim.grade = makeGradeKey(sim.weather, nightAmount(ltm->tm_hour, ltm->tm_min));
+
+    // The plant view needs a plant; fall back to the inventory
+    if (state.currentState == GameState::PLANT_VIEW && !validPlant(sim, state.player.selectedPlantIndex)) {
+        state.currentState = GameState::INVENTORY_VIEW;
+    }
+
+    // Advance overlays and particles by the real step time
+    float dt = std::min(0.1f, (currentTime - sim.lastStepTime) / 1000.0f);
+    sim.lastStepTime = currentTime;
+    WeatherOverlay::update(sim.overlay, dt, sim.weather);
+    settleSwipe(sim, dt * 1000.0f);
+
+    // Celebrate a sale
+    if (state.player.coins > sim.lastCoins) {
+        sim.effects.burstConfetti(SCREEN_WIDTH / 2.0f, SCREEN_HEIGHT / 3.0f, CONFETTI_BURST_COUNT);
+    }
+    sim.lastCoins = state.player.coins;
+    sim.effects.update(dt);
+    sim.step++;
+
+    double micros = (SDL_GetPerformanceCounter() - start) * 1000000.0 / SDL_GetPerformanceFrequency();
+    gSteps++;
+    gStepMicros += micros;
+    gMaxStepMicros = std::max(gMaxStepMicros, micros);
+}
+
+void fillSnapshot(const Simulation& sim, RenderSnapshot& snapshot) {
+    const GameStateData& state = sim.state;
+    snapshot.step = sim.step;
+    snapshot.inputId = sim.lastInputId;
+    snapshot.currentState = state.currentState;
+    snapshot.weather = sim.weather;
+    snapshot.dayNight = sim.dayNight;
+    snapshot.grade = sim.grade;
+    snapshot.coins = state.player.coins;
+
+    snapshot.hasFocus = validPlant(sim, state.player.selectedPlantIndex);
+    if (snapshot.hasFocus) {
+        snapshot.focus = snapshotOf(state.plants[state.player.selectedPlantIndex]);
+    }
+
+    // From the press that may start a swipe until the card is at rest, the
+    // renderer gets both neighbours so their sprites and cards are ready
+    // before the first move
+    snapshot.swipeOffset = static_cast<int>(sim.swipeOffset);
+    snapshot.hasNeighbours = snapshot.hasFocus && state.currentState == GameState::PLANT_VIEW &&
+                             (sim.swipeArmed || sim.swipeOffset != 0);
+    if (snapshot.hasNeighbours) {
+        int selected = state.player.selectedPlantIndex;
+        snapshot.neighbours[0] = snapshotOf(state.plants[neighbourPlant(state, selected, -1)]);
+        snapshot.neighbours[1] = snapshotOf(state.plants[neighbourPlant(state, selected, 1)]);
+    }
+
+    snapshot.view = getInventoryView();
+    snapshot.currentPage = sim.currentPage;
+    snapshot.pagePlantCount = 0;
+    if (state.currentState == GameState::INVENTORY_VIEW) {
+        for (int i = 0; i < PLANTS_PER_PAGE; i++) {
+            int plantIndex = inventoryPlantAt(sim.currentPage * PLANTS_PER_PAGE + i);
+            if (!validPlant(sim, plantIndex)) break;
+            snapshot.page[snapshot.pagePlantCount++] = snapshotOf(state.plants[plantIndex]);
+        }
+    }
+
+    const StoreState& store = state.storeState;
+    size_t textLength = std::min(store.shopkeeperText.size(), sizeof(snapshot.shopkeeperText) - 1);
+    std::memcpy(snapshot.shopkeeperText, store.shopkeeperText.c_str(), textLength);
+    snapshot.shopkeeperText[textLength] = '\0';
+    // The offer is only drawn while it stands, not under the answer to it
+    snapshot.hasOffer = store.isShowingOffer && validPlant(sim, store.selectedPlantIndex);
+    if (snapshot.hasOffer) {
+        snapshot.offerPlant = snapshotOf(state.plants[store.selectedPlantIndex]);
+    }
+    snapshot.offerAmount = store.offerAmount;
+
+    snapshot.overlay = sim.overlay;
+    snapshot.effects.copyFrom(sim.effects);
+}
+
+bool startSimulationThread(Simulation& sim) {
+    if (gThread.joinable()) return true;
+    gStopping.store(false, std::memory_order_release);
+    gThread = std::thread(simulationMain, &sim);
+    return true;
+}
+
+void stopSimulationThread() {
+    if (!gThread.joinable()) return;
+    gStopping.store(true, std::memory_order_release);
+    gThread.join();
+}
+
+SimulationStats getSimulationStats() {
+    SimulationStats stats;
+    stats.steps = gSteps;
+    stats.stepMicros = gStepMicros;
+    stats.maxStepMicros = gMaxStepMicros;
+    return stats;
+}
+
+void logSimulationStats() {
+    SimulationStats stats = getSimulationStats();
+    std::cout << "=== Simulation ===" << std::endl;
+    std::cout << "  Steps: " << stats.steps;
+    if (stats.steps > 0) {
+        std::cout << ", " << stats.stepMicros / stats.steps << " us avg, " << stats.maxStepMicros << " us max";
+    }
+    std::cout << std::endl;
+}
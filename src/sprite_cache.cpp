@@ -0,0 +1,167 @@
+#include <iostream>
+#include "../include/sprite_cache.h"
+#include "../include/memory_tracker.h"
+
+namespace {
+
+struct ScaledSprite {
+    SDL_Texture* source = nullptr;
+    SDL_Texture* texture = nullptr;   // nullptr marks a free slot
+    int width = 0;
+    int height = 0;
+    uint32_t lastUsed = 0;
+};
+
+ScaledSprite gSprites[SPRITE_CACHE_CAPACITY];
+uint32_t gUseCounter = 0;
+SpriteCacheStats gStats;
+
+void releaseEntry(ScaledSprite& entry) {
+    SDL_Texture* texture = entry.texture;
+    entry = ScaledSprite();
+    destroyTrackedTexture(texture);
+}
+
+// Least recently used entry, skipping keep; nullptr if none
+ScaledSprite* leastRecentlyUsed(SDL_Texture* keep) {
+    ScaledSprite* oldest = nullptr;
+    for (ScaledSprite& entry : gSprites) {
+        if (entry.texture && entry.texture != keep && (!oldest || entry.lastUsed < oldest->lastUsed)) {
+            oldest = &entry;
+        }
+    }
+    return oldest;
+}
+
+size_t evictScaledSprites(size_t bytesToFree, SDL_Texture* keep) {
+    size_t freed = 0;
+    while (freed < bytesToFree) {
+        ScaledSprite* oldest = leastRecentlyUsed(keep);
+        if (!oldest) break;
+        freed += textureBytes(oldest->texture);
+        releaseEntry(*oldest);
+        gStats.evictions++;
+    }
+    return freed;
+}
+
+// Drop copies of a source that is being destroyed
+void releaseSource(SDL_Texture* source) {
+    for (ScaledSprite& entry : gSprites) {
+        if (entry.texture && entry.source == source) {
+            releaseEntry(entry);
+        }
+    }
+}
+
+// Render source into a new target texture of the exact size
+SDL_Texture* createScaledCopy(SDL_Renderer* renderer, SDL_Texture* source, int width, int height) {
+    SDL_Texture* texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET, width, height);
+    if (!texture) {
+        std::cerr << "Unable to create scaled sprite! SDL Error: " << SDL_GetError() << std::endl;
+        return nullptr;
+    }
+
+    SDL_Texture* previousTarget = SDL_GetRenderTarget(renderer);
+    if (SDL_SetRenderTarget(renderer, texture) != 0) {
+        std::cerr << "Unable to render scaled sprite! SDL Error: " << SDL_GetError() << std::endl;
+        SDL_DestroyTexture(texture);
+        return nullptr;
+    }
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+    SDL_RenderClear(renderer);
+
+    // Copy the source pixels, alpha included, picking the nearest texel
+    SDL_SetTextureScaleMode(source, SDL_ScaleModeNearest);
+    SDL_SetTextureBlendMode(source, SDL_BLENDMODE_NONE);
+    SDL_RenderCopy(renderer, source, nullptr, nullptr);
+    SDL_SetTextureBlendMode(source, SDL_BLENDMODE_BLEND);
+
+    SDL_SetRenderTarget(renderer, previousTarget);
+    SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+    return texture;
+}
+
+} // namespace
+
+void initSpriteCache() {
+    setEvictionHandler(MemoryCategory::SCALED_SPRITE, evictScaledSprites);
+    addTextureReleaseHandler(releaseSource);
+    if (getMemoryStats(MemoryCategory::SCALED_SPRITE).budget == 0) {
+        setMemoryBudget(MemoryCategory::SCALED_SPRITE, SPRITE_CACHE_DEFAULT_BUDGET, BudgetAction::EVICT);
+    }
+}
+
+void clearSpriteCache() {
+    for (ScaledSprite& entry : gSprites) {
+        if (entry.texture) {
+            releaseEntry(entry);
+        }
+    }
+}
+
+SDL_Texture* scaledSprite(SDL_Renderer* renderer, SDL_Texture* source, int width, int height) {
+    if (!renderer || !source || width <= 0 || height <= 0) return nullptr;
+
+    ScaledSprite* freeSlot = nullptr;
+    for (ScaledSprite& entry : gSprites) {
+        if (!entry.texture) {
+            if (!freeSlot) freeSlot = &entry;
+        } else if (entry.source == source && entry.width == width && entry.height == height) {
+            entry.lastUsed = ++gUseCounter;
+            gStats.hits++;
+            return entry.texture;
+        }
+    }
+    gStats.misses++;
+
+    // Full: reuse the least recently used slot
+    if (!freeSlot) {
+        freeSlot = leastRecentlyUsed(nullptr);
+        releaseEntry(*freeSlot);
+        gStats.evictions++;
+    }
+
+    SDL_Texture* texture = createScaledCopy(renderer, source, width, height);
+    if (!texture) return nullptr;
+
+    // Tracking may evict older copies to stay within the budget
+    texture = trackTexture(texture, MemoryCategory::SCALED_SPRITE);
+    freeSlot->source = source;
+    freeSlot->texture = texture;
+    freeSlot->width = width;
+    freeSlot->height = height;
+    freeSlot->lastUsed = ++gUseCounter;
+    return texture;
+}
+
+void drawScaledSprite(SDL_Renderer* renderer, SDL_Texture* source, int x, int y, int width, int height) {
+    SDL_Rect dst = {x, y, width, height};
+    SDL_Texture* texture = scaledSprite(renderer, source, width, height);
+    if (texture) {
+        SDL_RenderCopy(renderer, texture, nullptr, &dst);
+        return;
+    }
+
+    SDL_SetTextureScaleMode(source, SDL_ScaleModeNearest);
+    SDL_SetTextureBlendMode(source, SDL_BLENDMODE_BLEND);
+    SDL_RenderCopy(renderer, source, nullptr, &dst);
+}
+
+SpriteCacheStats getSpriteCacheStats() {
+    return gStats;
+}
+
+void logSpriteCacheStats() {
+    int lookups = gStats.hits + gStats.misses;
+    const MemoryCategoryStats& memory = getMemoryStats(MemoryCategory::SCALED_SPRITE);
+    std::cout << "=== Sprite Scale Cache ===" << std::endl;
+    std::cout << "  Copies: " << memory.textures << ", " << memory.bytes / 1024 << " KB of "
+              << memory.budget / 1024 << " KB" << std::endl;
+    std::cout << "  Hits: " << gStats.hits << ", misses: " << gStats.misses
+              << ", evictions: " << gStats.evictions;
+    if (lookups > 0) {
+        std::cout << " (" << (gStats.hits * 100 / lookups) << "% hit rate)";
+    }
+    std::cout << std::endl;
+}
@@ -0,0 +1,202 @@
+#include <SDL2/SDL.h>
+#include <algorithm>
+#include <iostream>
+#include "../include/transition.h"
+#include "../include/memory_tracker.h"
+
+namespace {
+
+enum class Phase {
+    IDLE,
+    WAITING,        // Outgoing screen captured, incoming not drawn yet
+    RUNNING
+};
+
+SDL_Texture* gOutgoing = nullptr;
+SDL_Texture* gIncoming = nullptr;
+Phase gPhase = Phase::IDLE;
+TransitionStyle gStyle = TransitionStyle::CUT;
+Uint64 gCapturedAt = 0;     // Performance counter when the outgoing screen was captured
+Uint32 gStartTime = 0;      // SDL ticks when the animation started
+bool gIncomingShown = false;   // The last frame drawn shows some of the incoming screen
+TransitionStats gStats;
+
+// Screens by how far they are from the plant view; moving further away
+// slides left, coming back slides right
+int screenDepth(GameState state) {
+    switch (state) {
+        case GameState::INTRO:
+            return 0;
+        case GameState::PLANT_VIEW:
+            return 1;
+        case GameState::MAP_VIEW:
+            return 2;
+        default:
+            return 3;
+    }
+}
+
+// Copy src over the whole of dst, ignoring src's alpha
+bool copyTexture(SDL_Renderer* renderer, SDL_Texture* src, SDL_Texture* dst) {
+    SDL_Texture* previousTarget = SDL_GetRenderTarget(renderer);
+    if (SDL_SetRenderTarget(renderer, dst) != 0) {
+        std::cerr << "Unable to capture screen for transition! SDL Error: " << SDL_GetError() << std::endl;
+        return false;
+    }
+    SDL_BlendMode blendMode = SDL_BLENDMODE_NONE;
+    SDL_GetTextureBlendMode(src, &blendMode);
+    SDL_SetTextureBlendMode(src, SDL_BLENDMODE_NONE);
+    SDL_RenderCopy(renderer, src, nullptr, nullptr);
+    SDL_SetTextureBlendMode(src, blendMode);
+    SDL_SetRenderTarget(renderer, previousTarget);
+    return true;
+}
+
+// Smoothstep, so slides start and stop gently
+float ease(float t) {
+    return t * t * (3.0f - 2.0f * t);
+}
+
+} // namespace
+
+bool initTransitions(SDL_Renderer* renderer) {
+    gOutgoing = trackTexture(SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET,
+                                               SCREEN_WIDTH, SCREEN_HEIGHT), MemoryCategory::UI);
+    gIncoming = trackTexture(SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET,
+                                               SCREEN_WIDTH, SCREEN_HEIGHT), MemoryCategory::UI);
+    if (!gOutgoing || !gIncoming) {
+        std::cerr << "Unable to create transition targets! SDL Error: " << SDL_GetError() << std::endl;
+        cleanupTransitions();
+        return false;
+    }
+    return true;
+}
+
+void cleanupTransitions() {
+    if (gOutgoing) {
+        destroyTrackedTexture(gOutgoing);
+        gOutgoing = nullptr;
+    }
+    if (gIncoming) {
+        destroyTrackedTexture(gIncoming);
+        gIncoming = nullptr;
+    }
+    gPhase = Phase::IDLE;
+}
+
+TransitionStyle transitionStyle(GameState from, GameState to) {
+    if (from == to) return TransitionStyle::CUT;
+    if (from == GameState::INTRO) return TransitionStyle::FADE;
+    int fromDepth = screenDepth(from);
+    int toDepth = screenDepth(to);
+    if (toDepth > fromDepth) return TransitionStyle::SLIDE_LEFT;
+    if (toDepth < fromDepth) return TransitionStyle::SLIDE_RIGHT;
+    return TransitionStyle::FADE;
+}
+
+bool beginTransition(SDL_Renderer* renderer, SDL_Texture* canvas, TransitionStyle style) {
+    if (style == TransitionStyle::CUT || !canvas || !gOutgoing || !gIncoming) {
+        gPhase = Phase::IDLE;
+        return false;
+    }
+    // A change mid-animation starts over from what is on screen now
+    if (!copyTexture(renderer, canvas, gOutgoing)) {
+        gPhase = Phase::IDLE;
+        return false;
+    }
+    gStyle = style;
+    gPhase = Phase::WAITING;
+    gIncomingShown = false;
+    gCapturedAt = SDL_GetPerformanceCounter();
+    return true;
+}
+
+bool transitionWaitingForIncoming() {
+    return gPhase == Phase::WAITING;
+}
+
+void captureIncoming(SDL_Renderer* renderer, SDL_Texture* canvas) {
+    if (gPhase != Phase::WAITING) return;
+    if (!copyTexture(renderer, canvas, gIncoming)) {
+        gPhase = Phase::IDLE;
+        return;
+    }
+
+    double micros = (SDL_GetPerformanceCounter() - gCapturedAt) * 1000000.0 / SDL_GetPerformanceFrequency();
+    gStats.transitions++;
+    gStats.prepareMicros += micros;
+    gStats.maxPrepareMicros = std::max(gStats.maxPrepareMicros, micros);
+
+    // The clock starts now, so time spent loading doesn't skip frames
+    gPhase = Phase::RUNNING;
+    gStartTime = SDL_GetTicks();
+    drawTransition(renderer);
+}
+
+bool transitionRunning() {
+    return gPhase == Phase::RUNNING;
+}
+
+bool transitionShowsIncoming() {
+    return gPhase == Phase::IDLE || (gPhase == Phase::RUNNING && gIncomingShown);
+}
+
+void drawTransition(SDL_Renderer* renderer) {
+    if (gPhase != Phase::RUNNING) return;
+    Uint64 start = SDL_GetPerformanceCounter();
+
+    float t = std::min(1.0f, static_cast<float>(SDL_GetTicks() - gStartTime) / TRANSITION_MS);
+    float progress = ease(t);
+    SDL_SetTextureBlendMode(gOutgoing, SDL_BLENDMODE_NONE);
+
+    if (gStyle == TransitionStyle::FADE) {
+        SDL_RenderCopy(renderer, gOutgoing, nullptr, nullptr);
+        Uint8 alpha = static_cast<Uint8>(progress * 255.0f);
+        gIncomingShown = alpha > 0;
+        SDL_SetTextureBlendMode(gIncoming, SDL_BLENDMODE_BLEND);
+        SDL_SetTextureAlphaMod(gIncoming, alpha);
+        SDL_RenderCopy(renderer, gIncoming, nullptr, nullptr);
+        SDL_SetTextureAlphaMod(gIncoming, 255);
+    } else {
+        // Both screens move together, one screen width apart
+        int direction = gStyle == TransitionStyle::SLIDE_LEFT ? -1 : 1;
+        int offset = static_cast<int>(progress * SCREEN_WIDTH + 0.5f) * direction;
+        gIncomingShown = offset != 0;
+        SDL_Rect outgoingRect = {offset, 0, SCREEN_WIDTH, SCREEN_HEIGHT};
+        SDL_Rect incomingRect = {offset - direction * SCREEN_WIDTH, 0, SCREEN_WIDTH, SCREEN_HEIGHT};
+        SDL_SetTextureBlendMode(gIncoming, SDL_BLENDMODE_NONE);
+        SDL_RenderCopy(renderer, gOutgoing, nullptr, &outgoingRect);
+        SDL_RenderCopy(renderer, gIncoming, nullptr, &incomingRect);
+    }
+
+    if (t >= 1.0f) {
+        gPhase = Phase::IDLE;
+    }
+
+    double micros = (SDL_GetPerformanceCounter() - start) * 1000000.0 / SDL_GetPerformanceFrequency();
+    gStats.frames++;
+    gStats.frameMicros += micros;
+    gStats.maxFrameMicros = std::max(gStats.maxFrameMicros, micros);
+}
+
+void cancelTransition() {
+    gPhase = Phase::IDLE;
+}
+
+TransitionStats getTransitionStats() {
+    return gStats;
+}
+
+void logTransitionStats() {
+    std::cout << "=== Screen Transitions ===" << std::endl;
+    std::cout << "  Transitions: " << gStats.transitions;
+    if (gStats.transitions > 0) {
+        std::cout << ", incoming screen ready in " << gStats.prepareMicros / gStats.transitions / 1000.0
+                  << " ms avg, " << gStats.maxPrepareMicros / 1000.0 << " ms max";
+    }
+    std::cout << std::endl;
+    if (gStats.frames > 0) {
+        std::cout << "  Animation frames: " << gStats.frames << ", " << gStats.frameMicros / gStats.frames
+                  << " us avg, " << gStats.maxFrameMicros << " us max" << std::endl;
+    }
+}
@@ -0,0 +1,197 @@
+#include <SDL2/SDL.h>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include "../include/weather_overlay.h"
+#include "../include/memory_tracker.h"
+
+namespace {
+
+// How each layer's tile is generated and scrolled
+struct LayerSpec {
+    OverlayKind kind;
+    int tileWidth;
+    int tileHeight;
+    int streaks;          // Streaks per tile
+    int minLength;
+    int maxLength;
+    uint32_t rgb;
+    float speedX;
+    float speedY;
+    Uint8 alpha;
+    float minIntensity;
+};
+
+// Far layers first so near ones draw on top
+const LayerSpec LAYER_SPECS[] = {
+    {OverlayKind::RAIN, 40, 40, 8,  3,  5, 0xADD8E6,   8.0f, 110.0f,  90, 0.0f},  // Far drizzle
+    {OverlayKind::RAIN, 48, 60, 5,  6,  9, 0xADD8E6,  14.0f, 180.0f, 130, 0.3f},
+    {OverlayKind::RAIN, 64, 80, 3, 10, 14, 0xC8E6F0,  20.0f, 260.0f, 170, 0.6f},  // Near, heavy drops
+    {OverlayKind::WIND, 64, 40, 4,  4,  8, 0xE4E4D0,  70.0f,   4.0f,  70, 0.0f},
+    {OverlayKind::WIND, 80, 60, 3,  8, 14, 0xE4E4D0, 150.0f,   8.0f, 130, 0.5f}
+};
+
+static_assert(sizeof(LAYER_SPECS) / sizeof(LAYER_SPECS[0]) == OVERLAY_LAYER_COUNT,
+              "OVERLAY_LAYER_COUNT must match the layer table");
+
+uint32_t nextRandom(uint32_t& state) {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+// Draw streaks that wrap around the tile edges so copies tile seamlessly.
+// Streaks follow the scroll direction and fade towards their tail.
+std::vector<uint32_t> generateTile(const LayerSpec& spec, uint32_t seed) {
+    std::vector<uint32_t> pixels(static_cast<size_t>(spec.tileWidth) * spec.tileHeight, 0);
+    bool vertical = spec.kind == OverlayKind::RAIN;
+    float slope = vertical ? spec.speedX / spec.speedY : spec.speedY / spec.speedX;
+
+    for (int s = 0; s < spec.streaks; s++) {
+        int startX = nextRandom(seed) % spec.tileWidth;
+        int startY = nextRandom(seed) % spec.tileHeight;
+        int length = spec.minLength + nextRandom(seed) % (spec.maxLength - spec.minLength + 1);
+
+        for (int k = 0; k < length; k++) {
+            int drift = static_cast<int>(std::lround(k * slope));
+            int px = vertical ? startX + drift : startX + k;
+            int py = vertical ? startY + k : startY + drift;
+            px = ((px % spec.tileWidth) + spec.tileWidth) % spec.tileWidth;
+            py = ((py % spec.tileHeight) + spec.tileHeight) % spec.tileHeight;
+
+            uint32_t alpha = 255 * (k + 1) / length;
+            pixels[static_cast<size_t>(py) * spec.tileWidth + px] = alpha << 24 | spec.rgb;
+        }
+    }
+    return pixels;
+}
+
+float approach(float value, float target, float step) {
+    return value < target ? std::min(target, value + step) : std::max(target, value - step);
+}
+
+} // namespace
+
+bool WeatherOverlay::init(SDL_Renderer* renderer) {
+    cleanup();
+
+    size_t maxQuads = 0;
+    uint32_t seed = 0x2545F491u;
+    for (const LayerSpec& spec : LAYER_SPECS) {
+        OverlayLayer layer;
+        layer.kind = spec.kind;
+        layer.tileWidth = spec.tileWidth;
+        layer.tileHeight = spec.tileHeight;
+        layer.speedX = spec.speedX;
+        layer.speedY = spec.speedY;
+        layer.alpha = spec.alpha;
+        layer.minIntensity = spec.minIntensity;
+
+        layer.tile = trackTexture(SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC,
+                                                    spec.tileWidth, spec.tileHeight), MemoryCategory::BACKGROUND);
+        if (!layer.tile) {
+            std::cerr << "Unable to create weather tile! SDL Error: " << SDL_GetError() << std::endl;
+            cleanup();
+            return false;
+        }
+        std::vector<uint32_t> pixels = generateTile(spec, nextRandom(seed));
+        SDL_UpdateTexture(layer.tile, nullptr, pixels.data(), spec.tileWidth * 4);
+        SDL_SetTextureBlendMode(layer.tile, SDL_BLENDMODE_BLEND);
+        layers.push_back(layer);
+
+        // A partly scrolled layer needs one extra row and column of tiles
+        size_t columns = SCREEN_WIDTH / spec.tileWidth + 2;
+        size_t rows = SCREEN_HEIGHT / spec.tileHeight + 2;
+        maxQuads = std::max(maxQuads, columns * rows);
+    }
+
+    vertices.resize(maxQuads * 4);
+    indices.resize(maxQuads * 6);
+    for (size_t i = 0; i < maxQuads; i++) {
+        int first = static_cast<int>(i * 4);
+        int* quad = &indices[i * 6];
+        quad[0] = first;     quad[1] = first + 1; quad[2] = first + 2;
+        quad[3] = first + 2; quad[4] = first + 1; quad[5] = first + 3;
+    }
+    return true;
+}
+
+void WeatherOverlay::cleanup() {
+    for (OverlayLayer& layer : layers) {
+        if (layer.tile) {
+            destroyTrackedTexture(layer.tile);
+        }
+    }
+    layers.clear();
+}
+
+float WeatherOverlay::targetIntensity(OverlayKind kind, WeatherType weather) {
+    switch (weather) {
+        case WeatherType::RAINY:
+            return kind == OverlayKind::RAIN ? 1.0f : 0.0f;
+        case WeatherType::WINDY:
+            return kind == OverlayKind::WIND ? 1.0f : 0.0f;
+        case WeatherType::CLOUDY:
+            // A light breeze under cloud
+            return kind == OverlayKind::WIND ? 0.3f : 0.0f;
+        default:
+            return 0.0f;
+    }
+}
+
+void WeatherOverlay::update(WeatherOverlayState& state, float dt, WeatherType weather) {
+    float step = dt / OVERLAY_FADE_SECONDS;
+    state.rainIntensity = approach(state.rainIntensity, targetIntensity(OverlayKind::RAIN, weather), step);
+    state.windIntensity = approach(state.windIntensity, targetIntensity(OverlayKind::WIND, weather), step);
+
+    for (int i = 0; i < OVERLAY_LAYER_COUNT; i++) {
+        const LayerSpec& spec = LAYER_SPECS[i];
+        state.offsetX[i] = std::fmod(state.offsetX[i] + spec.speedX * dt, static_cast<float>(spec.tileWidth));
+        state.offsetY[i] = std::fmod(state.offsetY[i] + spec.speedY * dt, static_cast<float>(spec.tileHeight));
+    }
+}
+
+void WeatherOverlay::render(SDL_Renderer* renderer, const WeatherOverlayState& state) const {
+    for (size_t i = 0; i < layers.size(); i++) {
+        const OverlayLayer& layer = layers[i];
+        float intensity = layer.kind == OverlayKind::RAIN ? state.rainIntensity : state.windIntensity;
+        // Light weather shows only the far layers
+        if (intensity > 0.01f && intensity > layer.minIntensity) {
+            drawLayer(renderer, layer, intensity, state.offsetX[i], state.offsetY[i]);
+        }
+    }
+}
+
+void WeatherOverlay::drawLayer(SDL_Renderer* renderer, const OverlayLayer& layer, float intensity,
+                               float offsetX, float offsetY) const {
+    Uint8 alpha = static_cast<Uint8>(layer.alpha * intensity);
+    float startX = offsetX - layer.tileWidth;
+    float startY = offsetY - layer.tileHeight;
+
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+    // Every visible copy of the tile in one geometry call
+    SDL_Color color = {255, 255, 255, alpha};
+    int quads = 0;
+    for (float y = startY; y < SCREEN_HEIGHT; y += layer.tileHeight) {
+        for (float x = startX; x < SCREEN_WIDTH; x += layer.tileWidth) {
+            float right = x + layer.tileWidth;
+            float bottom = y + layer.tileHeight;
+            SDL_Vertex* quad = &vertices[static_cast<size_t>(quads++) * 4];
+            quad[0] = {{x, y}, color, {0.0f, 0.0f}};
+            quad[1] = {{right, y}, color, {1.0f, 0.0f}};
+            quad[2] = {{x, bottom}, color, {0.0f, 1.0f}};
+            quad[3] = {{right, bottom}, color, {1.0f, 1.0f}};
+        }
+    }
+    SDL_RenderGeometry(renderer, layer.tile, vertices.data(), quads * 4, indices.data(), quads * 6);
+#else
+    SDL_SetTextureAlphaMod(layer.tile, alpha);
+    for (float y = startY; y < SCREEN_HEIGHT; y += layer.tileHeight) {
+        for (float x = startX; x < SCREEN_WIDTH; x += layer.tileWidth) {
+            SDL_Rect dst = {static_cast<int>(x), static_cast<int>(y), layer.tileWidth, layer.tileHeight};
+            SDL_RenderCopy(renderer, layer.tile, nullptr, &dst);
+        }
+    }
+#endif
+}
@@ -0,0 +1,450 @@
+// Host-side build tool: packs PNG images and raw files into a C++ source
+// file that is linked into the game (see include/embedded_assets.h).
+//
+// Usage: asset_packer <output.cpp> [image.png[@maxSize] ...]
+//                     [--indexed=image.png[@maxSize] ...] [--file=path ...]
+//
+// Images larger than maxSize on their longest side are downscaled with
+// nearest-neighbour sampling, reduced to at most 256 colors (median cut)
+// and stored as per-row runs of palette indices. --indexed images are
+// additionally dithered to 2bpp GameBoy shades (see indexed_sprite.h).
+
+#define SDL_MAIN_HANDLED
+#include <SDL2/SDL.h>
+#include <SDL_image.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <string>
+#include <vector>
+#include "../include/embedded_assets.h"
+#include "../include/indexed_sprite.h"
+
+namespace {
+
+const int MAX_PALETTE_SIZE = 256;
+
+struct PackedImage {
+    std::string name;
+    int width = 0;
+    int height = 0;
+    std::vector<uint32_t> palette;
+    std::vector<uint32_t> rowOffsets;
+    std::vector<uint8_t> data;
+};
+
+struct PackedIndexedImage {
+    std::string name;
+    int width = 0;
+    int height = 0;
+    bool transparent = false;
+    std::vector<uint8_t> pixels;
+};
+
+struct PackedFile {
+    std::string name;
+    std::vector<uint8_t> data;
+};
+
+uint64_t fileSize(const std::string& path) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    return file ? static_cast<uint64_t>(file.tellg()) : 0;
+}
+
+struct ColorCount {
+    uint32_t color;
+    int count;
+};
+
+int channel(uint32_t argb, int shift) {
+    return (argb >> shift) & 0xFF;
+}
+
+// Shift of the ARGB channel with the widest spread in a box
+int widestChannel(const std::vector<ColorCount>& box, int& range) {
+    int bestShift = 0;
+    range = -1;
+    for (int shift = 0; shift < 32; shift += 8) {
+        int lo = 255, hi = 0;
+        for (const ColorCount& entry : box) {
+            lo = std::min(lo, channel(entry.color, shift));
+            hi = std::max(hi, channel(entry.color, shift));
+        }
+        if (hi - lo > range) {
+            range = hi - lo;
+            bestShift = shift;
+        }
+    }
+    return bestShift;
+}
+
+// Build a palette of at most maxColors entries. Every color in the
+// histogram is mapped to the palette index of the box it ends up in.
+std::vector<uint32_t> medianCut(const std::map<uint32_t, int>& histogram, int maxColors,
+                                std::map<uint32_t, int>& indexOf) {
+    std::vector<std::vector<ColorCount>> boxes(1);
+    for (const auto& entry : histogram) {
+        boxes[0].push_back({entry.first, entry.second});
+    }
+
+    // Split the box with the widest channel at its pixel-weighted median
+    while (static_cast<int>(boxes.size()) < maxColors) {
+        int splitBox = -1, splitShift = 0, widest = 0;
+        for (size_t i = 0; i < boxes.size(); i++) {
+            if (boxes[i].size() < 2) continue;
+            int range;
+            int shift = widestChannel(boxes[i], range);
+            if (range > widest) {
+                widest = range;
+                splitBox = static_cast<int>(i);
+                splitShift = shift;
+            }
+        }
+        if (splitBox < 0) break;
+
+        std::vector<ColorCount>& box = boxes[splitBox];
+        std::sort(box.begin(), box.end(), [splitShift](const ColorCount& a, const ColorCount& b) {
+            return channel(a.color, splitShift) < channel(b.color, splitShift);
+        });
+        long total = 0;
+        for (const ColorCount& entry : box) total += entry.count;
+        long seen = 0;
+        size_t median = 1;
+        for (; median < box.size() - 1; median++) {
+            seen += box[median - 1].count;
+            if (seen * 2 >= total) break;
+        }
+        boxes.emplace_back(box.begin() + median, box.end());
+        boxes[splitBox].resize(median);
+    }
+
+    // Each palette entry is the weighted average of its box
+    std::vector<uint32_t> palette;
+    for (const auto& box : boxes) {
+        double sums[4] = {0, 0, 0, 0};
+        long total = 0;
+        for (const ColorCount& entry : box) {
+            for (int c = 0; c < 4; c++) {
+                sums[c] += static_cast<double>(channel(entry.color, c * 8)) * entry.count;
+            }
+            total += entry.count;
+        }
+        uint32_t color = 0;
+        for (int c = 0; c < 4; c++) {
+            color |= static_cast<uint32_t>(sums[c] / total + 0.5) << (c * 8);
+        }
+        for (const ColorCount& entry : box) {
+            indexOf[entry.color] = static_cast<int>(palette.size());
+        }
+        palette.push_back(color);
+    }
+    return palette;
+}
+
+// Load an image as ARGB8888, scaled down so neither side exceeds maxSize
+bool loadPixels(const std::string& path, int maxSize, std::vector<uint32_t>& pixels, int& width, int& height) {
+    SDL_Surface* loaded = IMG_Load(path.c_str());
+    if (!loaded) {
+        std::cerr << "Unable to load image " << path << "! SDL_image Error: " << IMG_GetError() << std::endl;
+        return false;
+    }
+    SDL_Surface* surface = SDL_ConvertSurfaceFormat(loaded, SDL_PIXELFORMAT_ARGB8888, 0);
+    SDL_FreeSurface(loaded);
+    if (!surface) {
+        std::cerr << "Unable to convert image " << path << "! SDL Error: " << SDL_GetError() << std::endl;
+        return false;
+    }
+
+    int srcWidth = surface->w;
+    int srcHeight = surface->h;
+    width = srcWidth;
+    height = srcHeight;
+    if (maxSize > 0 && (srcWidth > maxSize || srcHeight > maxSize)) {
+        if (srcWidth >= srcHeight) {
+            width = maxSize;
+            height = std::max(1, srcHeight * maxSize / srcWidth);
+        } else {
+            height = maxSize;
+            width = std::max(1, srcWidth * maxSize / srcHeight);
+        }
+    }
+
+    pixels.resize(static_cast<size_t>(width) * height);
+    SDL_LockSurface(surface);
+    for (int y = 0; y < height; y++) {
+        int srcY = y * srcHeight / height;
+        const uint32_t* srcRow = reinterpret_cast<const uint32_t*>(
+            static_cast<const uint8_t*>(surface->pixels) + srcY * surface->pitch);
+        for (int x = 0; x < width; x++) {
+            pixels[static_cast<size_t>(y) * width + x] = srcRow[x * srcWidth / width];
+        }
+    }
+    SDL_UnlockSurface(surface);
+    SDL_FreeSurface(surface);
+    return true;
+}
+
+bool packImage(const std::string& name, int maxSize, PackedImage& image) {
+    std::vector<uint32_t> pixels;
+    if (!loadPixels(name, maxSize, pixels, image.width, image.height)) {
+        return false;
+    }
+
+    // All fully transparent pixels share the 0x00000000 entry
+    std::map<uint32_t, int> histogram;
+    bool hasTransparent = false;
+    for (uint32_t& pixel : pixels) {
+        if ((pixel >> 24) == 0) {
+            pixel = 0;
+            hasTransparent = true;
+        } else {
+            histogram[pixel]++;
+        }
+    }
+
+    std::map<uint32_t, int> paletteIndex;
+    image.palette.clear();
+    if (hasTransparent) {
+        image.palette.push_back(0);
+        paletteIndex[0] = 0;
+    }
+    int maxColors = MAX_PALETTE_SIZE - static_cast<int>(image.palette.size());
+    if (static_cast<int>(histogram.size()) > maxColors) {
+        std::cout << "  " << name << ": " << histogram.size() << " colors reduced to " << maxColors << std::endl;
+    }
+    if (!histogram.empty()) {
+        std::map<uint32_t, int> boxIndex;
+        std::vector<uint32_t> colors = medianCut(histogram, maxColors, boxIndex);
+        int base = static_cast<int>(image.palette.size());
+        image.palette.insert(image.palette.end(), colors.begin(), colors.end());
+        for (const auto& entry : boxIndex) {
+            paletteIndex[entry.first] = base + entry.second;
+        }
+    }
+
+    // Run-length encode each row separately so rows decode independently.
+    // Runs of three or more become repeats, everything else literal spans.
+    image.name = name;
+    image.data.clear();
+    image.rowOffsets.clear();
+    std::vector<uint8_t> indices(image.width);
+    for (int y = 0; y < image.height; y++) {
+        image.rowOffsets.push_back(static_cast<uint32_t>(image.data.size()));
+        for (int x = 0; x < image.width; x++) {
+            indices[x] = static_cast<uint8_t>(paletteIndex[pixels[static_cast<size_t>(y) * image.width + x]]);
+        }
+
+        int literalStart = 0;
+        int x = 0;
+        auto flushLiterals = [&](int endX) {
+            while (literalStart < endX) {
+                int count = std::min(RLE_MAX_RUN, endX - literalStart);
+                image.data.push_back(static_cast<uint8_t>(RLE_LITERAL_FLAG + count - 1));
+                image.data.insert(image.data.end(), indices.begin() + literalStart, indices.begin() + literalStart + count);
+                literalStart += count;
+            }
+        };
+        while (x < image.width) {
+            int run = 1;
+            while (x + run < image.width && run < RLE_MAX_RUN && indices[x + run] == indices[x]) {
+                run++;
+            }
+            if (run >= 3) {
+                flushLiterals(x);
+                image.data.push_back(static_cast<uint8_t>(run - 1));
+                image.data.push_back(indices[x]);
+                literalStart = x + run;
+            }
+            x += run;
+        }
+        flushLiterals(image.width);
+    }
+    image.rowOffsets.push_back(static_cast<uint32_t>(image.data.size()));
+    return true;
+}
+
+bool packIndexedImage(const std::string& name, int maxSize, PackedIndexedImage& image) {
+    std::vector<uint32_t> pixels;
+    if (!loadPixels(name, maxSize, pixels, image.width, image.height)) {
+        return false;
+    }
+    int pitch = image.width * static_cast<int>(sizeof(uint32_t));
+    image.name = name;
+    image.transparent = hasTransparency(pixels.data(), image.width, image.height, pitch);
+    quantizeToShades(pixels.data(), image.width, image.height, pitch, image.transparent, image.pixels);
+    return true;
+}
+
+// Split "path@maxSize" into its parts
+std::string parseImageArg(const std::string& arg, int& maxSize) {
+    maxSize = 0;
+    size_t at = arg.find('@');
+    if (at == std::string::npos) {
+        return arg;
+    }
+    maxSize = std::atoi(arg.c_str() + at + 1);
+    return arg.substr(0, at);
+}
+
+bool readFile(const std::string& path, PackedFile& file) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        std::cerr << "Unable to read " << path << std::endl;
+        return false;
+    }
+    file.name = path;
+    file.data.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    return true;
+}
+
+size_t packedBytes(const PackedImage& image) {
+    return image.palette.size() * sizeof(uint32_t) + image.rowOffsets.size() * sizeof(uint32_t) + image.data.size();
+}
+
+template <typename T>
+void writeArray(std::ostream& out, const char* type, const std::string& name, const std::vector<T>& values, int perLine) {
+    out << "constexpr " << type << " " << name << "[] = {";
+    char buffer[16];
+    for (size_t i = 0; i < values.size(); i++) {
+        if (i % perLine == 0) out << "\n   ";
+        if (sizeof(T) == 1) {
+            snprintf(buffer, sizeof(buffer), " 0x%02X,", static_cast<unsigned>(values[i]));
+        } else {
+            snprintf(buffer, sizeof(buffer), " 0x%08X,", static_cast<unsigned>(values[i]));
+        }
+        out << buffer;
+    }
+    out << "\n};\n\n";
+}
+
+bool writeSource(const std::string& path, const std::vector<PackedImage>& images,
+                 const std::vector<PackedIndexedImage>& indexedImages, const std::vector<PackedFile>& files) {
+    std::ofstream out(path);
+    if (!out) {
+        std::cerr << "Unable to write " << path << std::endl;
+        return false;
+    }
+
+    out << "// Generated by tools/asset_packer. Do not edit.\n\n";
+    out << "#include \"embedded_assets.h\"\n\n";
+    out << "namespace {\n\n";
+
+    for (size_t i = 0; i < images.size(); i++) {
+        std::string prefix = "image" + std::to_string(i);
+        out << "// " << images[i].name << " (" << images[i].width << "x" << images[i].height << ")\n";
+        writeArray(out, "uint32_t", prefix + "Palette", images[i].palette, 6);
+        writeArray(out, "uint32_t", prefix + "Rows", images[i].rowOffsets, 6);
+        writeArray(out, "uint8_t", prefix + "Data", images[i].data, 16);
+    }
+    for (size_t i = 0; i < indexedImages.size(); i++) {
+        out << "// " << indexedImages[i].name << " (" << indexedImages[i].width << "x"
+            << indexedImages[i].height << ", 2bpp)\n";
+        writeArray(out, "uint8_t", "indexed" + std::to_string(i) + "Pixels", indexedImages[i].pixels, 16);
+    }
+    for (size_t i = 0; i < files.size(); i++) {
+        out << "// " << files[i].name << "\n";
+        writeArray(out, "uint8_t", "file" + std::to_string(i) + "Data", files[i].data, 16);
+    }
+
+    if (!images.empty()) {
+        out << "constexpr EmbeddedImage images[] = {\n";
+        for (size_t i = 0; i < images.size(); i++) {
+            std::string prefix = "image" + std::to_string(i);
+            out << "    {\"" << images[i].name << "\", " << images[i].width << ", " << images[i].height << ", "
+                << prefix << "Palette, " << images[i].palette.size() << ", "
+                << prefix << "Rows, " << prefix << "Data},\n";
+        }
+        out << "};\n\n";
+    }
+    if (!indexedImages.empty()) {
+        out << "constexpr EmbeddedIndexedImage indexedImages[] = {\n";
+        for (size_t i = 0; i < indexedImages.size(); i++) {
+            out << "    {\"" << indexedImages[i].name << "\", {" << indexedImages[i].width << ", "
+                << indexedImages[i].height << ", " << (indexedImages[i].transparent ? "true" : "false")
+                << ", indexed" << i << "Pixels}},\n";
+        }
+        out << "};\n\n";
+    }
+    if (!files.empty()) {
+        out << "constexpr EmbeddedFile files[] = {\n";
+        for (size_t i = 0; i < files.size(); i++) {
+            out << "    {\"" << files[i].name << "\", file" << i << "Data, " << files[i].data.size() << "},\n";
+        }
+        out << "};\n\n";
+    }
+
+    out << "} // namespace\n\n";
+    out << "const EmbeddedImage* const EMBEDDED_IMAGES = " << (images.empty() ? "nullptr" : "images") << ";\n";
+    out << "const int EMBEDDED_IMAGE_COUNT = " << images.size() << ";\n";
+    out << "const EmbeddedFile* const EMBEDDED_FILES = " << (files.empty() ? "nullptr" : "files") << ";\n";
+    out << "const int EMBEDDED_FILE_COUNT = " << files.size() << ";\n";
+    out << "const EmbeddedIndexedImage* const EMBEDDED_INDEXED_IMAGES = "
+        << (indexedImages.empty() ? "nullptr" : "indexedImages") << ";\n";
+    out << "const int EMBEDDED_INDEXED_IMAGE_COUNT = " << indexedImages.size() << ";\n";
+    return static_cast<bool>(out);
+}
+
+} // namespace
+
+int main(int argc, char* args[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: asset_packer <output.cpp> [image.png[@maxSize] ...] "
+                  << "[--indexed=image.png[@maxSize] ...] [--file=path ...]" << std::endl;
+        return 1;
+    }
+
+    std::vector<PackedImage> images;
+    std::vector<PackedIndexedImage> indexedImages;
+    std::vector<PackedFile> files;
+    uint64_t sourceTotal = 0;
+    uint64_t packedTotal = 0;
+
+    for (int i = 2; i < argc; i++) {
+        std::string arg = args[i];
+        if (arg.compare(0, 7, "--file=") == 0) {
+            PackedFile file;
+            if (!readFile(arg.substr(7), file)) return 1;
+            sourceTotal += file.data.size();
+            packedTotal += file.data.size();
+            std::cout << "  " << file.name << ": " << file.data.size() << " bytes" << std::endl;
+            files.push_back(std::move(file));
+            continue;
+        }
+
+        int maxSize = 0;
+        if (arg.compare(0, 10, "--indexed=") == 0) {
+            PackedIndexedImage image;
+            std::string name = parseImageArg(arg.substr(10), maxSize);
+            if (!packIndexedImage(name, maxSize, image)) return 1;
+            packedTotal += image.pixels.size();
+            std::cout << "  " << image.name << ": " << image.width << "x" << image.height << ", 2bpp"
+                      << (image.transparent ? " + transparency" : "") << " -> "
+                      << image.pixels.size() << " bytes" << std::endl;
+            indexedImages.push_back(std::move(image));
+            continue;
+        }
+
+        std::string name = parseImageArg(arg, maxSize);
+        PackedImage image;
+        if (!packImage(name, maxSize, image)) return 1;
+        uint64_t pngBytes = fileSize(name);
+        sourceTotal += pngBytes;
+        packedTotal += packedBytes(image);
+        std::cout << "  " << image.name << ": " << image.width << "x" << image.height << ", "
+                  << image.palette.size() << " colors, PNG " << pngBytes << " bytes -> packed "
+                  << packedBytes(image) << " bytes (raw " << image.width * image.height * 4 << ")" << std::endl;
+        images.push_back(std::move(image));
+    }
+
+    if (!writeSource(args[1], images, indexedImages, files)) return 1;
+
+    std::cout << "Packed " << images.size() << " images, " << indexedImages.size() << " indexed images and "
+              << files.size() << " files: "
+              << sourceTotal / 1024 << " KB source -> " << packedTotal / 1024 << " KB" << std::endl;
+    return 0;
+}